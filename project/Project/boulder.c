@@ -15,19 +15,23 @@
  *
  * Function Roles:
  * - freeBoulders: Cleans up boulder memory and resets the system state.
- * - boulderCollides: Checks for collisions between boulder placement and existing trees.
+ * - boulderCollides: Checks for collisions between boulder placement and a list of trees.
  * - boulderRandomScale: Generates random scale factors for boulder size variation.
  * - boulderNoise: Produces noise values for vertex displacement to create unique boulder shapes.
  * - boulderVertexNoise: Applies noise displacement to base vertices for procedural shape generation.
- * - isValidBoulderLocation: Validates boulder placement based on terrain slope and object collisions.
- * - generateRandomBoulder: Creates a single boulder instance with random properties and placement.
+ * - isValidBoulderLocation: Validates boulder placement based on the terrain placement bits and object collisions.
+ * - makeRandomBoulder: Creates a single boulder instance with random properties at a validated position.
+ * - generateBoulders: Places boulders across a landscape from a seed into a new array (safe on any thread).
  * - initBoulders: Initializes the entire boulder system with procedural placement across the landscape.
+ * - loadBoulders: Restores previously generated boulders (e.g. from the world cache).
+ * - getBoulders: Exposes the placed boulders so they can be saved.
  * - computeNormal: Calculates surface normals for proper lighting calculations.
  * - drawBoulderFace: Renders a single triangular face with texture coordinates and normals.
  * - drawBoulderMesh: Renders the complete boulder mesh using triangle faces.
  * - setupBoulderTransform: Applies transformation matrix for boulder positioning and scaling.
  * - cleanupBoulderDraw: Restores OpenGL state after boulder rendering.
  * - boulderDraw: Main rendering function that combines all boulder rendering steps.
+ * - renderBoulderInstances: Renders a list of boulders (e.g. those of a streamed terrain tile).
  * - renderBoulders: Renders all boulders in the scene with their individual properties.
  * - boulderShaderInit: Initializes the boulder shader program for advanced rendering.
  */
@@ -37,6 +41,7 @@
 #include "objects_render.h"
 #include "landscape.h"
 #include "shaders.h"
+#include "rng.h"
 
 // Maximum number of boulders to generate in the scene
 #define NUM_BOULDERS 50
@@ -47,13 +52,8 @@ static int numBoulders = 0; // Current number of boulders
 static int boulderShader = 0; // Shader program handle for boulder rendering
 
 // External references to other systems
-extern TreeInstance* treeInstances; // Tree instances for collision detection
-extern int numTrees; // Number of trees in the scene
 extern GLuint boulderTexture; // Texture handle for boulder surface
 
-// Utility function to generate random float values between 0.0 and 1.0
-static float randf() { return rand() / (float)RAND_MAX; }
-
 // freeBoulders: Cleans up boulder memory and resets the system state.
 // Contribution: This function ensures proper memory management by deallocating the boulder array and resetting system state. It prevents memory leaks and allows the system to be reinitialized cleanly.
 void freeBoulders() {
@@ -64,14 +64,14 @@ void freeBoulders() {
     }
 }
 
-// boulderCollides: Checks for collisions between boulder placement and existing trees.
+// boulderCollides: Checks for collisions between boulder placement and a list of trees.
 // Contribution: This function prevents boulders from being placed too close to trees, ensuring realistic object distribution. It calculates distance-based collision detection using squared distance for efficiency.
-static int boulderCollides(float x, float z, float minDist) {
-    for (int t = 0; t < numTrees; ++t) { // Iterate through all trees
-        float dx = x - treeInstances[t].x; // Calculate X distance to tree
-        float dz = z - treeInstances[t].z; // Calculate Z distance to tree
+static int boulderCollides(float x, float z, float minDist, const TreeInstance* trees, int treeCount) {
+    for (int t = 0; t < treeCount; ++t) { // Iterate through all trees
+        float dx = x - trees[t].x; // Calculate X distance to tree
+        float dz = z - trees[t].z; // Calculate Z distance to tree
         float dist2 = dx*dx + dz*dz; // Calculate squared distance (avoiding square root)
-        float minTreeDist = minDist + treeInstances[t].scale * 0.5f; // Calculate minimum required distance
+        float minTreeDist = minDist + trees[t].scale * 0.5f; // Calculate minimum required distance
         if (dist2 < minTreeDist * minTreeDist) { // Check if distance is too small
             return 1; // Collision detected
         }
@@ -81,17 +81,17 @@ static int boulderCollides(float x, float z, float minDist) {
 
 // boulderRandomScale: Generates random scale factors for boulder size variation.
 // Contribution: This function creates natural size variation for boulders using multiple random factors. The combination of uniform and multiplicative randomness produces realistic size distribution.
-static float boulderRandomScale() {
-    float a = randf(); // First random factor
-    float b = randf(); // Second random factor
-    float c = randf(); // Third random factor
+static float boulderRandomScale(Rng* rng) {
+    float a = rngFloat(rng); // First random factor
+    float b = rngFloat(rng); // Second random factor
+    float c = rngFloat(rng); // Third random factor
     return 1.2f + a * 2.8f + b * c * 1.2f; // Combine factors for natural variation
 }
 
 // boulderNoise: Produces noise values for vertex displacement to create unique boulder shapes.
-// Contribution: This function generates procedural noise for vertex displacement using trigonometric functions. The combination of sine and cosine with different frequencies creates natural-looking surface variation.
+// Contribution: This function generates procedural noise for vertex displacement using trigonometric functions. The combination of sine and cosine with different frequencies creates natural-looking surface variation, and the random scaling is hashed from the shape seed and vertex component, so a boulder keeps the same shape from frame to frame.
 static float boulderNoise(unsigned int shapeSeed, int i, int j) {
-    return (sinf(shapeSeed * 0.13f + i * 1.7f + j * 2.3f) + cosf(shapeSeed * 0.21f + i * 2.1f + j * 1.3f)) * 0.18f * randf(); // Generate noise using trigonometric functions and random scaling
+    return (sinf(shapeSeed * 0.13f + i * 1.7f + j * 2.3f) + cosf(shapeSeed * 0.21f + i * 2.1f + j * 1.3f)) * 0.18f * rngHashFloat(shapeSeed, (unsigned int)(i * 3 + j)); // Generate noise using trigonometric functions and random scaling
 }
 
 // boulderVertexNoise: Applies noise displacement to base vertices for procedural shape generation.
@@ -142,57 +142,93 @@ static void boulderShaderUniforms(int colorIndex) {
     glUniform3fv(lightPosLoc, 1, lightPos); // Set light position uniform
 }
 
-// isValidBoulderLocation: Validates boulder placement based on terrain slope and object collisions.
-// Contribution: This function ensures boulders are placed in suitable locations by checking terrain slope, water level, and object collisions. It converts world coordinates to terrain grid coordinates for accurate height and normal sampling.
-static int isValidBoulderLocation(Landscape* landscape, float x, float z, float y) {
-    float nx = (x / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1); // Convert X to terrain grid coordinate
-    float nz = (z / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1); // Convert Z to terrain grid coordinate
-    int ix = (int)nx; // Integer X grid index
-    int iz = (int)nz; // Integer Z grid index
-    if (ix < 0) ix = 0; // Clamp to terrain bounds
-    if (iz < 0) iz = 0; // Clamp to terrain bounds
-    if (ix >= LANDSCAPE_SIZE-1) ix = LANDSCAPE_SIZE-2; // Clamp to terrain bounds
-    if (iz >= LANDSCAPE_SIZE-1) iz = LANDSCAPE_SIZE-2; // Clamp to terrain bounds
-    int idx = iz * LANDSCAPE_SIZE + ix; // Calculate terrain array index
-    float* n = &landscape->normals[idx*3]; // Get normal vector at this location
-    float slope = acosf(fminf(fmaxf(n[1], -1.0f), 1.0f)) / (float)M_PI; // Calculate slope angle from Y normal component
-    if (slope > 0.25f) return 0; // Reject if slope is too steep (greater than ~14 degrees)
-    if (y < WATER_LEVEL + 0.5f) return 0; // Reject if below water level plus safety margin
-    if (boulderCollides(x, z, 4.0f)) return 0; // Reject if collides with trees
+// Number of candidate positions whose terrain height and placement bits are queried together.
+#define BOULDER_PLACEMENT_BATCH 64
+
+// Boulders sit on ground at least 0.5 above the water line and no steeper than 45 degrees (a quarter of pi).
+static const LandscapePlacementRule boulderRule = {0.5f, 1e30f, 0.0f, 0.25f * (float)M_PI, 0};
+
+// isValidBoulderLocation: Validates boulder placement based on the terrain placement bits and object collisions.
+// Contribution: This function ensures boulders are placed in suitable locations: the candidate's cell must pass the boulder placement rule (slope and water level, looked up in the terrain attribute map) and the boulder must not collide with other objects.
+static int isValidBoulderLocation(float x, float z, unsigned int mask, int rule, const TreeInstance* trees, int treeCount) {
+    if (!((mask >> rule) & 1)) return 0; // Reject if the terrain is too steep or too close to the water
+    if (boulderCollides(x, z, 4.0f, trees, treeCount)) return 0; // Reject if collides with trees
     return 1; // Location is valid
 }
 
-// generateRandomBoulder: Creates a single boulder instance with random properties and placement.
-// Contribution: This function generates individual boulders with random position, scale, rotation, shape seed, and color. It attempts placement until a valid location is found, ensuring realistic distribution.
-static int generateRandomBoulder(Landscape* landscape, BoulderInstance* outBoulder) {
-    float halfScale = LANDSCAPE_SCALE * 0.5f * 0.95f; // Calculate placement boundary (95% of terrain size)
-    float x = -halfScale + randf() * LANDSCAPE_SCALE * 0.95f; // Random X position within bounds
-    float z = -halfScale + randf() * LANDSCAPE_SCALE * 0.95f; // Random Z position within bounds
-    float y = landscapeGetHeight(landscape, x, z); // Get terrain height at position
-    if (!isValidBoulderLocation(landscape, x, z, y)) return 0; // Check if location is valid
-    float scale = boulderRandomScale(); // Generate random scale
-    float rotation = randf() * 360.0f; // Generate random rotation (0-360 degrees)
-    unsigned int shapeSeed = rand(); // Generate random shape seed for procedural variation
-    int colorIndex = rand() % 8; // Generate random color index (0-7)
-    *outBoulder = (BoulderInstance){x, y, z, scale, rotation, shapeSeed, colorIndex}; // Create boulder instance
-    return 1; // Success
+// makeRandomBoulder: Creates a single boulder instance with random properties at a validated position.
+// Contribution: This function generates the random scale, rotation, shape seed, and color of a boulder once its placement has been accepted.
+static BoulderInstance makeRandomBoulder(Rng* rng, float x, float y, float z) {
+    float scale = boulderRandomScale(rng); // Generate random scale
+    float rotation = rngRange(rng, 0.0f, 360.0f); // Generate random rotation (0-360 degrees)
+    unsigned int shapeSeed = (unsigned int)rngInt(rng, 32768); // Generate random shape seed for procedural variation
+    int colorIndex = rngInt(rng, 8); // Generate random color index (0-7)
+    return (BoulderInstance){x, y, z, scale, rotation, shapeSeed, colorIndex}; // Create boulder instance
 }
 
-// initBoulders: Initializes the entire boulder system with procedural placement across the landscape.
-// Contribution: This function creates the complete boulder system by generating multiple boulders with valid placement. It uses a retry mechanism to ensure all boulders are placed successfully, even if some locations are invalid.
-void initBoulders(Landscape* landscape) {
-    freeBoulders(); // Clean up any existing boulders
-    if (!landscape) return; // Early exit if landscape is not available
-    boulders = (BoulderInstance*)malloc(sizeof(BoulderInstance) * NUM_BOULDERS); // Allocate boulder array
-    numBoulders = 0; // Initialize boulder count
+// generateBoulders: Places up to NUM_BOULDERS boulders across a landscape, clear of the given trees, into a new array.
+// Contribution: This function draws batches of random candidate positions from the seed, queries their terrain height and placement bits together, and accepts valid ones until all boulders are placed or the attempt budget runs out. Every attempt has its own random stream (position, then attributes), so a candidate's boulder depends only on the seed and the attempt number. It makes no GL calls and shares no state, so streamed terrain tiles can be populated on worker threads. The caller owns the returned array; *outCount receives the number placed.
+BoulderInstance* generateBoulders(Landscape* landscape, const TreeInstance* trees, int treeCount, unsigned int seed, int* outCount) {
+    *outCount = 0;
+    if (!landscape) return NULL; // Early exit if landscape is not available
+    BoulderInstance* placed = (BoulderInstance*)malloc(sizeof(BoulderInstance) * NUM_BOULDERS); // Allocate boulder array
+    if (!placed) return NULL; // Leave the scene without boulders if allocation fails
+    int count = 0; // Initialize boulder count
+    float xs[BOULDER_PLACEMENT_BATCH], zs[BOULDER_PLACEMENT_BATCH], ys[BOULDER_PLACEMENT_BATCH]; // Candidate batch
+    unsigned int masks[BOULDER_PLACEMENT_BATCH]; // Placement bits of each candidate's terrain cell
+    int rule = landscapeAddPlacementRule(landscape, &boulderRule); // Bit of the boulder rule in the placement masks
+    if (rule < 0) { // No free placement rule bit: leave the scene without boulders
+        free(placed);
+        return NULL;
+    }
+    float minX = landscape->origin[0] + landscape->scale * 0.025f; // Placement boundary (95% of terrain size, centered)
+    float minZ = landscape->origin[1] + landscape->scale * 0.025f;
+    Rng rngs[BOULDER_PLACEMENT_BATCH]; // Random stream of each candidate in the batch
     int attempts = 0; // Track placement attempts
-    while (numBoulders < NUM_BOULDERS && attempts < NUM_BOULDERS * 10) { // Continue until all boulders placed or max attempts reached
-        attempts++; // Increment attempt counter
-        BoulderInstance b; // Temporary boulder instance
-        if (generateRandomBoulder(landscape, &b)) { // Try to generate a boulder
-            boulders[numBoulders++] = b; // Add successful boulder to array
+    while (count < NUM_BOULDERS && attempts < NUM_BOULDERS * 10) { // Continue until all boulders placed or max attempts reached
+        int n = NUM_BOULDERS * 10 - attempts; // Candidates left in the attempt budget
+        if (n > BOULDER_PLACEMENT_BATCH) n = BOULDER_PLACEMENT_BATCH;
+        for (int i = 0; i < n; i++) {
+            rngSeed(&rngs[i], seed, (unsigned int)(attempts + i)); // Stream of this attempt
+            xs[i] = minX + rngFloat(&rngs[i]) * landscape->scale * 0.95f; // Random X position within bounds
+            zs[i] = minZ + rngFloat(&rngs[i]) * landscape->scale * 0.95f; // Random Z position within bounds
+        }
+        landscapeGetHeightBatch(landscape, xs, zs, n, ys); // Get terrain heights for the batch
+        landscapeGetPlacementBatch(landscape, xs, zs, n, masks); // Get terrain placement bits for the batch
+        for (int i = 0; i < n && count < NUM_BOULDERS; i++) {
+            attempts++; // Increment attempt counter
+            if (isValidBoulderLocation(xs[i], zs[i], masks[i], rule, trees, treeCount)) { // Check if location is valid
+                placed[count++] = makeRandomBoulder(&rngs[i], xs[i], ys[i], zs[i]); // Add successful boulder to array
+            }
         }
     }
+    *outCount = count;
+    return placed;
+}
+
+// initBoulders: Initializes the entire boulder system with procedural placement across the landscape.
+// Contribution: This function places the home terrain's boulders from the seed, keeping them clear of the placed trees.
+void initBoulders(Landscape* landscape, unsigned int seed) {
+    freeBoulders(); // Clean up any existing boulders
+    boulders = generateBoulders(landscape, treeInstances, numTrees, seed, &numBoulders);
+}
+
+// loadBoulders: Restores previously generated boulders instead of placing new ones.
+// Contribution: This function lets the world cache skip boulder placement entirely by copying saved instances back into the boulder array.
+void loadBoulders(const BoulderInstance* src, int count) {
+    freeBoulders(); // Clean up any existing boulders
+    if (count <= 0) return; // Nothing to load
+    boulders = (BoulderInstance*)malloc(sizeof(BoulderInstance) * count); // Allocate boulder array
+    if (!boulders) return; // Leave the scene without boulders if allocation fails
+    memcpy(boulders, src, sizeof(BoulderInstance) * count); // Copy the saved instances
+    numBoulders = count; // Record how many boulders were loaded
+}
+
+// getBoulders: Returns the placed boulders and stores their count in *count.
+// Contribution: This function gives the world cache read access to the boulder array so the placement can be saved.
+const BoulderInstance* getBoulders(int* count) {
+    *count = numBoulders; // Number of placed boulders
+    return boulders; // Boulder array (NULL when none are placed)
 }
 
 // computeNormal: Calculates surface normals for proper lighting calculations.
@@ -269,15 +305,21 @@ void boulderDraw(float x, float y, float z, float scale, float rotation, unsigne
     cleanupBoulderDraw(); // Clean up OpenGL state
 }
 
-// renderBoulders: Renders all boulders in the scene with their individual properties.
-// Contribution: This function renders the entire boulder system by iterating through all boulder instances. It calls the individual boulder rendering function for each boulder with its specific properties, creating the complete boulder scene.
-void renderBoulders() {
-    for (int i = 0; i < numBoulders; ++i) { // Iterate through all boulders
-        BoulderInstance* b = &boulders[i]; // Get current boulder instance
+// renderBoulderInstances: Renders a list of boulders with their individual properties.
+// Contribution: This function lets any owner of a boulder array (the home terrain or a streamed tile) draw it.
+void renderBoulderInstances(const BoulderInstance* list, int count) {
+    for (int i = 0; i < count; ++i) { // Iterate through all boulders
+        const BoulderInstance* b = &list[i]; // Get current boulder instance
         boulderDraw(b->x, b->y, b->z, b->scale, b->rotation, b->shapeSeed, b->colorIndex); // Render this boulder
     }
 }
 
+// renderBoulders: Renders all boulders in the scene with their individual properties.
+// Contribution: This function renders the home terrain's boulders, creating the complete boulder scene.
+void renderBoulders() {
+    renderBoulderInstances(boulders, numBoulders);
+}
+
 // boulderShaderInit: Initializes the boulder shader program for advanced rendering.
 // Contribution: This function loads and initializes the boulder shader program from vertex and fragment shader files. It enables advanced rendering features like texture mapping, lighting, and color variation for realistic boulder appearance.
 void boulderShaderInit() {
@@ -2,6 +2,7 @@
 #define BOULDER_H
 
 #include "landscape.h"
+#include "objects_render.h"
 
 typedef struct {
     float x, y, z;
@@ -12,7 +13,11 @@ typedef struct {
 } BoulderInstance;
 
 void freeBoulders(void);
-void initBoulders(Landscape* landscape);
+BoulderInstance* generateBoulders(Landscape* landscape, const TreeInstance* trees, int treeCount, unsigned int seed, int* outCount);
+void initBoulders(Landscape* landscape, unsigned int seed);
+void loadBoulders(const BoulderInstance* src, int count);
+const BoulderInstance* getBoulders(int* count);
+void renderBoulderInstances(const BoulderInstance* boulders, int count);
 void renderBoulders(void);
 void boulderDraw(float x, float y, float z, float scale, float rotation, unsigned int shapeSeed, int colorIndex);
 void boulderShaderInit(void);
@@ -9,11 +9,13 @@
  * Key Concepts:
  * - Dual Camera Modes: First-person (walking) and free-orbit (flying) modes with seamless transitions.
  * - Terrain Integration: Camera height automatically follows the landscape surface for realistic movement.
- * - Boundary Constraints: Prevents camera from leaving the valid terrain area for consistent experience.
+ * - Boundary Constraints: Prevents camera from leaving the valid terrain area for consistent experience, unless terrain
+ *   tiles are streamed around it, in which case the world has no edge.
  * - Input Processing: Handles keyboard movement and mouse rotation with configurable sensitivity.
  * - View Matrix Management: Automatically updates camera vectors and OpenGL view transformations.
  *
  * Function Roles:
+ * - groundHeight: Terrain height under a point, from the streamed tiles when streaming is on.
  * - viewCameraCreate: Initializes a new camera with default settings and memory allocation.
  * - viewCameraSetProjection: Configures OpenGL projection matrix for different camera modes.
  * - viewCameraUpdateVectors: Recalculates camera position, look-at point, and up vector based on mode.
@@ -28,10 +30,12 @@
 #include "CSCIx229.h"
 #include "camera.h"
 #include "landscape.h"
+#include "terrain_stream.h"
 #include <math.h>
 #include <stdlib.h>
 
 extern Landscape* landscape;
+extern TerrainStream* terrainStream;
 
 // Utility macro to convert degrees to radians
 #define RADIAN(x) ((x) * 0.01745329252f)
@@ -50,6 +54,18 @@ extern Landscape* landscape;
 // Forward declaration for boundary clamping function
 static void clampCameraToBounds(ViewCamera* cam);
 
+// terrainScale: Returns the world-space width of the loaded landscape.
+// Contribution: Lets every camera bound and default distance follow the terrain chosen at runtime, falling back to the default width before a landscape exists.
+static float terrainScale(void) {
+    return landscape ? landscape->scale : LANDSCAPE_SCALE;
+}
+
+// groundHeight: Returns the terrain height at world (x, z).
+// Contribution: Lets the first-person camera walk onto streamed terrain tiles as well as the home terrain.
+static float groundHeight(float x, float z) {
+    return terrainStream ? terrainStreamGetHeight(terrainStream, x, z) : landscapeGetHeight(landscape, x, z);
+}
+
 // viewCameraCreate: Initializes a new camera with default settings and memory allocation.
 // Contribution: This function is the entry point for creating a camera system. It allocates memory for the camera structure, sets up default positions and orientations for both camera modes, and initializes the camera vectors. This establishes the foundation for all camera operations in the scene.
 ViewCamera* viewCameraCreate(void) {
@@ -63,7 +79,7 @@ ViewCamera* viewCameraCreate(void) {
     c->fpPitch = 0.0f; // Initial pitch angle for first-person mode
     c->orbitYaw = 60.0f; // Initial yaw angle for orbit mode
     c->orbitPitch = 20.0f; // Initial pitch angle for orbit mode
-    c->orbitDistance = LANDSCAPE_SCALE * 0.7f; // Initial orbit distance from center
+    c->orbitDistance = terrainScale() * 0.7f; // Initial orbit distance from center
     c->lookAt[0] = 0.0f; // Look-at point X (center of scene)
     c->lookAt[1] = 0.0f; // Look-at point Y (center of scene)
     c->lookAt[2] = 0.0f; // Look-at point Z (center of scene)
@@ -138,9 +154,9 @@ void viewCameraMove(ViewCamera* cam, int direction, float deltaTime) {
         }
         float nx = cam->fpPosition[0] + dx; // Calculate new X position
         float nz = cam->fpPosition[2] + dz; // Calculate new Z position
-        float half = LANDSCAPE_SCALE * 0.5f; // Calculate terrain boundary
-        if (nx >= -half && nx <= half && nz >= -half && nz <= half) { // Check if new position is within bounds
-            float h = landscapeGetHeight(landscape, nx, nz); // Get terrain height at new position
+        float half = terrainScale() * 0.5f; // Calculate terrain boundary
+        if (terrainStream || (nx >= -half && nx <= half && nz >= -half && nz <= half)) { // Check if new position is within bounds
+            float h = groundHeight(nx, nz); // Get terrain height at new position
             cam->fpPosition[0] = nx; // Update X position
             cam->fpPosition[2] = nz; // Update Z position
             cam->fpPosition[1] = h + CAM_EYE_LVL; // Update Y position to terrain height plus eye level
@@ -186,10 +202,10 @@ void viewCameraSetMode(ViewCamera* cam, CameraMode newMode) {
     if (cam->mode == newMode) return; // Early exit if already in the requested mode
     cam->mode = newMode; // Set the new camera mode
     if (newMode == CAMERA_MODE_FIRST_PERSON) {
-        float h = landscapeGetHeight(landscape, cam->fpPosition[0], cam->fpPosition[2]); // Get terrain height at current position
+        float h = groundHeight(cam->fpPosition[0], cam->fpPosition[2]); // Get terrain height at current position
         cam->fpPosition[1] = h + CAM_EYE_LVL; // Set camera height to terrain height plus eye level
     } else if (newMode == CAMERA_MODE_FREE_ORBIT) {
-        cam->orbitDistance = LANDSCAPE_SCALE * 0.7f; // Reset orbit distance to default
+        cam->orbitDistance = terrainScale() * 0.7f; // Reset orbit distance to default
         cam->orbitYaw = 60.0f; // Reset orbit yaw to default
         cam->orbitPitch = 20.0f; // Reset orbit pitch to default
     }
@@ -201,7 +217,7 @@ void viewCameraSetMode(ViewCamera* cam, CameraMode newMode) {
 void viewCameraUpdate(ViewCamera* cam, float deltaTime) {
     if (!cam) return; // Early exit if camera is null
     if (cam->mode == CAMERA_MODE_FIRST_PERSON) {
-        float h = landscapeGetHeight(landscape, cam->fpPosition[0], cam->fpPosition[2]); // Get current terrain height
+        float h = groundHeight(cam->fpPosition[0], cam->fpPosition[2]); // Get current terrain height
         cam->fpPosition[1] = h + CAM_EYE_LVL; // Update camera height to follow terrain
     }
     clampCameraToBounds(cam); // Ensure camera stays within valid boundaries
@@ -210,7 +226,8 @@ void viewCameraUpdate(ViewCamera* cam, float deltaTime) {
 // clampCameraToBounds: Ensures camera stays within valid terrain boundaries.
 // Contribution: This function prevents the camera from moving outside the valid terrain area, which could cause rendering issues or disorient the user. It clamps the camera position to the landscape boundaries, ensuring a consistent and bounded exploration experience.
 static void clampCameraToBounds(ViewCamera* cam) {
-    float half = LANDSCAPE_SCALE * 0.5f; // Calculate terrain boundary
+    if (terrainStream) return; // Streamed terrain continues in every direction
+    float half = terrainScale() * 0.5f; // Calculate terrain boundary
     if (cam->mode == CAMERA_MODE_FIRST_PERSON) {
         if (cam->fpPosition[0] < -half) cam->fpPosition[0] = -half; // Clamp X position to minimum boundary
         if (cam->fpPosition[0] > half) cam->fpPosition[0] = half; // Clamp X position to maximum boundary
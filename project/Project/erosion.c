@@ -0,0 +1,231 @@
+/*
+ * erosion.c - Hydraulic and Thermal Erosion of the Terrain Heightfield
+ *
+ * This file weathers the noise heightfield so larger terrains get carved valleys, sediment fans, and relaxed cliffs
+ * instead of uniform noise. It runs as an optional stage between height generation and normal computation.
+ *
+ * Key Concepts:
+ * - Hydraulic erosion: Water droplets run downhill over the grid, picking up sediment where they speed up and
+ *   dropping it where they slow down or the ground rises.
+ * - Tiles and halos: The grid is cut into EROSION_TILE tiles. A droplet starts inside its tile and may wander up to
+ *   EROSION_HALO cells beyond it before it stops. Tiles are processed in four checkerboard phases; two tiles of the same
+ *   phase are a full tile apart, so their tile-plus-halo regions never overlap and can be eroded in place at the same
+ *   time. Consecutive phases see each other's halo edits, which plays the role of a halo exchange.
+ * - Thermal erosion: Material slides from a cell to each 4-neighbour that sits lower than the talus slope allows.
+ *   Every cell reads the old heights and writes its own new height, so rows run in parallel and mass is conserved.
+ * - Determinism: Each tile's droplets come from a random stream seeded by (seed, iteration, tile), and tiles of one
+ *   phase never touch the same cells, so the result depends only on the seed, not on the thread count or scheduling.
+ * - Units: Droplet physics runs in cell units (heights divided by the cell size), so the same settings erode alike at
+ *   every grid resolution.
+ *
+ * Function Roles:
+ * - sampleHeight: Bilinear height and gradient at a point inside the grid.
+ * - depositAt: Adds (or removes) material at a point, split bilinearly over the four surrounding vertices.
+ * - runDroplet: Simulates one droplet inside a tile's region.
+ * - erodeTiles: Thread pool callback eroding the tiles of one phase.
+ * - erosionHydraulic: Runs one hydraulic iteration over all tiles and returns the number of droplets simulated.
+ * - thermalRows / copyRows: Thread pool callbacks for the thermal pass.
+ * - erosionThermal: Runs one thermal relaxation pass.
+ * - erosionApply: Runs the full erosion stage (hydraulic then thermal, per iteration).
+ */
+
+#include "CSCIx229.h"
+#include "erosion.h"
+#include "threadpool.h"
+#include "rng.h"
+
+// Droplet physics, in cell units.
+#define DROPLET_INERTIA 0.05f       // How much a droplet keeps its direction instead of following the slope
+#define DROPLET_CAPACITY 4.0f       // Sediment a droplet can carry per unit of speed, water, and drop
+#define DROPLET_MIN_CAPACITY 0.01f  // Capacity floor so droplets on flat ground still carry a little
+#define DROPLET_ERODE_RATE 0.3f     // Fraction of the spare capacity picked up per step
+#define DROPLET_DEPOSIT_RATE 0.3f   // Fraction of the excess sediment dropped per step
+#define DROPLET_EVAPORATION 0.01f   // Fraction of the water lost per step
+#define DROPLET_GRAVITY 4.0f        // Speed gained per unit of drop
+#define THERMAL_RATE 0.1f           // Fraction of the excess height difference moved per neighbour and pass
+#define EROSION_ROW_GRAIN 16        // Rows per thread pool chunk in the thermal pass
+
+// sampleHeight: Returns the bilinear height at (x, z) in grid units and stores the gradient in grad.
+static float sampleHeight(const float* heights, int size, float x, float z, float grad[2]) {
+    int ix = (int)x, iz = (int)z;
+    float fx = x - ix, fz = z - iz;
+    const float* p = &heights[iz * size + ix];
+    float h00 = p[0], h10 = p[1], h01 = p[size], h11 = p[size + 1];
+    grad[0] = (h10 - h00) * (1.0f - fz) + (h11 - h01) * fz;
+    grad[1] = (h01 - h00) * (1.0f - fx) + (h11 - h10) * fx;
+    return h00 * (1.0f - fx) * (1.0f - fz) + h10 * fx * (1.0f - fz) + h01 * (1.0f - fx) * fz + h11 * fx * fz;
+}
+
+// depositAt: Adds amount to the ground at (x, z), split bilinearly over the four surrounding vertices (negative erodes).
+static void depositAt(float* heights, int size, float x, float z, float amount) {
+    int ix = (int)x, iz = (int)z;
+    float fx = x - ix, fz = z - iz;
+    float* p = &heights[iz * size + ix];
+    p[0] += amount * (1.0f - fx) * (1.0f - fz);
+    p[1] += amount * fx * (1.0f - fz);
+    p[size] += amount * (1.0f - fx) * fz;
+    p[size + 1] += amount * fx * fz;
+}
+
+// runDroplet: Simulates one droplet starting at (x, z) that stays within [rx0, rx1) x [rz0, rz1).
+// Heights are in world units; invCell converts them to cell units for the physics and cell back again for edits.
+static void runDroplet(float* heights, int size, float cell, float x, float z, int rx0, int rz0, int rx1, int rz1) {
+    float invCell = 1.0f / cell;
+    float dirX = 0.0f, dirZ = 0.0f;
+    float speed = 1.0f, water = 1.0f, sediment = 0.0f; // Sediment in cell units.
+    for (int step = 0; step < EROSION_DROPLET_LIFETIME; step++) {
+        float grad[2];
+        float h = sampleHeight(heights, size, x, z, grad) * invCell;
+        // Turn towards the downhill direction, keeping some of the old heading.
+        dirX = dirX * DROPLET_INERTIA - grad[0] * invCell * (1.0f - DROPLET_INERTIA);
+        dirZ = dirZ * DROPLET_INERTIA - grad[1] * invCell * (1.0f - DROPLET_INERTIA);
+        float len = sqrtf(dirX * dirX + dirZ * dirZ);
+        if (len < 1e-6f) break; // Flat ground: the droplet stops.
+        dirX /= len;
+        dirZ /= len;
+        float nx = x + dirX, nz = z + dirZ;
+        if (nx < rx0 || nz < rz0 || nx >= rx1 || nz >= rz1) break; // Left the tile's region.
+        float dh = sampleHeight(heights, size, nx, nz, grad) * invCell - h;
+        float capacity = -dh * speed * water * DROPLET_CAPACITY;
+        if (capacity < DROPLET_MIN_CAPACITY) capacity = DROPLET_MIN_CAPACITY;
+        if (sediment > capacity || dh > 0.0f) {
+            // Going uphill fills the pit behind the droplet; otherwise drop part of the excess sediment.
+            float amount = dh > 0.0f ? (dh < sediment ? dh : sediment) : (sediment - capacity) * DROPLET_DEPOSIT_RATE;
+            sediment -= amount;
+            depositAt(heights, size, x, z, amount * cell);
+        } else {
+            // Pick up part of the spare capacity, never digging deeper than the drop ahead.
+            float amount = (capacity - sediment) * DROPLET_ERODE_RATE;
+            if (amount > -dh) amount = -dh;
+            sediment += amount;
+            depositAt(heights, size, x, z, -amount * cell);
+        }
+        float v2 = speed * speed - dh * DROPLET_GRAVITY;
+        speed = v2 > 0.0f ? sqrtf(v2) : 0.0f;
+        water *= 1.0f - DROPLET_EVAPORATION;
+        x = nx;
+        z = nz;
+    }
+    if (sediment > 0.0f) depositAt(heights, size, x, z, sediment * cell); // Whatever is left settles where the droplet stopped.
+}
+
+// HydraulicPhase: Shared state for eroding the tiles of one checkerboard phase.
+typedef struct {
+    float* heights;
+    int size;
+    float cellSize;
+    int tilesX;          // Tiles per grid row
+    int phase;           // Checkerboard phase (0-3): x parity in bit 0, z parity in bit 1
+    int phaseTilesX;     // Tiles of this phase per row
+    int iteration;
+    unsigned int seed;
+} HydraulicPhase;
+
+// erodeTiles: Thread pool callback that runs the droplets of phase tiles [begin, end).
+static void erodeTiles(int begin, int end, void* userData) {
+    const HydraulicPhase* job = (const HydraulicPhase*)userData;
+    int cells = job->size - 1; // Droplets move over the cells, whose corners are the grid vertices.
+    for (int i = begin; i < end; i++) {
+        int tx = (i % job->phaseTilesX) * 2 + (job->phase & 1);
+        int tz = (i / job->phaseTilesX) * 2 + (job->phase >> 1);
+        int x0 = tx * EROSION_TILE, z0 = tz * EROSION_TILE;
+        int x1 = x0 + EROSION_TILE < cells ? x0 + EROSION_TILE : cells;
+        int z1 = z0 + EROSION_TILE < cells ? z0 + EROSION_TILE : cells;
+        // The droplets may wander into the halo around the tile, clipped to the grid.
+        int rx0 = x0 > EROSION_HALO ? x0 - EROSION_HALO : 0, rz0 = z0 > EROSION_HALO ? z0 - EROSION_HALO : 0;
+        int rx1 = x1 + EROSION_HALO < cells ? x1 + EROSION_HALO : cells;
+        int rz1 = z1 + EROSION_HALO < cells ? z1 + EROSION_HALO : cells;
+        Rng rng; // Stream of this tile, from a seed per iteration
+        rngSeed(&rng, rngHash(job->seed, (unsigned int)job->iteration), (unsigned int)(tz * job->tilesX + tx));
+        int droplets = (x1 - x0) * (z1 - z0) / EROSION_CELLS_PER_DROPLET;
+        for (int d = 0; d < droplets; d++) {
+            float x = x0 + rngFloat(&rng) * (x1 - x0);
+            float z = z0 + rngFloat(&rng) * (z1 - z0);
+            runDroplet(job->heights, job->size, job->cellSize, x, z, rx0, rz0, rx1, rz1);
+        }
+    }
+}
+
+// erosionHydraulic: Runs one hydraulic erosion iteration over a size x size heightfield and returns the droplet count.
+// cellSize is the world-space distance between grid vertices; iteration selects the droplets' random streams.
+int erosionHydraulic(float* heights, int size, float cellSize, int iteration, unsigned int seed) {
+    int cells = size - 1;
+    int tilesX = (cells + EROSION_TILE - 1) / EROSION_TILE;
+    int total = 0;
+    for (int phase = 0; phase < 4; phase++) {
+        // Tiles whose x and z parity match the phase.
+        int phaseTilesX = (tilesX - (phase & 1) + 1) / 2;
+        int phaseTilesZ = (tilesX - (phase >> 1) + 1) / 2;
+        HydraulicPhase job = {heights, size, cellSize, tilesX, phase, phaseTilesX, iteration, seed};
+        threadPoolParallelFor(phaseTilesX * phaseTilesZ, 1, erodeTiles, &job);
+    }
+    for (int tz = 0; tz < tilesX; tz++) { // Count the droplets the tiles ran.
+        for (int tx = 0; tx < tilesX; tx++) {
+            int w = cells - tx * EROSION_TILE < EROSION_TILE ? cells - tx * EROSION_TILE : EROSION_TILE;
+            int h = cells - tz * EROSION_TILE < EROSION_TILE ? cells - tz * EROSION_TILE : EROSION_TILE;
+            total += w * h / EROSION_CELLS_PER_DROPLET;
+        }
+    }
+    return total;
+}
+
+// ThermalPass: Shared state for one thermal relaxation pass.
+typedef struct {
+    const float* src;
+    float* dst;
+    int size;
+    float talus;         // Largest height difference between neighbours that is left alone
+} ThermalPass;
+
+// thermalRows: Thread pool callback computing the relaxed heights of rows [begin, end) into dst.
+// Each neighbour pair exchanges the same amount in opposite directions, so the pass conserves material.
+static void thermalRows(int begin, int end, void* userData) {
+    const ThermalPass* pass = (const ThermalPass*)userData;
+    int size = pass->size;
+    for (int z = begin; z < end; z++) {
+        for (int x = 0; x < size; x++) {
+            const float* p = &pass->src[z * size + x];
+            float h = p[0], change = 0.0f;
+            float n[4];
+            int count = 0;
+            if (x > 0) n[count++] = p[-1];
+            if (x < size - 1) n[count++] = p[1];
+            if (z > 0) n[count++] = p[-size];
+            if (z < size - 1) n[count++] = p[size];
+            for (int i = 0; i < count; i++) {
+                float d = n[i] - h;
+                if (d > pass->talus) change += (d - pass->talus) * THERMAL_RATE;      // Material slides in from above.
+                else if (d < -pass->talus) change += (d + pass->talus) * THERMAL_RATE; // Material slides down to the neighbour.
+            }
+            pass->dst[z * size + x] = h + change;
+        }
+    }
+}
+
+// copyRows: Thread pool callback copying rows [begin, end) from dst back to src.
+static void copyRows(int begin, int end, void* userData) {
+    const ThermalPass* pass = (const ThermalPass*)userData;
+    size_t first = (size_t)begin * pass->size;
+    memcpy((float*)pass->src + first, pass->dst + first, sizeof(float) * (size_t)(end - begin) * pass->size);
+}
+
+// erosionThermal: Runs one thermal relaxation pass; scratch must hold size * size floats.
+void erosionThermal(float* heights, float* scratch, int size, float cellSize) {
+    ThermalPass pass = {heights, scratch, size, EROSION_TALUS * cellSize};
+    threadPoolParallelFor(size, EROSION_ROW_GRAIN, thermalRows, &pass);
+    threadPoolParallelFor(size, EROSION_ROW_GRAIN, copyRows, &pass);
+}
+
+// erosionApply: Runs 'iterations' rounds of hydraulic erosion followed by a thermal pass on a size x size heightfield.
+// Returns the number of droplets simulated, or -1 if the scratch memory could not be allocated.
+long long erosionApply(float* heights, int size, float cellSize, int iterations, unsigned int seed) {
+    float* scratch = (float*)malloc(sizeof(float) * (size_t)size * size);
+    if (!scratch) return -1;
+    long long droplets = 0;
+    for (int i = 0; i < iterations; i++) {
+        droplets += erosionHydraulic(heights, size, cellSize, i, seed);
+        erosionThermal(heights, scratch, size, cellSize);
+    }
+    free(scratch);
+    return droplets;
+}
@@ -0,0 +1,14 @@
+#ifndef EROSION_H
+#define EROSION_H
+
+#define EROSION_TILE 32               // Grid cells per hydraulic erosion tile side
+#define EROSION_HALO 15               // Cells a droplet may wander past its tile (must stay below EROSION_TILE / 2)
+#define EROSION_CELLS_PER_DROPLET 4   // Grid cells per droplet in one hydraulic iteration
+#define EROSION_DROPLET_LIFETIME 30   // Maximum steps a droplet takes
+#define EROSION_TALUS 0.8f            // Steepest slope (rise over run) the thermal pass leaves untouched
+
+long long erosionApply(float* heights, int size, float cellSize, int iterations, unsigned int seed);
+int erosionHydraulic(float* heights, int size, float cellSize, int iteration, unsigned int seed);
+void erosionThermal(float* heights, float* scratch, int size, float cellSize);
+
+#endif
@@ -25,6 +25,7 @@
 #include "CSCIx229.h"
 #include "fractal_tree.h"
 #include "shaders.h"
+#include "rng.h"
 
 // Shader handles for branches and leaves
 static int branchShader = 0;
@@ -87,16 +88,16 @@ static void drawCylinderY(double length, double baseRadius, double topRadius) {
 
 // drawLeafSegment: Renders a single segment of a leaf layer as a quad strip.
 // Contribution: This function is called by drawLeafLayer to build up the geometry for a single horizontal layer of leaves. It adds color, normal, and texture variation for realism, and is designed for efficiency. By using a strip of quads, it avoids the performance cost of rendering thousands of individual leaves, while still providing a lush appearance.
-static void drawLeafSegment(int i, int segments, float radius, float y, float layerSpacing, float heightPercent, unsigned int seed, int leafColorIndex) {
+static void drawLeafSegment(int i, int segments, float radius, float y, float layerSpacing, float heightPercent, Rng* rng, int leafColorIndex) {
     float angle = (float)i / segments * 2.0f * M_PI; // Angle for this segment
-    float radiusVar = 1.0f + ((float)rand() / RAND_MAX) * 0.2f - 0.1f; // Slight randomization of radius for natural look
+    float radiusVar = rngRange(rng, 0.9f, 1.1f); // Slight randomization of radius for natural look
     float x = cosf(angle) * radius * radiusVar; // X position of lower vertex
     float z = sinf(angle) * radius * radiusVar; // Z position of lower vertex
     float nx = cosf(angle); // Normal X
     float ny = 0.7f; // Normal Y (upwards bias for leaf orientation)
     float nz = sinf(angle); // Normal Z
     float nlen = sqrtf(nx*nx + ny*ny + nz*nz); // Normalize normal
-    float shade = 0.8f + ((float)rand() / RAND_MAX) * 0.2f; // Random shade for color variation
+    float shade = rngRange(rng, 0.8f, 1.0f); // Random shade for color variation
     glColor3f(0.45f * shade, 0.75f * shade, 0.25f * shade); // Set color for lower vertex
     glNormal3f(nx/nlen, ny/nlen, nz/nlen); // Set normal for lighting
     glTexCoord2f(i/(float)segments, 0.0f); // Texture coordinate at base
@@ -113,11 +114,11 @@ static void drawLeafSegment(int i, int segments, float radius, float y, float la
 
 // drawLeafLayer: Renders a single horizontal layer of leaves as a triangle strip.
 // Contribution: This function builds up a full ring of leaves at a given height, calling drawLeafSegment for each segment. It is called multiple times by drawLeafCluster to create a multi-layered, volumetric leaf cluster. This approach balances visual density with rendering efficiency.
-static void drawLeafLayer(float y, float layerSpacing, float baseRadius, float heightPercent, int segments, unsigned int seed, int leafColorIndex) {
+static void drawLeafLayer(float y, float layerSpacing, float baseRadius, float heightPercent, int segments, Rng* rng, int leafColorIndex) {
     float radius = baseRadius * (1.0f - powf(heightPercent - 0.3f, 2.0f)) * 1.8f; // Compute radius for this layer, with a bulge in the middle
     glBegin(GL_TRIANGLE_STRIP); // Start drawing the layer
     for (int i = 0; i <= segments; i++) {
-        drawLeafSegment(i, segments, radius, y, layerSpacing, heightPercent, seed, leafColorIndex); // Draw each segment
+        drawLeafSegment(i, segments, radius, y, layerSpacing, heightPercent, rng, leafColorIndex); // Draw each segment
     }
     glEnd(); // End layer
 }
@@ -127,7 +128,8 @@ static void drawLeafLayer(float y, float layerSpacing, float baseRadius, float h
 static void drawLeafCluster(float height, float baseRadius, int layers, int segments, unsigned int seed, int leafColorIndex) {
     float layerSpacing = height / layers; // Vertical spacing between layers
     float startHeight = 0.0f; // Starting Y position
-    srand(seed); // Seed random for repeatable variation
+    Rng rng;
+    rngSeed(&rng, seed, 0); // The cluster's own random stream, so its variation repeats every frame
     if (leafTexture) {
         glActiveTexture(GL_TEXTURE0); // Activate texture unit 0
         glBindTexture(GL_TEXTURE_2D, leafTexture); // Bind leaf texture
@@ -140,7 +142,7 @@ static void drawLeafCluster(float height, float baseRadius, int layers, int segm
     for (int layer = 0; layer < layers; layer++) {
         float heightPercent = (float)layer / layers; // Fractional height for this layer
         float y = startHeight + layer * layerSpacing; // Y position for this layer
-        drawLeafLayer(y, layerSpacing, baseRadius, heightPercent, segments, seed, leafColorIndex); // Draw the layer
+        drawLeafLayer(y, layerSpacing, baseRadius, heightPercent, segments, &rng, leafColorIndex); // Draw the layer
     }
     if (leafTexture) glDisable(GL_TEXTURE_2D); // Disable texturing
 }
@@ -0,0 +1,89 @@
+/*
+ * frustum.c - View Frustum Extraction and Bounding Box Culling
+ *
+ * This file provides a small view frustum helper shared by the rendering systems that split their geometry into
+ * spatial pieces (such as terrain chunks). It reads the current OpenGL projection and modelview matrices, so it
+ * works with whatever camera set up the scene (gluLookAt, Project, etc.).
+ *
+ * Key Concepts:
+ * - Plane extraction: The six clip planes are read straight out of the combined projection * modelview matrix.
+ * - Box culling: An axis-aligned box is rejected when it lies completely behind any one plane.
+ * - Eye position: The camera position is recovered from the modelview matrix for distance-based level of detail.
+ *
+ * Function Roles:
+ * - viewFrustumExtract: Captures the planes and eye position from the current OpenGL matrices.
+ * - viewFrustumTestBox: Reports whether an axis-aligned box is at least partly inside the frustum.
+ * - viewFrustumBoxDistance: Returns the distance from the eye to the closest point of a box.
+ * - viewFrustumBoxFarDistance: Returns the distance from the eye to the farthest point of a box.
+ */
+
+#include "CSCIx229.h"
+#include "frustum.h"
+
+// viewFrustumExtract: Builds the six frustum planes and the eye position from the current OpenGL matrices.
+// Must be called after the camera transform has been applied to the modelview matrix.
+void viewFrustumExtract(ViewFrustum* frustum) {
+    float p[16], m[16], c[16];
+    glGetFloatv(GL_PROJECTION_MATRIX, p); // Current projection matrix (column-major).
+    glGetFloatv(GL_MODELVIEW_MATRIX, m);  // Current modelview matrix (column-major).
+    // Combined clip matrix c = p * m.
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            c[col*4 + row] = p[0*4 + row] * m[col*4 + 0] + p[1*4 + row] * m[col*4 + 1]
+                           + p[2*4 + row] * m[col*4 + 2] + p[3*4 + row] * m[col*4 + 3];
+        }
+    }
+    // Each plane is the fourth row of the clip matrix plus or minus one of the other rows.
+    for (int i = 0; i < 6; i++) {
+        int axis = i / 2;                      // 0 = x (left/right), 1 = y (bottom/top), 2 = z (near/far)
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        float* pl = frustum->planes[i];
+        for (int k = 0; k < 4; k++) pl[k] = c[k*4 + 3] + sign * c[k*4 + axis];
+        float len = sqrtf(pl[0]*pl[0] + pl[1]*pl[1] + pl[2]*pl[2]); // Normalize so distances are in world units.
+        if (len > 0.0f) {
+            for (int k = 0; k < 4; k++) pl[k] /= len;
+        }
+    }
+    // The modelview is a rigid camera transform, so the eye is -R^T * t.
+    for (int j = 0; j < 3; j++) {
+        frustum->eye[j] = -(m[j*4 + 0] * m[12] + m[j*4 + 1] * m[13] + m[j*4 + 2] * m[14]);
+    }
+}
+
+// viewFrustumTestBox: Returns 1 if the axis-aligned box [boxMin, boxMax] is at least partly inside the frustum.
+// Tests only the box corner furthest along each plane normal, so a box is rejected only when it is fully outside.
+int viewFrustumTestBox(const ViewFrustum* frustum, const float boxMin[3], const float boxMax[3]) {
+    for (int i = 0; i < 6; i++) {
+        const float* pl = frustum->planes[i];
+        float x = pl[0] >= 0.0f ? boxMax[0] : boxMin[0]; // Corner furthest in the plane's direction.
+        float y = pl[1] >= 0.0f ? boxMax[1] : boxMin[1];
+        float z = pl[2] >= 0.0f ? boxMax[2] : boxMin[2];
+        if (pl[0]*x + pl[1]*y + pl[2]*z + pl[3] < 0.0f) return 0; // Entirely behind this plane.
+    }
+    return 1;
+}
+
+// viewFrustumBoxDistance: Returns the distance from the eye to the nearest point of the box (0 when inside).
+// Used to pick level of detail so that a piece of geometry refines as soon as any part of it gets close.
+float viewFrustumBoxDistance(const ViewFrustum* frustum, const float boxMin[3], const float boxMax[3]) {
+    float d2 = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        float e = frustum->eye[k];
+        float d = e < boxMin[k] ? boxMin[k] - e : (e > boxMax[k] ? e - boxMax[k] : 0.0f); // Per-axis gap to the box.
+        d2 += d * d;
+    }
+    return sqrtf(d2);
+}
+
+// viewFrustumBoxFarDistance: Returns the distance from the eye to the farthest corner of the box.
+// Together with viewFrustumBoxDistance it bounds the distances of everything in the box, e.g. to find level of detail
+// transitions that run through it.
+float viewFrustumBoxFarDistance(const ViewFrustum* frustum, const float boxMin[3], const float boxMax[3]) {
+    float d2 = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        float a = fabsf(frustum->eye[k] - boxMin[k]), b = fabsf(frustum->eye[k] - boxMax[k]);
+        float d = a > b ? a : b; // Per-axis distance to the far face.
+        d2 += d * d;
+    }
+    return sqrtf(d2);
+}
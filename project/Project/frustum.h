@@ -0,0 +1,11 @@
+#pragma once
+
+typedef struct {
+    float planes[6][4];     // Left, right, bottom, top, near, far planes as (a, b, c, d) with inward-facing normals
+    float eye[3];           // World-space camera position recovered from the modelview matrix
+} ViewFrustum;
+
+void viewFrustumExtract(ViewFrustum* frustum);
+int viewFrustumTestBox(const ViewFrustum* frustum, const float boxMin[3], const float boxMax[3]);
+float viewFrustumBoxDistance(const ViewFrustum* frustum, const float boxMin[3], const float boxMax[3]);
+float viewFrustumBoxFarDistance(const ViewFrustum* frustum, const float boxMin[3], const float boxMax[3]);
@@ -8,118 +8,634 @@
  *
  * Key Concepts:
  * - Procedural Placement: Grass blades are distributed randomly, but only on plausible terrain (not too steep, not underwater).
+ * - Poisson-Disk Placement: Exactly the requested number of blades is spread as blue noise over the terrain cells that
+ *   pass the grass rule. The area is cut into tiles of GRASS_TILE_CELLS terrain cells, each getting a share of the
+ *   blades proportional to its valid cells; tiles throw darts in parallel in four checkerboard phases (as the erosion
+ *   does), so tiles placed at the same time are a full tile apart and later phases respect the blades of earlier ones.
  * - Per-Blade Variation: Each blade has unique height, width, color, and animation seed for natural variety.
- * - Instanced Rendering: All blades are packed into a single vertex buffer and drawn in one call for efficiency.
+ * - Patches: The blades of one terrain (the home terrain or a streamed tile) are packed into one instance buffer, a
+ *   patch; patches outside the view frustum are skipped.
+ * - Cells: Inside a patch the blades are bucketed into a GRASS_CELLS x GRASS_CELLS grid, stored cell by cell with a
+ *   range table in the header. Each frame only the cells inside the frustum and the grass distance are drawn, with
+ *   neighbouring fully drawn cells merged into one draw.
+ * - Distance Fade: Within a cell the blades are ordered by sway seed, so drawing a prefix of the cell thins it evenly.
+ *   The drawn fraction falls from 1 to 0 between GRASS_FADE_START and GRASS_FADE_END, and the shader shrinks each
+ *   blade away just before its seed drops out of the prefix, so blades fade instead of popping. Each patch keeps a copy
+ *   of the seeds, so the prefix is found exactly by binary search rather than estimated from the cell's blade count.
+ * - Instancing: Every blade is one 16-byte instance record (blade fields quantized to 16 bits) drawn over a shared
+ *   blade mesh with glVertexAttribDivisor and glDrawArraysInstanced, so the blade shape is stored once instead of
+ *   being copied into every blade, and blades can have several segments at no extra memory per blade.
+ * - Levels of Detail: The blade mesh buffer holds three shapes, picked per cell by distance. Near cells draw curved
+ *   blades of GRASS_NEAR_SEGMENTS segments, mid-range cells a single triangle per blade, and far cells one clump card
+ *   per GRASS_CLUMP blades (every GRASS_CLUMP-th record, by attribute stride), which the fragment shader cuts into
+ *   spikes. Near blades straighten into the triangle with distance before their cell switches mesh, and triangles
+ *   shrink away while the cards grow in across the far band, so no level of detail pops.
+ * - GPU Culling: Where geometry shaders are available, grassSystemCull runs every blade through a cull program early in
+ *   the frame. Per level of detail, transform feedback packs the blades that pass the distance band, density, and
+ *   frustum tests into a survivor buffer, and a primitives-written query gives grassSystemRender the instance count, so
+ *   the CPU only tests whole patches. The buffers and queries are double-buffered: when this frame's counts are not
+ *   ready yet, the previous frame's survivors are drawn rather than stalling on the query. The per-cell CPU culling
+ *   above remains the fallback.
  * - Shader Animation: Swaying and lighting are handled in the vertex/fragment shaders using per-blade attributes.
  * - Resource Management: All OpenGL resources are properly allocated and freed.
  *
  * Function Roles:
- * - randomFloat: Utility for randomization, used throughout for natural variation.
- * - isValidGrassLocation: Ensures grass only appears on suitable terrain.
+ * - randomFloat: Utility for randomization from the caller's random stream, used throughout for natural variation.
+ * - grassRule: Terrain attribute placement rule that keeps grass on suitable terrain.
  * - generateGrassBlade: Creates a single blade with randomized geometry and attributes.
- * - generateGrassBlades: Populates the vertex buffer with many blades.
- * - setupGrassGL: Uploads data to the GPU and sets up OpenGL state.
+ * - tileValidCells: Lists the terrain cells of a placement tile that accept grass.
+ * - assignTileQuotas: Splits the blade count over the tiles in proportion to their valid cells.
+ * - placeGrassTiles: Thread pool callback dart-throwing the blades of the tiles of one phase.
+ * - generateGrassBlades: Populates the blade array with exactly the requested number of blades, tiles in parallel.
+ * - packGrassBlades: Quantizes the blades into 16-byte instance records, ordered by cell, behind the decode box and cell table.
+ * - compareInstances: Orders the blades of a cell by sway seed.
+ * - glVersionAtLeast: Compares the context's OpenGL version.
+ * - instancingSupported: Reports whether the context can draw instanced arrays.
+ * - buildBladeStrip: Writes the tapering triangle strip of a blade with a given number of segments.
+ * - setupGrassGL: Loads the shader and texture and creates the vertex array object and the level of detail meshes
+ *   shared by all patches.
+ * - grassSystemGenerate: Builds the blade instance array without touching OpenGL (used to fill the world cache and on
+ *   terrain streaming worker threads).
+ * - grassPatchCreate/grassPatchDestroy: Upload and release the instance buffer of one patch.
+ * - grassSystemUpload: Uploads a generated (or cached) blade instance array as the home terrain's patch.
  * - grassSystemInit: Orchestrates the full initialization process.
- * - setAttrib: Helper for binding vertex attributes in the shader.
- * - grassSystemRender: Handles all rendering, animation, and lighting for the grass.
+ * - setAttrib: Helper for binding per-instance blade attributes in the shader.
+ * - grassDensity: Sway seed below which blades are drawn at a given distance.
+ * - cellPrefix: Number of a cell's blades below a density, by binary search over the seeds.
+ * - patchVisible: Tests a whole patch against the view and the grass distance.
+ * - drawLod: Draws instances of one level of detail's mesh.
+ * - drawRun: Draws a contiguous range of a patch's blades at one level of detail.
+ * - queueRun: Extends or flushes the pending run of a level of detail.
+ * - drawVisibleCells: CPU culling path, drawing the visible cells of every patch.
+ * - setupGrassCull: Creates the GPU cull program, survivor buffers, and queries.
+ * - drawCulled: GPU culling path, drawing the survivors of this frame's cull pass, or the last frame's if not ready.
+ * - grassSystemCull: Issues the GPU cull pass for the frame.
+ * - grassSystemRender: Handles all rendering, animation, and lighting for the grass, drawing only the visible blades.
+ * - grassSystemSetGpuCulling / grassSystemGpuCulling: Switch and report the GPU culling setting.
+ * - grassSystemCulledOnGpu: Reports whether the last frame's grass was actually culled on the GPU.
+ * - grassSystemDrawnBlades / grassSystemDrawnVertices: Report how many blades and mesh vertices the last frame drew.
  * - grassSystemCleanup: Frees all OpenGL and CPU resources.
  */
 
 #include "CSCIx229.h"
 #include "grass.h"
 #include "shaders.h"
+#include "frustum.h"
+#include "threadpool.h"
+#include "rng.h"
 
-// Structure encoding all per-vertex and per-blade attributes for a grass blade.
+// Instanced drawing comes from ARB_instanced_arrays on Apple's legacy OpenGL and from the core API elsewhere.
+#ifdef __APPLE__
+    #define GRASS_ATTRIB_DIVISOR(index, divisor) glVertexAttribDivisorARB(index, divisor)
+    #define GRASS_DRAW_INSTANCED(mode, first, count, instances) glDrawArraysInstancedARB(mode, first, count, instances)
+#else
+    #define GRASS_ATTRIB_DIVISOR(index, divisor) glVertexAttribDivisor(index, divisor)
+    #define GRASS_DRAW_INSTANCED(mode, first, count, instances) glDrawArraysInstanced(mode, first, count, instances)
+#endif
+
+// GrassBlade: Per-blade attributes as generated, before quantization.
 typedef struct {
     float x, y, z;           // World-space position of the base of the blade
     float swaySeed;          // Random seed for unique swaying animation
-    float offsetX, offsetY;  // Offset for triangle vertex (defines blade shape)
     float bladeHeight, bladeWidth; // Blade geometry
-    float colorVar;          // Color variation for natural look
+    float colorVar;          // Color variation (plus color band) for natural look
     float rotation;          // Random rotation for orientation
-} GrassVertex;
+} GrassBlade;
+
+// GrassInstance: Packed per-blade record (16 bytes), read as normalized unsigned 16-bit instance attributes by the
+// grass shader. The blade shape is not stored; the shader scales the shared blade mesh by the blade size.
+typedef struct {
+    unsigned short position[4]; // x, y, z and color variation, over the buffer's GrassQuantization box
+    unsigned short blade[4];    // Sway seed, blade height, blade width, rotation
+} GrassInstance;
+
+// GrassQuantization: Box the position components of a patch's instances were quantized over.
+typedef struct {
+    float positionMin[4];    // Decoded value of a 0 component (x, y, z, color variation)
+    float positionRange[4];  // Decoded span of the full 16-bit range
+} GrassQuantization;
+
+// Cells per side of the spatial grid a patch's blades are bucketed into.
+#define GRASS_CELLS 16
+
+// GrassCell: Range of one cell's blades in the instance array and the box around their bases.
+typedef struct {
+    int first, count;        // Instance range of the cell
+    float boxMin[3];         // Bounds of the blade bases in the cell (empty cells keep zeros)
+    float boxMax[3];
+} GrassCell;
+
+// GrassHeader: Header in front of the packed instances: the decode box and the cell table, row by row (z major).
+// It travels with the instances, so a buffer read back from the world cache decodes and culls exactly as generated.
+typedef struct {
+    GrassQuantization quant;
+    GrassCell cells[GRASS_CELLS * GRASS_CELLS];
+} GrassHeader;
+
+// Fixed ranges of the blade components (each decodes from 0 to its range).
+#define GRASS_HEIGHT_RANGE 2.0f
+#define GRASS_WIDTH_RANGE 0.25f
+#define GRASS_ROTATION_RANGE (2.0f * (float)M_PI)
+
+// GrassLod: Levels of detail of the grass, from the camera outwards.
+typedef enum {
+    GRASS_LOD_NEAR,          // Curved blade of GRASS_NEAR_SEGMENTS segments
+    GRASS_LOD_MID,           // Single triangle per blade
+    GRASS_LOD_FAR,           // One clump card per GRASS_CLUMP blades
+    GRASS_LOD_COUNT
+} GrassLod;
+
+// Segments of the near blade mesh, a tapering triangle strip from the base to the tip, and blades per clump card.
+#define GRASS_NEAR_SEGMENTS 5
+#define GRASS_NEAR_VERTICES (GRASS_NEAR_SEGMENTS * 2 + 1)
+#define GRASS_CLUMP 4
+// Vertices of the shared mesh buffer: near strip, mid triangle, far card quad.
+#define GRASS_MESH_VERTICES (GRASS_NEAR_VERTICES + 3 + 4)
+
+// Near blades straighten into the mid triangle between GRASS_LOD_NEAR_START and GRASS_LOD_NEAR_END, so a cell can switch
+// to the triangle mesh once its nearest point is past GRASS_LOD_NEAR_END without any visible change.
+#define GRASS_LOD_NEAR_START 10.0f
+#define GRASS_LOD_NEAR_END 25.0f
+// Blades shrink away and clump cards grow in between GRASS_LOD_FAR_START and GRASS_LOD_FAR_END.
+#define GRASS_LOD_FAR_START 70.0f
+#define GRASS_LOD_FAR_END 100.0f
+
+// GrassLodMesh: Triangle strip of one level of detail in the shared mesh buffer, and how many blades one instance covers.
+typedef struct {
+    int first, count;        // Vertex range in the mesh buffer
+    int step;                // Blade records per drawn instance (the card reads every step-th record)
+} GrassLodMesh;
+
+static const GrassLodMesh grassLods[GRASS_LOD_COUNT] = {
+    {0, GRASS_NEAR_VERTICES, 1},
+    {GRASS_NEAR_VERTICES, 3, 1},
+    {GRASS_NEAR_VERTICES + 3, 4, GRASS_CLUMP},
+};
+
+// GPU culling needs geometry shaders (OpenGL 3.2), which Apple's legacy contexts do not have; there the CPU culls.
+#ifdef __APPLE__
+    #define GRASS_GPU_CULL 0
+#else
+    #define GRASS_GPU_CULL 1
+#endif
+// Survivor records each level of detail's GPU cull buffer starts with; the buffer doubles whenever a frame fills it.
+#define GRASS_CULL_CAPACITY 65536
+// Sets of cull buffers and queries used in turn, so a frame can draw the last set while this frame's pass completes.
+#define GRASS_CULL_SETS 2
+
+// GrassCulled: One surviving blade as transform feedback writes it: decoded world position and color variation, and
+// the blade attributes still in [0, 1].
+typedef struct {
+    float position[4];
+    float blade[4];
+} GrassCulled;
+
+// GrassRun: Pending range of instance records of one level of detail, drawn once it can no longer grow.
+typedef struct {
+    int first, count;
+} GrassRun;
+
+// Grass is drawn at full density up to GRASS_FADE_START from the camera and thins out to nothing at GRASS_FADE_END.
+#define GRASS_FADE_START 60.0f
+#define GRASS_FADE_END 180.0f
+// Fraction of the seed range over which a blade shrinks away before it is dropped.
+#define GRASS_FADE_WIDTH 0.1f
+
+// GrassPatch: One uploaded blade instance buffer, kept in a list so every patch is drawn by grassSystemRender.
+struct GrassPatch {
+    GLuint vbo;              // Packed GrassInstance buffer
+    int count;               // Number of blades in the buffer
+    GrassHeader header;      // Decode box and cell table of the uploaded instances
+    unsigned short* seeds;   // Quantized sway seed of every instance (ascending within each cell), for the draw prefixes
+    GrassPatch* next;        // Next patch in the draw list
+};
 
 // OpenGL handles and state for the grass system
-static GLuint grassVBO = 0, grassVAO = 0;
+static GLuint grassVAO = 0;
 static GLuint grassShader = 0;
 static GLuint grassTex = 0;
-static int grassCount = 0;
+static GLuint bladeMesh = 0;            // Shared level of detail shapes: GRASS_MESH_VERTICES (across, up) pairs in [0, 1]
+static GrassPatch* grassPatches = NULL; // Every uploaded patch
+static GrassPatch* homePatch = NULL;    // The patch uploaded by grassSystemUpload
+static GLint positionAttrib = -1;       // Attribute locations of the per-instance blade data
+static GLint bladeAttrib = -1;
+static GLint lodUniform = -1;           // Location of the shader's level of detail selector
+static GLint timeLoc, windStrengthLoc, sunDirLoc, ambientLoc, bladeRangeLoc, eyePosLoc; // Grass shader uniform locations
+static GLint fadeLoc, lodRangeLoc, clumpLoc, grassTexLoc, positionMinLoc, positionRangeLoc;
+static int drawnBlades = 0;             // Blades drawn by the last grassSystemRender (a card counts all it stands for)
+static int drawnVertices = 0;           // Mesh vertices drawn by the last grassSystemRender
+static int gpuCullEnabled = 1;          // Cull on the GPU when the context supports it
+#if GRASS_GPU_CULL
+static GLuint cullShader = 0;                    // Cull program: vertex and geometry shader, captured by transform feedback
+static GLint cullBladeRangeLoc, cullEyePosLoc, cullFadeLoc, cullPlanesLoc; // Cull program uniform locations
+static GLint cullBandLoc, cullPositionMinLoc, cullPositionRangeLoc;
+static int cullUnsupported = 0;                  // Set once the cull program turned out to be unavailable
+static GLuint cullVAO = 0;                       // Vertex array reading patch records as points
+static GLuint cullBuffers[GRASS_CULL_SETS][GRASS_LOD_COUNT]; // Survivor buffer of each level of detail (GrassCulled records)
+static GLuint cullQueries[GRASS_CULL_SETS][GRASS_LOD_COUNT]; // Survivors written to each buffer by its last cull pass
+static int cullCapacity[GRASS_CULL_SETS][GRASS_LOD_COUNT];   // Records each survivor buffer holds
+static int cullValid[GRASS_CULL_SETS];           // The set holds a complete cull pass that may still be drawn
+static int cullSet = 0;                          // Set the latest cull pass wrote
+static int cullIssued = 0;                       // A cull pass was issued this frame and not yet drawn
+#endif
+static int culledOnGpu = 0;                      // The last grassSystemRender drew GPU cull survivors
 
-// randomFloat: Generates a random float between a and b.
+// randomFloat: Generates a random float between a and b from a random stream.
 // Used throughout the grass system to randomize blade positions, sizes, and animation seeds for natural variety.
-static float randomFloat(float a, float b) {
-    // Generate a random float in [a, b] using rand().
-    return a + ((float)rand() / RAND_MAX) * (b - a);
-}
-
-// isValidGrassLocation: Determines if a given (x, z, y) position is suitable for grass placement.
-// Checks for water level and slope, ensuring grass only appears on plausible terrain.
-static int isValidGrassLocation(Landscape* landscape, float x, float z, float y) {
-    // Reject locations below water level (with a small margin).
-    if (y < WATER_LEVEL + 0.2f) return 0;
-    // Convert world coordinates to grid indices for the landscape.
-    float nx = (x / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1);
-    float nz = (z / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1);
-    int ix = (int)nx;
-    int iz = (int)nz;
-    // Clamp indices to valid range to avoid out-of-bounds.
-    if (ix < 0) ix = 0;
-    if (iz < 0) iz = 0;
-    if (ix >= LANDSCAPE_SIZE-1) ix = LANDSCAPE_SIZE-2;
-    if (iz >= LANDSCAPE_SIZE-1) iz = LANDSCAPE_SIZE-2;
-    // Get the normal vector at this location to compute slope.
-    float* normal = &landscape->normals[(iz * LANDSCAPE_SIZE + ix) * 3];
-    // Slope is the angle between the normal and the vertical axis.
-    float slope = acosf(fminf(fmaxf(normal[1], -1.0f), 1.0f));
-    float slopeDeg = slope * (180.0f / M_PI);
-    // Only allow grass on slopes less than or equal to 32 degrees.
-    return slopeDeg <= 32.0f;
-}
-
-// generateGrassBlade: Generates a single grass blade at a random valid location, with randomized geometry and color.
-// Populates the GrassVertex array with the blade's triangle vertices, encoding all per-blade attributes for animation and shading.
-static void generateGrassBlade(Landscape* landscape, float areaSize, GrassVertex* verts, int* bladeIdx) {
-    float clampFactor = 0.98f; // Avoid placing blades at the very edge of the area.
-    float halfScale = areaSize * 0.5f * clampFactor; // Calculate the actual placement radius
-    // Randomly choose a position within the allowed area.
-    float x = randomFloat(-halfScale, halfScale);
-    float z = randomFloat(-halfScale, halfScale);
-    // Query the terrain height at this position.
-    float y = landscapeGetHeight(landscape, x, z);
-    // Only proceed if the location is valid for grass.
-    if (!isValidGrassLocation(landscape, x, z, y)) return;
+static float randomFloat(Rng* rng, float a, float b) {
+    return rngRange(rng, a, b);
+}
+
+// Poisson-disk placement settings.
+#define GRASS_TILE_CELLS 16          // Terrain cells per side of a placement tile
+#define GRASS_POISSON_SPACING 0.6f   // Minimum blade distance as a fraction of the mean spacing sqrt(valid area / blades)
+#define GRASS_POISSON_ATTEMPTS 30    // Darts per blade a tile throws before it stops enforcing the minimum distance
+#define GRASS_POISSON_MAX_GRID 16    // Most background grid cells per blade (sparser grids raise the minimum distance)
+
+// Grass grows on ground at least 0.2 above the water line and no steeper than 32 degrees.
+static const LandscapePlacementRule grassRule = {0.2f, 1e30f, 0.0f, 32.0f * (float)M_PI / 180.0f, 0};
+
+// generateGrassBlade: Generates a single grass blade at a validated location, with randomized geometry and color.
+// The blade's attributes are stored once here and quantized into its instance record by packGrassBlades.
+static void generateGrassBlade(Rng* rng, float x, float y, float z, GrassBlade* blades, int* bladeIdx) {
+    GrassBlade* blade = &blades[(*bladeIdx)++];
+    blade->x = x;
+    blade->y = y;
+    blade->z = z;
     // Randomize per-blade attributes for animation and appearance.
-    float swaySeed = randomFloat(0.0f, 1.0f); // Unique animation phase
-    float bladeHeight = randomFloat(0.7f, 1.5f); // Vary blade height
-    float bladeWidth = randomFloat(0.05f, 0.13f); // Vary blade width
-    float colorVar = randomFloat(-0.08f, 0.08f); // Subtle color variation
-    float rotation = randomFloat(0.0f, 2.0f * (float)M_PI); // Random orientation
-    int colorIndex = rand() % 4; // Discrete color band for extra variety
-    // Each blade is a triangle (3 vertices), with offsets defining its shape.
-    for (int v = 0; v < 3; ++v) {
-        GrassVertex vert = {x, y, z, swaySeed, 0, 0, bladeHeight, bladeWidth, colorVar + colorIndex * 0.25f, rotation}; // Initialize vertex with base values
-        switch (v) {
-            case 0: vert.offsetX = 0; vert.offsetY = 0; break; // Base left
-            case 1: vert.offsetX = bladeWidth; vert.offsetY = 0; break; // Base right
-            case 2: vert.offsetX = bladeWidth/2; vert.offsetY = bladeHeight; break; // Tip
+    blade->swaySeed = randomFloat(rng, 0.0f, 1.0f); // Unique animation phase
+    blade->bladeHeight = randomFloat(rng, 0.7f, 1.5f); // Vary blade height
+    blade->bladeWidth = randomFloat(rng, 0.05f, 0.13f); // Vary blade width
+    float colorVar = randomFloat(rng, -0.08f, 0.08f); // Subtle color variation
+    blade->rotation = randomFloat(rng, 0.0f, 2.0f * (float)M_PI); // Random orientation
+    int colorIndex = rngInt(rng, 4); // Discrete color band for extra variety
+    blade->colorVar = colorVar + colorIndex * 0.25f;
+}
+
+// quantize: Maps v from [min, min + range] onto the full unsigned 16-bit range, rounding to nearest.
+static unsigned short quantize(float v, float min, float range) {
+    float t = range > 0.0f ? (v - min) / range : 0.0f;
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    return (unsigned short)lrintf(t * 65535.0f);
+}
+
+// compareInstances: qsort order of the blades in one cell: by sway seed, then by the rest of the record, so the order
+// is fully determined by the blades themselves.
+static int compareInstances(const void* a, const void* b) {
+    const GrassInstance* x = (const GrassInstance*)a;
+    const GrassInstance* y = (const GrassInstance*)b;
+    if (x->blade[0] != y->blade[0]) return x->blade[0] < y->blade[0] ? -1 : 1;
+    return memcmp(x, y, sizeof(GrassInstance));
+}
+
+// packGrassBlades: Fits the quantization box around the blades and writes one packed instance record per blade,
+// grouped by cell (counting sort on the cell index) and ordered by sway seed within each cell.
+// Returns 0 if the scratch memory could not be allocated.
+static int packGrassBlades(const GrassBlade* blades, int count, GrassHeader* header, GrassInstance* instances) {
+    GrassQuantization* quant = &header->quant;
+    int* cellOf = (int*)malloc(sizeof(int) * (count > 0 ? count : 1)); // Cell index of each blade
+    if (!cellOf) return 0;
+    float lo[4] = {0, 0, 0, 0}, hi[4] = {0, 0, 0, 0};
+    for (int i = 0; i < count; ++i) { // Bounds of x, y, z, and color variation over all blades.
+        float v[4] = {blades[i].x, blades[i].y, blades[i].z, blades[i].colorVar};
+        for (int k = 0; k < 4; ++k) {
+            if (i == 0 || v[k] < lo[k]) lo[k] = v[k];
+            if (i == 0 || v[k] > hi[k]) hi[k] = v[k];
+        }
+    }
+    for (int k = 0; k < 4; ++k) {
+        quant->positionMin[k] = lo[k];
+        quant->positionRange[k] = hi[k] - lo[k];
+    }
+    // Count the blades of each cell, then turn the counts into the first index of each cell.
+    memset(header->cells, 0, sizeof(header->cells));
+    for (int i = 0; i < count; ++i) {
+        int cx = quant->positionRange[0] > 0.0f ? (int)((blades[i].x - lo[0]) / quant->positionRange[0] * GRASS_CELLS) : 0;
+        int cz = quant->positionRange[2] > 0.0f ? (int)((blades[i].z - lo[2]) / quant->positionRange[2] * GRASS_CELLS) : 0;
+        cx = cx < 0 ? 0 : (cx >= GRASS_CELLS ? GRASS_CELLS - 1 : cx);
+        cz = cz < 0 ? 0 : (cz >= GRASS_CELLS ? GRASS_CELLS - 1 : cz);
+        cellOf[i] = cz * GRASS_CELLS + cx;
+        header->cells[cellOf[i]].count++;
+    }
+    int next = 0;
+    for (int c = 0; c < GRASS_CELLS * GRASS_CELLS; ++c) {
+        header->cells[c].first = next;
+        next += header->cells[c].count;
+        header->cells[c].count = 0; // Counted up again as the cell is filled.
+    }
+    for (int i = 0; i < count; ++i) {
+        const GrassBlade* b = &blades[i];
+        GrassCell* cell = &header->cells[cellOf[i]];
+        GrassInstance* inst = &instances[cell->first + cell->count];
+        float v[4] = {b->x, b->y, b->z, b->colorVar};
+        for (int k = 0; k < 4; ++k) {
+            inst->position[k] = quantize(v[k], quant->positionMin[k], quant->positionRange[k]);
+            if (k < 3 && (cell->count == 0 || v[k] < cell->boxMin[k])) cell->boxMin[k] = v[k];
+            if (k < 3 && (cell->count == 0 || v[k] > cell->boxMax[k])) cell->boxMax[k] = v[k];
+        }
+        inst->blade[0] = quantize(b->swaySeed, 0.0f, 1.0f);
+        inst->blade[1] = quantize(b->bladeHeight, 0.0f, GRASS_HEIGHT_RANGE);
+        inst->blade[2] = quantize(b->bladeWidth, 0.0f, GRASS_WIDTH_RANGE);
+        inst->blade[3] = quantize(b->rotation, 0.0f, GRASS_ROTATION_RANGE);
+        cell->count++;
+    }
+    free(cellOf);
+    for (int c = 0; c < GRASS_CELLS * GRASS_CELLS; ++c) {
+        qsort(&instances[header->cells[c].first], header->cells[c].count, sizeof(GrassInstance), compareInstances);
+    }
+    return 1;
+}
+
+// GrassPlacementJob: Shared inputs and outputs of one parallel Poisson-disk grass placement.
+typedef struct {
+    const Landscape* landscape;
+    int rule;                  // Placement rule bit of the grass rule
+    int cellX0, cellZ0;        // First terrain cell of the placement area
+    int cellX1, cellZ1;        // One past the last terrain cell of the placement area
+    int tilesX;                // Placement tiles per row
+    int phase, phaseTilesX;    // Checkerboard phase being placed and its tiles per row
+    float spacing;             // World-space width of a terrain cell
+    float minDistance;         // Poisson-disk distance every dart keeps from the blades already placed
+    float gridSize;            // Width of a background grid cell (at most minDistance / sqrt(2), so one blade per cell)
+    int gridW, gridH;          // Background grid size in cells
+    int blockCells;            // Background grid cells per tile side; the grid is stored as one block per tile
+    const int* tileBlock;      // Offset of each tile's block in grid, or -1 for tiles without valid cells (no storage)
+    int* grid;                 // Index of the blade in each background grid cell, or -1
+    const int* tileFirst;      // First blade of each tile; tile t owns [tileFirst[t], tileFirst[t + 1])
+    unsigned int seed;         // Seed of every tile's random stream
+    float* xs;                 // Blade positions and heights, indexed like the blades
+    float* zs;
+    float* ys;
+    GrassBlade* blades;        // Output blades
+} GrassPlacementJob;
+
+// tileValidCells: Writes the indices (relative to the placement area) of the cells of tile t that accept grass to
+// 'cells' (room for GRASS_TILE_CELLS^2) and returns how many there are.
+static int tileValidCells(const GrassPlacementJob* job, int t, int* cells) {
+    const Landscape* land = job->landscape;
+    int landCells = land->size - 1;
+    int areaW = job->cellX1 - job->cellX0;
+    int x0 = job->cellX0 + (t % job->tilesX) * GRASS_TILE_CELLS, z0 = job->cellZ0 + (t / job->tilesX) * GRASS_TILE_CELLS;
+    int x1 = x0 + GRASS_TILE_CELLS < job->cellX1 ? x0 + GRASS_TILE_CELLS : job->cellX1;
+    int z1 = z0 + GRASS_TILE_CELLS < job->cellZ1 ? z0 + GRASS_TILE_CELLS : job->cellZ1;
+    int n = 0;
+    for (int z = z0; z < z1; z++) {
+        for (int x = x0; x < x1; x++) {
+            if ((land->attributes[z * landCells + x].placement >> job->rule) & 1) {
+                cells[n++] = (z - job->cellZ0) * areaW + (x - job->cellX0);
+            }
         }
-        verts[(*bladeIdx)++] = vert; // Store the vertex in the buffer.
     }
+    return n;
+}
+
+// TileShare: Sort record for the largest-remainder split of the blade count.
+typedef struct {
+    long long remainder;       // Fractional part of the tile's exact share, scaled by the valid cell total
+    int tile;
+} TileShare;
+
+// compareShares: Larger remainders first, ties by tile index, so the split is fully determined.
+static int compareShares(const void* a, const void* b) {
+    const TileShare* x = (const TileShare*)a;
+    const TileShare* y = (const TileShare*)b;
+    if (x->remainder != y->remainder) return x->remainder > y->remainder ? -1 : 1;
+    return x->tile - y->tile;
+}
+
+// assignTileQuotas: Gives each tile floor(numBlades * valid / total) blades and hands the rest out one at a time by
+// largest remainder, so the quotas add up to exactly numBlades. Writes the running totals to tileFirst[0..tiles].
+static int assignTileQuotas(const int* validCells, int tiles, long long total, int numBlades, int* tileFirst) {
+    TileShare* shares = (TileShare*)malloc(sizeof(TileShare) * tiles);
+    if (!shares) return 0;
+    int assigned = 0;
+    for (int t = 0; t < tiles; t++) {
+        long long exact = (long long)numBlades * validCells[t];
+        tileFirst[t] = (int)(exact / total); // Quota for now; turned into running totals below.
+        shares[t].remainder = exact % total;
+        shares[t].tile = t;
+        assigned += tileFirst[t];
+    }
+    qsort(shares, tiles, sizeof(TileShare), compareShares);
+    for (int i = 0; assigned < numBlades; i = (i + 1) % tiles) {
+        if (validCells[shares[i].tile] == 0) continue; // Never give blades to a tile without valid cells.
+        tileFirst[shares[i].tile]++;
+        assigned++;
+    }
+    free(shares);
+    int first = 0;
+    for (int t = 0; t <= tiles; t++) {
+        int quota = t < tiles ? tileFirst[t] : 0;
+        tileFirst[t] = first;
+        first += quota;
+    }
+    return 1;
+}
+
+// gridSlot: Background grid cell (gx, gz) inside the block of its tile, or NULL when the cell lies outside the area or
+// in a tile without valid cells (which never holds a blade).
+static int* gridSlot(const GrassPlacementJob* job, int gx, int gz) {
+    if (gx < 0 || gz < 0 || gx >= job->gridW || gz >= job->gridH) return NULL;
+    int block = job->tileBlock[(gz / job->blockCells) * job->tilesX + gx / job->blockCells];
+    if (block < 0) return NULL;
+    return job->grid + block + (gz % job->blockCells) * job->blockCells + gx % job->blockCells;
+}
+
+// placeGrassTiles: Thread pool callback placing the blades of tiles [begin, end) of the current phase.
+// Each dart lands at a random point of a random valid cell of the tile and is kept if no blade lies within the
+// minimum distance (checked in the 5x5 background grid cells around it, which may belong to finished neighbouring
+// tiles). If the tile runs out of darts before its quota, the remaining blades are placed without the distance test,
+// so the count is always exact. Tile t draws only from stream t of the seed.
+static void placeGrassTiles(int begin, int end, void* userData) {
+    const GrassPlacementJob* job = (const GrassPlacementJob*)userData;
+    int cells[GRASS_TILE_CELLS * GRASS_TILE_CELLS];
+    int areaW = job->cellX1 - job->cellX0;
+    float originX = job->landscape->origin[0] + job->cellX0 * job->spacing; // World position of the area's first cell
+    float originZ = job->landscape->origin[1] + job->cellZ0 * job->spacing;
+    float minDist2 = job->minDistance * job->minDistance;
+    for (int i = begin; i < end; i++) {
+        int t = ((i / job->phaseTilesX) * 2 + (job->phase >> 1)) * job->tilesX + (i % job->phaseTilesX) * 2 + (job->phase & 1);
+        int first = job->tileFirst[t], quota = job->tileFirst[t + 1] - first;
+        if (quota <= 0) continue;
+        int n = tileValidCells(job, t, cells);
+        Rng rng;
+        rngSeed(&rng, job->seed, (unsigned int)t);
+        int placed = 0;
+        for (long long dart = 0; placed < quota && dart < (long long)quota * GRASS_POISSON_ATTEMPTS; dart++) {
+            int c = cells[rngInt(&rng, n)];
+            float x = originX + ((c % areaW) + rngFloat(&rng)) * job->spacing;
+            float z = originZ + ((c / areaW) + rngFloat(&rng)) * job->spacing;
+            int gx = (int)((x - originX) / job->gridSize), gz = (int)((z - originZ) / job->gridSize);
+            int* slot = gridSlot(job, gx, gz);
+            int clear = slot && *slot < 0;
+            for (int nz = gz - 2; clear && nz <= gz + 2; nz++) {
+                for (int nx = gx - 2; clear && nx <= gx + 2; nx++) {
+                    const int* near = gridSlot(job, nx, nz);
+                    int other = near ? *near : -1;
+                    if (other < 0) continue;
+                    float dx = job->xs[other] - x, dz = job->zs[other] - z;
+                    if (dx * dx + dz * dz < minDist2) clear = 0;
+                }
+            }
+            if (!clear) continue;
+            *slot = first + placed;
+            job->xs[first + placed] = x;
+            job->zs[first + placed] = z;
+            placed++;
+        }
+        for (; placed < quota; placed++) { // Out of darts: fill the quota with plain random valid points.
+            int c = cells[rngInt(&rng, n)];
+            job->xs[first + placed] = originX + ((c % areaW) + rngFloat(&rng)) * job->spacing;
+            job->zs[first + placed] = originZ + ((c / areaW) + rngFloat(&rng)) * job->spacing;
+        }
+        landscapeGetHeightBatch(job->landscape, job->xs + first, job->zs + first, quota, job->ys + first);
+        int bladeIdx = first;
+        for (int k = first; k < first + quota; k++) {
+            generateGrassBlade(&rng, job->xs[k], job->ys[k], job->zs[k], job->blades, &bladeIdx);
+        }
+    }
+}
+
+// generateGrassBlades: Generates exactly numBlades grass blades as Poisson-disk blue noise over the terrain cells that
+// pass the grass rule in the terrain attribute map, within the areaSize square centered on the landscape.
+// Tiles are placed in parallel, each from its own random stream of seed, in a fixed phase order, so the same seed
+// always gives the same blades on any number of threads. Returns the number of blades written: numBlades, or 0 when
+// no cell in the area accepts grass.
+static int generateGrassBlades(Landscape* landscape, float areaSize, int numBlades, unsigned int seed, GrassBlade* data) {
+    int rule = landscapeAddPlacementRule(landscape, &grassRule);
+    if (rule < 0 || numBlades <= 0) return 0; // No free placement rule bit: leave the scene without grass.
+    GrassPlacementJob job;
+    memset(&job, 0, sizeof(job));
+    job.landscape = landscape;
+    job.rule = rule;
+    job.seed = seed;
+    job.blades = data;
+    job.spacing = landscape->scale / (landscape->size - 1);
+    // The placement area is every terrain cell whose center lies in the square.
+    int landCells = landscape->size - 1;
+    float half = areaSize * 0.5f;
+    float centerX = landscape->scale * 0.5f, centerZ = landscape->scale * 0.5f; // Relative to the landscape origin
+    job.cellX0 = (int)ceilf((centerX - half) / job.spacing - 0.5f);
+    job.cellZ0 = (int)ceilf((centerZ - half) / job.spacing - 0.5f);
+    job.cellX1 = (int)floorf((centerX + half) / job.spacing - 0.5f) + 1;
+    job.cellZ1 = (int)floorf((centerZ + half) / job.spacing - 0.5f) + 1;
+    if (job.cellX0 < 0) job.cellX0 = 0;
+    if (job.cellZ0 < 0) job.cellZ0 = 0;
+    if (job.cellX1 > landCells) job.cellX1 = landCells;
+    if (job.cellZ1 > landCells) job.cellZ1 = landCells;
+    if (job.cellX1 <= job.cellX0 || job.cellZ1 <= job.cellZ0) return 0;
+    job.tilesX = (job.cellX1 - job.cellX0 + GRASS_TILE_CELLS - 1) / GRASS_TILE_CELLS;
+    int tilesZ = (job.cellZ1 - job.cellZ0 + GRASS_TILE_CELLS - 1) / GRASS_TILE_CELLS;
+    int tiles = job.tilesX * tilesZ;
+    // Count the valid cells of every tile and split the blades between them.
+    int* validCells = (int*)malloc(sizeof(int) * tiles);
+    int* tileFirst = (int*)malloc(sizeof(int) * (tiles + 1));
+    int* cells = (int*)malloc(sizeof(int) * GRASS_TILE_CELLS * GRASS_TILE_CELLS);
+    long long total = 0;
+    for (int t = 0; validCells && cells && t < tiles; t++) {
+        validCells[t] = tileValidCells(&job, t, cells);
+        total += validCells[t];
+    }
+    if (!validCells || !tileFirst || !cells || total == 0 || !assignTileQuotas(validCells, tiles, total, numBlades, tileFirst)) {
+        free(validCells);
+        free(tileFirst);
+        free(cells);
+        return 0; // Out of memory, or no cell accepts grass.
+    }
+    free(cells);
+    job.tileFirst = tileFirst;
+    // Minimum distance from the valid area, with a background grid fine enough to hold one blade per cell. Only tiles
+    // with valid cells get grid storage, so the grid's size (capped at GRASS_POISSON_MAX_GRID cells per blade) follows
+    // the valid area however sparse it is, not its bounding rectangle. The grid cell divides the tile evenly and is at
+    // most a quarter tile, so the +-2 cell neighbourhoods of two tiles of one phase never overlap.
+    int* tileBlock = (int*)malloc(sizeof(int) * tiles);
+    int occupiedTiles = 0;
+    for (int t = 0; tileBlock && t < tiles; t++) {
+        tileBlock[t] = validCells[t] > 0 ? occupiedTiles++ : -1;
+    }
+    free(validCells);
+    float tileSize = GRASS_TILE_CELLS * job.spacing;
+    float validArea = (float)total * job.spacing * job.spacing;
+    float wantedGrid = GRASS_POISSON_SPACING * sqrtf(validArea / numBlades) / sqrtf(2.0f);
+    int blockCells = (int)ceilf(tileSize / wantedGrid);
+    int maxBlockCells = (int)sqrtf((float)GRASS_POISSON_MAX_GRID * numBlades / (occupiedTiles > 0 ? occupiedTiles : 1));
+    if (blockCells > maxBlockCells) blockCells = maxBlockCells;
+    if (blockCells < 4) blockCells = 4;
+    job.blockCells = blockCells;
+    job.gridSize = tileSize / blockCells;
+    job.minDistance = job.gridSize * sqrtf(2.0f);
+    job.gridW = job.tilesX * blockCells;
+    job.gridH = tilesZ * blockCells;
+    size_t gridCells = (size_t)occupiedTiles * blockCells * blockCells;
+    for (int t = 0; tileBlock && t < tiles; t++) {
+        if (tileBlock[t] >= 0) tileBlock[t] *= blockCells * blockCells; // Block index to offset
+    }
+    job.tileBlock = tileBlock;
+    job.grid = (int*)malloc(sizeof(int) * gridCells);
+    job.xs = (float*)malloc(sizeof(float) * 3 * (size_t)numBlades);
+    if (!tileBlock || !job.grid || !job.xs) {
+        free(tileBlock);
+        free(job.grid);
+        free(job.xs);
+        free(tileFirst);
+        return 0;
+    }
+    job.zs = job.xs + numBlades;
+    job.ys = job.zs + numBlades;
+    memset(job.grid, 0xFF, sizeof(int) * gridCells); // Every cell -1 (empty)
+    // Checkerboard phases: tiles whose x and z parity match the phase.
+    for (job.phase = 0; job.phase < 4; job.phase++) {
+        job.phaseTilesX = (job.tilesX - (job.phase & 1) + 1) / 2;
+        int phaseTilesZ = (tilesZ - (job.phase >> 1) + 1) / 2;
+        threadPoolParallelFor(job.phaseTilesX * phaseTilesZ, 1, placeGrassTiles, &job);
+    }
+    free(tileBlock);
+    free(job.grid);
+    free(job.xs);
+    free(tileFirst);
+    return numBlades;
 }
 
-// generateGrassBlades: Generates multiple grass blades by repeatedly calling generateGrassBlade.
-// Fills the vertex buffer with a dense, randomized field of grass for instanced rendering.
-static void generateGrassBlades(Landscape* landscape, float areaSize, int numBlades, GrassVertex* data) {
-    int bladeIdx = 0; // Track the current position in the vertex buffer
-    // Attempt to generate the requested number of blades.
-    for (int i = 0; i < numBlades; ++i) {
-        generateGrassBlade(landscape, areaSize, data, &bladeIdx);
+// glVersionAtLeast: Reports whether the current context's OpenGL version is at least major.minor.
+static int glVersionAtLeast(int major, int minor) {
+    int haveMajor = 0, haveMinor = 0;
+    const char* version = (const char*)glGetString(GL_VERSION);
+    return version && sscanf(version, "%d.%d", &haveMajor, &haveMinor) == 2 &&
+           (haveMajor > major || (haveMajor == major && haveMinor >= minor));
+}
+
+// instancingSupported: Reports whether the current context can draw instanced arrays (OpenGL 3.3 or
+// ARB_instanced_arrays, which Apple's legacy contexts provide).
+static int instancingSupported(void) {
+    static int supported = -1;
+    if (supported < 0) {
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        supported = glVersionAtLeast(3, 3) || (extensions && strstr(extensions, "GL_ARB_instanced_arrays"));
+        if (!supported) fprintf(stderr, "Instanced arrays are not supported; grass is disabled\n");
+    }
+    return supported;
+}
+
+// buildBladeStrip: Writes a blade triangle strip of 'segments' segments narrowing linearly to a single tip vertex and
+// returns the number of vertices written: left and right edge at each segment boundary, then the tip. One segment gives
+// the plain triangle (base left, base right, tip); more segments let the shader's curve bend the blade smoothly.
+static int buildBladeStrip(float (*mesh)[2], int segments) {
+    for (int k = 0; k < segments; ++k) {
+        float up = (float)k / segments;
+        mesh[k * 2][0] = up * 0.5f;            // Left edge moves in towards the center line
+        mesh[k * 2][1] = up;
+        mesh[k * 2 + 1][0] = 1.0f - up * 0.5f; // Right edge likewise
+        mesh[k * 2 + 1][1] = up;
     }
+    mesh[segments * 2][0] = 0.5f; // Tip
+    mesh[segments * 2][1] = 1.0f;
+    return segments * 2 + 1;
 }
 
-// setupGrassGL: Initializes OpenGL buffers, vertex arrays, shaders, and textures for grass rendering.
-// Uploads all blade geometry to the GPU and prepares the system for efficient instanced drawing.
-static void setupGrassGL(GrassVertex* data, int numVerts) {
+// setupGrassGL: Initializes the vertex array, shader, texture, and level of detail meshes shared by every grass patch,
+// on first use. The mesh buffer holds the near strip, the mid triangle, and the far card quad back to back (grassLods).
+static void setupGrassGL(void) {
+    if (grassVAO) return;
 #ifdef __APPLE__
     glGenVertexArraysAPPLE(1, &grassVAO); // Create vertex array object for macOS
     glBindVertexArrayAPPLE(grassVAO); // Bind it for use
@@ -127,79 +643,431 @@ static void setupGrassGL(GrassVertex* data, int numVerts) {
     glGenVertexArrays(1, &grassVAO); // Create vertex array object for other platforms
     glBindVertexArray(grassVAO); // Bind it for use
 #endif
-    // Create and bind the vertex buffer for all grass blades.
-    glGenBuffers(1, &grassVBO); // Generate buffer object
-    glBindBuffer(GL_ARRAY_BUFFER, grassVBO); // Bind as array buffer
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GrassVertex) * numVerts, data, GL_STATIC_DRAW); // Upload vertex data to GPU
     // Load the custom grass shader and texture.
     grassShader = loadShader("shaders/grass.vert", "shaders/grass.frag"); // Load vertex and fragment shaders
+    // Keep the per-vertex mesh attribute at location 0, which some drivers refuse to read per instance.
+    glBindAttribLocation(grassShader, 0, "corner");
+    glLinkProgram(grassShader);
+    positionAttrib = glGetAttribLocation(grassShader, "position");
+    bladeAttrib = glGetAttribLocation(grassShader, "blade");
+    lodUniform = glGetUniformLocation(grassShader, "lod");
+    timeLoc = glGetUniformLocation(grassShader, "time");
+    windStrengthLoc = glGetUniformLocation(grassShader, "windStrength");
+    sunDirLoc = glGetUniformLocation(grassShader, "sunDir");
+    ambientLoc = glGetUniformLocation(grassShader, "ambient");
+    bladeRangeLoc = glGetUniformLocation(grassShader, "bladeRange");
+    eyePosLoc = glGetUniformLocation(grassShader, "eyePos");
+    fadeLoc = glGetUniformLocation(grassShader, "fade");
+    lodRangeLoc = glGetUniformLocation(grassShader, "lodRange");
+    clumpLoc = glGetUniformLocation(grassShader, "clump");
+    grassTexLoc = glGetUniformLocation(grassShader, "grassTex");
+    positionMinLoc = glGetUniformLocation(grassShader, "positionMin");
+    positionRangeLoc = glGetUniformLocation(grassShader, "positionRange");
     grassTex = LoadTexBMP("tex/leaf.bmp"); // Load grass blade texture
-    // Free the CPU-side data after uploading to GPU.
-    free(data); // Release memory since data is now on GPU
+    // Build the level of detail meshes: curved near blade, mid triangle, and the card quad as a strip.
+    float mesh[GRASS_MESH_VERTICES][2];
+    int v = buildBladeStrip(mesh, GRASS_NEAR_SEGMENTS);
+    v += buildBladeStrip(mesh + v, 1);
+    static const float card[4][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+    memcpy(mesh + v, card, sizeof(card));
+    glGenBuffers(1, &bladeMesh);
+    glBindBuffer(GL_ARRAY_BUFFER, bladeMesh);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(mesh), mesh, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, (void*)0); // Stored in the vertex array object
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#ifdef __APPLE__
+    glBindVertexArrayAPPLE(0);
+#else
+    glBindVertexArray(0);
+#endif
+}
+
+// grassSystemGenerate: Generates all blades into a newly allocated packed instance array and reports its size in bytes.
+// The array starts with the GrassHeader (decode box and cell table). The caller owns it; it can be uploaded with grassSystemUpload
+// or grassPatchCreate and stored in the world cache as-is. No GL calls are made, so this may run on any thread.
+void* grassSystemGenerate(Landscape* landscape, float areaSize, int numBlades, unsigned int seed, size_t* outBytes) {
+    *outBytes = 0;
+    // Generate the blades at full precision first, since the quantization box depends on all of them.
+    GrassBlade* blades = (GrassBlade*)malloc(sizeof(GrassBlade) * numBlades);
+    if (!blades) return NULL;
+    int count = generateGrassBlades(landscape, areaSize, numBlades, seed, blades);
+    // Pack the header and one instance record per blade.
+    size_t bytes = sizeof(GrassHeader) + sizeof(GrassInstance) * count;
+    unsigned char* data = (unsigned char*)malloc(bytes);
+    if (data && !packGrassBlades(blades, count, (GrassHeader*)data, (GrassInstance*)(data + sizeof(GrassHeader)))) {
+        free(data);
+        data = NULL;
+    }
+    if (data) *outBytes = bytes;
+    free(blades);
+    return data;
+}
+
+// grassPatchCreate: Uploads a packed blade array produced by grassSystemGenerate as a new patch and adds it to the draw list.
+// The data is only read, so it can point straight into a memory-mapped file. Returns NULL if there is nothing to draw.
+GrassPatch* grassPatchCreate(const void* data, size_t bytes) {
+    if (!data || bytes < sizeof(GrassHeader)) return NULL; // Nothing was generated.
+    GrassPatch* patch = (GrassPatch*)malloc(sizeof(GrassPatch));
+    if (!patch) return NULL;
+    setupGrassGL(); // Initialize the shared OpenGL resources
+    memcpy(&patch->header, data, sizeof(GrassHeader)); // Keep the decode box and cell table for culling and the shader uniforms
+    patch->count = (int)((bytes - sizeof(GrassHeader)) / sizeof(GrassInstance)); // Store the number of blades actually placed
+    const GrassInstance* instances = (const GrassInstance*)((const unsigned char*)data + sizeof(GrassHeader));
+    patch->seeds = (unsigned short*)malloc(sizeof(unsigned short) * (patch->count > 0 ? patch->count : 1));
+    if (!patch->seeds) {
+        free(patch);
+        return NULL;
+    }
+    for (int i = 0; i < patch->count; ++i) patch->seeds[i] = instances[i].blade[0];
+    glGenBuffers(1, &patch->vbo); // Generate buffer object
+    glBindBuffer(GL_ARRAY_BUFFER, patch->vbo); // Bind as array buffer
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GrassInstance) * patch->count, (const unsigned char*)data + sizeof(GrassHeader), GL_STATIC_DRAW); // Upload instance data to GPU
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    patch->next = grassPatches;
+    grassPatches = patch;
+    return patch;
+}
+
+// grassPatchDestroy: Removes a patch from the draw list and frees its instance buffer.
+void grassPatchDestroy(GrassPatch* patch) {
+    if (!patch) return;
+    for (GrassPatch** link = &grassPatches; *link; link = &(*link)->next) {
+        if (*link == patch) {
+            *link = patch->next;
+            break;
+        }
+    }
+    if (patch == homePatch) homePatch = NULL;
+    glDeleteBuffers(1, &patch->vbo);
+    free(patch->seeds);
+    free(patch);
+}
+
+// grassSystemUpload: Uploads a packed blade array as the home terrain's patch, replacing any previous one.
+void grassSystemUpload(const void* data, size_t bytes) {
+    grassPatchDestroy(homePatch);
+    homePatch = grassPatchCreate(data, bytes);
 }
 
 // grassSystemInit: Entry point for creating the grass system.
 // Allocates memory, generates all blades, and sets up OpenGL state for rendering animated grass.
-void grassSystemInit(Landscape* landscape, float areaSize, int numBlades) {
-    grassCount = numBlades; // Store the total number of blades
-    // Allocate space for all blade vertices (3 per blade).
-    GrassVertex* data = (GrassVertex*)malloc(sizeof(GrassVertex) * 3 * numBlades); // Allocate memory for all vertices
-    // Generate all blades and fill the buffer.
-    generateGrassBlades(landscape, areaSize, numBlades, data); // Populate the vertex buffer
-    // Upload to GPU and set up OpenGL state.
-    setupGrassGL(data, grassCount * 3); // Initialize OpenGL resources
-}
-
-// setAttrib: Helper for binding vertex attribute pointers in the shader program.
-// Ensures all per-blade and per-vertex data is correctly mapped for the grass vertex shader.
-static void setAttrib(GLuint shader, const char* name, int size, int stride, int offset) {
-    // Query the attribute location in the shader.
-    GLint loc = glGetAttribLocation(shader, name); // Get attribute location by name
+void grassSystemInit(Landscape* landscape, float areaSize, int numBlades, unsigned int seed) {
+    size_t bytes;
+    void* data = grassSystemGenerate(landscape, areaSize, numBlades, seed, &bytes); // Generate all blades
+    if (!data) return;
+    grassSystemUpload(data, bytes); // Upload to GPU and set up OpenGL state.
+    // Free the CPU-side data after uploading to GPU.
+    free(data); // Release memory since data is now on GPU
+}
+
+// setAttrib: Helper for binding per-instance attribute pointers in the shader program: normalized unsigned 16-bit values
+// from a patch buffer, or floats from a GPU cull survivor buffer. Advances once per drawn instance.
+static void setAttrib(GLint loc, GLenum type, int stride, size_t offset) {
     if (loc >= 0) { // Only set if attribute exists in shader
         // Enable and set the attribute pointer.
         glEnableVertexAttribArray(loc); // Enable this attribute
-        glVertexAttribPointer(loc, size, GL_FLOAT, GL_FALSE, stride, (void*)(size_t)offset); // Set attribute pointer
+        glVertexAttribPointer(loc, 4, type, type != GL_FLOAT, stride, (void*)offset); // Set attribute pointer; 16-bit values read as [0, 1]
+        GRASS_ATTRIB_DIVISOR(loc, 1); // One value per blade instance
+    }
+}
+
+// grassDensity: Sway seed below which blades are drawn at 'distance' from the camera, matching the grass shader:
+// 1 + GRASS_FADE_WIDTH up to GRASS_FADE_START (every blade at full size), falling linearly to 0 at GRASS_FADE_END.
+static float grassDensity(float distance) {
+    if (distance <= GRASS_FADE_START) return 1.0f + GRASS_FADE_WIDTH;
+    if (distance >= GRASS_FADE_END) return 0.0f;
+    return (1.0f + GRASS_FADE_WIDTH) * (1.0f - (distance - GRASS_FADE_START) / (GRASS_FADE_END - GRASS_FADE_START));
+}
+
+// cellPrefix: Number of blades of a cell drawn at 'density', i.e. those whose sway seed is below it, which are exactly
+// a prefix of the cell since it is ordered by seed. Found by binary search over the patch's seeds.
+static int cellPrefix(const GrassPatch* patch, const GrassCell* cell, float density) {
+    if (density > 1.0f) return cell->count; // Every seed is at most 1.
+    const unsigned short* seeds = patch->seeds + cell->first;
+    float limit = density * 65535.0f; // Seeds are read as normalized 16-bit values.
+    int lo = 0, hi = cell->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (seeds[mid] < limit) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// patchVisible: Reports whether any blade of a patch can be seen: its blade box (bases plus the tallest blade) must be
+// at least partly inside the view and nearer than the grass distance.
+static int patchVisible(const ViewFrustum* frustum, const GrassPatch* patch) {
+    const float* lo = patch->header.quant.positionMin;
+    const float* range = patch->header.quant.positionRange;
+    float boxMin[3] = {lo[0] - GRASS_HEIGHT_RANGE, lo[1], lo[2] - GRASS_HEIGHT_RANGE};
+    float boxMax[3] = {lo[0] + range[0] + GRASS_HEIGHT_RANGE, lo[1] + range[1] + GRASS_HEIGHT_RANGE, lo[2] + range[2] + GRASS_HEIGHT_RANGE};
+    return patch->count && viewFrustumTestBox(frustum, boxMin, boxMax) &&
+           viewFrustumBoxDistance(frustum, boxMin, boxMax) < GRASS_FADE_END;
+}
+
+// drawLod: Draws 'instances' instances of one level of detail's mesh from the instance attributes already set up.
+static void drawLod(GrassLod lod, int instances) {
+    const GrassLodMesh* mesh = &grassLods[lod];
+    glUniform1f(lodUniform, (float)lod); // Tells the shader which shape it is bending
+    GRASS_DRAW_INSTANCED(GL_TRIANGLE_STRIP, mesh->first, mesh->count, instances); // Draw the mesh once per instance
+    drawnBlades += instances * mesh->step;
+    drawnVertices += mesh->count * instances;
+}
+
+// drawRun: Draws the blades in records [first, first + count) of the bound patch buffer with the mesh of one level of
+// detail. Instanced draws always start at instance 0, so the attribute pointers are moved to the run's first record
+// instead; clump cards stride over GRASS_CLUMP records, reading the attributes of every GRASS_CLUMP-th blade.
+static void drawRun(GrassLod lod, int first, int count) {
+    if (count <= 0) return;
+    int step = grassLods[lod].step;
+    int stride = (int)sizeof(GrassInstance) * step;
+    size_t offset = (size_t)first * sizeof(GrassInstance);
+    setAttrib(positionAttrib, GL_UNSIGNED_SHORT, stride, offset + offsetof(GrassInstance, position)); // Position and color variation
+    setAttrib(bladeAttrib, GL_UNSIGNED_SHORT, stride, offset + offsetof(GrassInstance, blade)); // Sway seed, height, width, rotation
+    drawLod(lod, (count + step - 1) / step);
+}
+
+// queueRun: Adds records [first, first + count) to the pending run of a level of detail. The run grows if it ends right
+// where the new range starts (the cell before was drawn in full) on a whole card; otherwise it is drawn and restarted.
+static void queueRun(GrassRun* run, GrassLod lod, int first, int count) {
+    if (run->first + run->count == first && run->count % grassLods[lod].step == 0) {
+        run->count += count;
+        return;
+    }
+    drawRun(lod, run->first, run->count);
+    run->first = first;
+    run->count = count;
+}
+
+// drawVisibleCells: CPU culling path. Walks the cells of every patch in view: cells outside the frustum or beyond
+// GRASS_FADE_END are skipped, nearer ones draw the prefix of their blades their distance allows, and cells drawn in full
+// are merged with the cell after them, so a row of nearby cells costs one draw per level of detail.
+// A cell draws near blades while any part of it is within GRASS_LOD_NEAR_END, mid triangles while any part is within
+// GRASS_LOD_FAR_END, and clump cards once any part is beyond GRASS_LOD_FAR_START, so a cell in the far band draws both
+// and the shader cross-fades them per blade.
+static void drawVisibleCells(const ViewFrustum* frustum) {
+    for (const GrassPatch* patch = grassPatches; patch; patch = patch->next) {
+        if (!patchVisible(frustum, patch)) continue;
+        // Pass the decode ranges of the packed instance components.
+        glUniform4fv(positionMinLoc, 1, patch->header.quant.positionMin);
+        glUniform4fv(positionRangeLoc, 1, patch->header.quant.positionRange);
+        glBindBuffer(GL_ARRAY_BUFFER, patch->vbo); // Bind instance buffer; the blade mesh stays bound in the VAO
+        GrassRun runs[GRASS_LOD_COUNT] = {{0, 0}}; // Pending range of records of each level of detail
+        for (int c = 0; c < GRASS_CELLS * GRASS_CELLS; ++c) {
+            const GrassCell* cell = &patch->header.cells[c];
+            if (!cell->count) continue; // Empty cells do not break a run.
+            float cellMin[3] = {cell->boxMin[0] - GRASS_HEIGHT_RANGE, cell->boxMin[1], cell->boxMin[2] - GRASS_HEIGHT_RANGE};
+            float cellMax[3] = {cell->boxMax[0] + GRASS_HEIGHT_RANGE, cell->boxMax[1] + GRASS_HEIGHT_RANGE, cell->boxMax[2] + GRASS_HEIGHT_RANGE};
+            if (!viewFrustumTestBox(frustum, cellMin, cellMax)) continue;
+            // The nearest point of the cell gives the highest density of any blade in it; the shader shrinks the
+            // blades beyond their own density, so the prefix below it holds every blade still visible and no more.
+            float nearest = viewFrustumBoxDistance(frustum, cellMin, cellMax);
+            int n = cellPrefix(patch, cell, grassDensity(nearest));
+            if (n <= 0) continue;
+            if (nearest < GRASS_LOD_FAR_END) {
+                GrassLod lod = nearest < GRASS_LOD_NEAR_END ? GRASS_LOD_NEAR : GRASS_LOD_MID;
+                queueRun(&runs[lod], lod, cell->first, n);
+            }
+            if (viewFrustumBoxFarDistance(frustum, cellMin, cellMax) > GRASS_LOD_FAR_START) {
+                queueRun(&runs[GRASS_LOD_FAR], GRASS_LOD_FAR, cell->first, n);
+            }
+        }
+        for (int lod = 0; lod < GRASS_LOD_COUNT; ++lod) drawRun((GrassLod)lod, runs[lod].first, runs[lod].count);
+    }
+}
+
+#if GRASS_GPU_CULL
+// grassCullBands: Distances each level of detail covers in the GPU cull, matching the shader's geomorph and cross-fade.
+static const float grassCullBands[GRASS_LOD_COUNT][2] = {
+    {0.0f, GRASS_LOD_NEAR_END},
+    {GRASS_LOD_NEAR_END, GRASS_LOD_FAR_END},
+    {GRASS_LOD_FAR_START, GRASS_FADE_END},
+};
+
+// setupGrassCull: Loads the cull program and creates its vertex array, survivor buffers, and queries, on first use.
+// Leaves cullShader at 0 (CPU culling) when the context has no geometry shaders or the program does not link.
+static void setupGrassCull(void) {
+    if (cullShader || cullUnsupported) return;
+    if (!glVersionAtLeast(3, 2)) {
+        fprintf(stderr, "Geometry shaders are not supported; grass is culled on the CPU\n");
+        cullUnsupported = 1;
+        return;
+    }
+    cullShader = loadShaderStages("shaders/grass_cull.vert", "shaders/grass_cull.geom", NULL);
+    // Read the packed records at fixed locations and capture the survivors interleaved, in GrassCulled layout.
+    glBindAttribLocation(cullShader, 0, "position");
+    glBindAttribLocation(cullShader, 1, "blade");
+    const char* varyings[] = {"outPosition", "outBlade"};
+    glTransformFeedbackVaryings(cullShader, 2, varyings, GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(cullShader);
+    GLint linked = 0;
+    glGetProgramiv(cullShader, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        fprintf(stderr, "Grass cull program did not link; grass is culled on the CPU\n");
+        glDeleteProgram(cullShader);
+        cullShader = 0;
+        cullUnsupported = 1;
+        return;
     }
+    cullBladeRangeLoc = glGetUniformLocation(cullShader, "bladeRange");
+    cullEyePosLoc = glGetUniformLocation(cullShader, "eyePos");
+    cullFadeLoc = glGetUniformLocation(cullShader, "fade");
+    cullPlanesLoc = glGetUniformLocation(cullShader, "planes");
+    cullBandLoc = glGetUniformLocation(cullShader, "band");
+    cullPositionMinLoc = glGetUniformLocation(cullShader, "positionMin");
+    cullPositionRangeLoc = glGetUniformLocation(cullShader, "positionRange");
+    glGenVertexArrays(1, &cullVAO);
+    glBindVertexArray(cullVAO);
+    glEnableVertexAttribArray(0); // Pointers are set per patch; one record per point, no divisor
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    glGenBuffers(GRASS_CULL_SETS * GRASS_LOD_COUNT, &cullBuffers[0][0]);
+    glGenQueries(GRASS_CULL_SETS * GRASS_LOD_COUNT, &cullQueries[0][0]);
+    for (int set = 0; set < GRASS_CULL_SETS; ++set) {
+        cullValid[set] = 0;
+        for (int lod = 0; lod < GRASS_LOD_COUNT; ++lod) {
+            cullCapacity[set][lod] = GRASS_CULL_CAPACITY;
+            glBindBuffer(GL_ARRAY_BUFFER, cullBuffers[set][lod]);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(GrassCulled) * cullCapacity[set][lod], NULL, GL_STREAM_COPY);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-// grassSystemRender: Renders all grass blades with animation and lighting.
-// Sets shader uniforms, binds buffers and textures, and issues the draw call for instanced grass.
+// drawCulled: GPU culling path. Draws each level of detail's survivors from the cull pass grassSystemCull issued this
+// frame, with the instance counts its queries report, if the GPU has finished it. Otherwise the previous frame's
+// survivors are drawn instead of waiting for the counts, so the CPU never stalls on the queries (blades at the edge of
+// the view may then lag the camera by a frame); only with no previous pass to fall back on does it wait. A buffer
+// that came back full is doubled before its set is used again (the blades that did not fit are missing for a frame).
+// Returns 0 if no cull pass was issued, so the CPU path draws.
+static int drawCulled(void) {
+    if (!cullIssued) return 0;
+    cullIssued = 0;
+    int set = cullSet;
+    GLuint ready = 1;
+    for (int lod = 0; lod < GRASS_LOD_COUNT && ready; ++lod) {
+        glGetQueryObjectuiv(cullQueries[set][lod], GL_QUERY_RESULT_AVAILABLE, &ready);
+    }
+    int previous = (cullSet + GRASS_CULL_SETS - 1) % GRASS_CULL_SETS;
+    if (!ready && cullValid[previous]) set = previous; // Its queries finished long ago.
+    // The survivors hold decoded world positions.
+    glUniform4f(positionMinLoc, 0.0f, 0.0f, 0.0f, 0.0f);
+    glUniform4f(positionRangeLoc, 1.0f, 1.0f, 1.0f, 1.0f);
+    for (int lod = 0; lod < GRASS_LOD_COUNT; ++lod) {
+        GLuint written = 0;
+        glGetQueryObjectuiv(cullQueries[set][lod], GL_QUERY_RESULT, &written);
+        if (written > 0) {
+            glBindBuffer(GL_ARRAY_BUFFER, cullBuffers[set][lod]);
+            setAttrib(positionAttrib, GL_FLOAT, sizeof(GrassCulled), offsetof(GrassCulled, position));
+            setAttrib(bladeAttrib, GL_FLOAT, sizeof(GrassCulled), offsetof(GrassCulled, blade));
+            drawLod((GrassLod)lod, (int)written);
+        }
+        if ((int)written >= cullCapacity[set][lod]) {
+            cullCapacity[set][lod] *= 2;
+            glBindBuffer(GL_ARRAY_BUFFER, cullBuffers[set][lod]);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(GrassCulled) * cullCapacity[set][lod], NULL, GL_STREAM_COPY);
+            cullValid[set] = 0; // Orphaned; filled again by its next cull pass.
+        }
+    }
+    return 1;
+}
+#else
+// drawCulled: GPU culling needs geometry shaders, which Apple's legacy OpenGL contexts lack; the CPU always culls there.
+static int drawCulled(void) {
+    return 0;
+}
+#endif
+
+// grassSystemCull: Issues the GPU cull pass for this frame; call after the camera is set and the patches are up to
+// date, as early as possible before grassSystemRender so the GPU finishes it before the counts are read.
+// For each level of detail, every blade of every patch in view (every GRASS_CLUMP-th for the cards) runs through the
+// cull program as a point with the rasterizer off; transform feedback packs the blades that pass the distance band,
+// density, and frustum tests into that level's survivor buffer and a query counts them. Does nothing when GPU culling is
+// off or unsupported, leaving the culling to grassSystemRender on the CPU.
+void grassSystemCull(void) {
+#if GRASS_GPU_CULL
+    cullIssued = 0;
+    if (!gpuCullEnabled || !grassPatches || !instancingSupported()) {
+        for (int set = 0; set < GRASS_CULL_SETS; ++set) cullValid[set] = 0; // Stale once culling resumes.
+        return;
+    }
+    setupGrassCull();
+    if (!cullShader) return;
+    cullSet = (cullSet + 1) % GRASS_CULL_SETS; // Leave the last pass intact in case this one is not ready in time.
+    ViewFrustum frustum;
+    viewFrustumExtract(&frustum);
+    glUseProgram(cullShader);
+    glUniform3f(cullBladeRangeLoc, GRASS_HEIGHT_RANGE, GRASS_WIDTH_RANGE, GRASS_ROTATION_RANGE);
+    glUniform3fv(cullEyePosLoc, 1, frustum.eye);
+    glUniform3f(cullFadeLoc, GRASS_FADE_START, GRASS_FADE_END, GRASS_FADE_WIDTH);
+    glUniform4fv(cullPlanesLoc, 6, &frustum.planes[0][0]);
+    glBindVertexArray(cullVAO);
+    glEnable(GL_RASTERIZER_DISCARD); // Only the captured survivors matter
+    for (int lod = 0; lod < GRASS_LOD_COUNT; ++lod) {
+        int step = grassLods[lod].step;
+        glUniform2fv(cullBandLoc, 1, grassCullBands[lod]);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, cullBuffers[cullSet][lod]);
+        glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, cullQueries[cullSet][lod]);
+        glBeginTransformFeedback(GL_POINTS);
+        for (const GrassPatch* patch = grassPatches; patch; patch = patch->next) {
+            if (!patchVisible(&frustum, patch)) continue;
+            glUniform4fv(cullPositionMinLoc, 1, patch->header.quant.positionMin);
+            glUniform4fv(cullPositionRangeLoc, 1, patch->header.quant.positionRange);
+            glBindBuffer(GL_ARRAY_BUFFER, patch->vbo);
+            glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(GrassInstance) * step, (void*)offsetof(GrassInstance, position));
+            glVertexAttribPointer(1, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(GrassInstance) * step, (void*)offsetof(GrassInstance, blade));
+            glDrawArrays(GL_POINTS, 0, (patch->count + step - 1) / step); // Survivors are appended patch after patch
+        }
+        glEndTransformFeedback();
+        glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+    }
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+    cullValid[cullSet] = 1;
+    cullIssued = 1;
+#endif
+}
+
+// grassSystemRender: Renders the visible grass blades with animation and lighting.
+// Sets shader uniforms and binds the texture, then draws the survivors of this frame's GPU cull pass, or culls the
+// cells of every patch on the CPU (drawVisibleCells) when there was none.
 void grassSystemRender(float time, float windStrength, const float sunDir[3], const float ambient[3]) {
+    drawnBlades = 0;
+    drawnVertices = 0;
+    culledOnGpu = 0;
     // Early out if the system is not initialized.
-    if (!grassShader || !grassVBO || !grassVAO) return; // Check if OpenGL resources are ready
+    if (!grassShader || !grassVAO || !grassPatches || !instancingSupported()) return; // Check if OpenGL resources are ready
+    ViewFrustum frustum;
+    viewFrustumExtract(&frustum); // Patches and cells are culled against the current view
     // Use the custom grass shader program.
     glUseProgram(grassShader); // Activate the grass shader
     // Set animation and lighting uniforms for the shader.
-    glUniform1f(glGetUniformLocation(grassShader, "time"), time); // Pass current time for animation
-    glUniform1f(glGetUniformLocation(grassShader, "windStrength"), windStrength); // Pass wind strength
-    glUniform3fv(glGetUniformLocation(grassShader, "sunDir"), 1, sunDir); // Pass sun direction for lighting
-    glUniform3fv(glGetUniformLocation(grassShader, "ambient"), 1, ambient); // Pass ambient light
+    glUniform1f(timeLoc, time); // Pass current time for animation
+    glUniform1f(windStrengthLoc, windStrength); // Pass wind strength
+    glUniform3fv(sunDirLoc, 1, sunDir); // Pass sun direction for lighting
+    glUniform3fv(ambientLoc, 1, ambient); // Pass ambient light
+    glUniform3f(bladeRangeLoc, GRASS_HEIGHT_RANGE, GRASS_WIDTH_RANGE, GRASS_ROTATION_RANGE);
+    glUniform3fv(eyePosLoc, 1, frustum.eye); // Camera position for the distance fade
+    glUniform3f(fadeLoc, GRASS_FADE_START, GRASS_FADE_END, GRASS_FADE_WIDTH);
+    glUniform4f(lodRangeLoc, GRASS_LOD_NEAR_START, GRASS_LOD_NEAR_END, GRASS_LOD_FAR_START, GRASS_LOD_FAR_END);
+    glUniform1f(clumpLoc, (float)GRASS_CLUMP);
     // Bind the grass texture to texture unit 0.
     glActiveTexture(GL_TEXTURE0); // Activate texture unit 0
     glBindTexture(GL_TEXTURE_2D, grassTex); // Bind grass texture
-    glUniform1i(glGetUniformLocation(grassShader, "grassTex"), 0); // Tell shader to use texture unit 0
+    glUniform1i(grassTexLoc, 0); // Tell shader to use texture unit 0
 #ifdef __APPLE__
     glBindVertexArrayAPPLE(grassVAO); // Bind VAO for macOS
 #else
     glBindVertexArray(grassVAO); // Bind VAO for other platforms
 #endif
-    // Bind the vertex buffer and set all attribute pointers.
-    glBindBuffer(GL_ARRAY_BUFFER, grassVBO); // Bind vertex buffer
-    int stride = sizeof(GrassVertex); // Calculate stride between vertices
-    setAttrib(grassShader, "position", 3, stride, 0); // Set position attribute (x, y, z)
-    setAttrib(grassShader, "swaySeed", 1, stride, sizeof(float)*3); // Set sway seed attribute
-    setAttrib(grassShader, "offsetX", 1, stride, sizeof(float)*4); // Set X offset attribute
-    setAttrib(grassShader, "offsetY", 1, stride, sizeof(float)*5); // Set Y offset attribute
-    setAttrib(grassShader, "bladeHeight", 1, stride, sizeof(float)*6); // Set blade height attribute
-    setAttrib(grassShader, "bladeWidth", 1, stride, sizeof(float)*7); // Set blade width attribute
-    setAttrib(grassShader, "colorVar", 1, stride, sizeof(float)*8); // Set color variation attribute
-    setAttrib(grassShader, "rotation", 1, stride, sizeof(float)*9); // Set rotation attribute
-    // Draw all blades as triangles (instanced rendering).
-    glDrawArrays(GL_TRIANGLES, 0, grassCount * 3); // Draw all vertices as triangles
-    // Disable all attribute arrays after drawing.
-    for (int i = 0; i < 8; ++i) glDisableVertexAttribArray(i); // Disable all attributes
+    culledOnGpu = drawCulled();
+    if (!culledOnGpu) drawVisibleCells(&frustum);
     // Unbind resources to clean up state.
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind vertex buffer
+    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind instance buffer
     glBindTexture(GL_TEXTURE_2D, 0); // Unbind texture
 #ifdef __APPLE__
     glBindVertexArrayAPPLE(0); // Unbind VAO for macOS
@@ -209,11 +1077,38 @@ void grassSystemRender(float time, float windStrength, const float sunDir[3], co
     glUseProgram(0); // Deactivate shader program
 }
 
+// grassSystemSetGpuCulling: Switches between GPU culling (where supported) and CPU culling.
+void grassSystemSetGpuCulling(int enabled) {
+    gpuCullEnabled = enabled;
+}
+
+// grassSystemGpuCulling: Reports whether GPU culling is switched on (it still falls back to the CPU where unsupported).
+int grassSystemGpuCulling(void) {
+    return gpuCullEnabled;
+}
+
+// grassSystemCulledOnGpu: Reports whether the last grassSystemRender drew blades culled on the GPU.
+int grassSystemCulledOnGpu(void) {
+    return culledOnGpu;
+}
+
+// grassSystemDrawnBlades: Returns the number of blades drawn by the last grassSystemRender.
+int grassSystemDrawnBlades(void) {
+    return drawnBlades;
+}
+
+// grassSystemDrawnVertices: Returns the number of mesh vertices (over all levels of detail) the last grassSystemRender drew.
+int grassSystemDrawnVertices(void) {
+    return drawnVertices;
+}
+
 // grassSystemCleanup: Releases all OpenGL and CPU resources used by the grass system.
 // Ensures proper cleanup of buffers, textures, and shaders to prevent memory/resource leaks.
 void grassSystemCleanup() {
-    // Delete the vertex buffer if it exists.
-    if (grassVBO) glDeleteBuffers(1, &grassVBO); // Delete vertex buffer object
+    // Delete every patch's instance buffer and the blade mesh.
+    while (grassPatches) grassPatchDestroy(grassPatches);
+    if (bladeMesh) glDeleteBuffers(1, &bladeMesh);
+    bladeMesh = 0;
     // Delete the vertex array object if it exists.
     if (grassVAO) {
 #ifdef __APPLE__
@@ -222,10 +1117,22 @@ void grassSystemCleanup() {
         glDeleteVertexArrays(1, &grassVAO); // Delete VAO for other platforms
 #endif
     }
-    grassVBO = 0; // Reset handle
     grassVAO = 0; // Reset handle
     grassShader = 0; // Reset handle
     // Delete the grass texture if it exists.
     if (grassTex) glDeleteTextures(1, &grassTex); // Delete texture
     grassTex = 0; // Reset handle
+#if GRASS_GPU_CULL
+    // Delete the cull program and its buffers.
+    if (cullShader) {
+        glDeleteProgram(cullShader);
+        glDeleteVertexArrays(1, &cullVAO);
+        glDeleteBuffers(GRASS_CULL_SETS * GRASS_LOD_COUNT, &cullBuffers[0][0]);
+        glDeleteQueries(GRASS_CULL_SETS * GRASS_LOD_COUNT, &cullQueries[0][0]);
+    }
+    cullShader = 0;
+    cullVAO = 0;
+    cullIssued = 0;
+#endif
+    culledOnGpu = 0;
 } 
\ No newline at end of file
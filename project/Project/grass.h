@@ -1,6 +1,19 @@
 #pragma once
 #include "landscape.h"
+#include <stddef.h>
 
-void grassSystemInit(Landscape* landscape, float areaSize, int numBlades);
+typedef struct GrassPatch GrassPatch;
+
+void grassSystemInit(Landscape* landscape, float areaSize, int numBlades, unsigned int seed);
+void* grassSystemGenerate(Landscape* landscape, float areaSize, int numBlades, unsigned int seed, size_t* outBytes);
+void grassSystemUpload(const void* data, size_t bytes);
+GrassPatch* grassPatchCreate(const void* data, size_t bytes);
+void grassPatchDestroy(GrassPatch* patch);
+void grassSystemCull(void);
 void grassSystemRender(float time, float windStrength, const float sunDir[3], const float ambient[3]);
+int grassSystemDrawnBlades(void);
+int grassSystemDrawnVertices(void);
+void grassSystemSetGpuCulling(int enabled);
+int grassSystemGpuCulling(void);
+int grassSystemCulledOnGpu(void);
 void grassSystemCleanup(); 
\ No newline at end of file
@@ -5,9 +5,28 @@
  * It is responsible for generating, storing, and providing access to the terrain heightmap, normals, and related data.
  *
  * Key Concepts:
- * - Procedural generation: Uses noise functions and algorithms to create a realistic, varied terrain heightmap.
+ * - Procedural generation: Uses noise functions and algorithms to create a realistic, varied terrain heightmap,
+ *   optionally weathered by hydraulic and thermal erosion (erosion.c).
  * - Heightmap: Stores the elevation of the terrain at each grid point, used for rendering, object placement, and collision.
  * - Normals: Computes surface normals for each grid cell, enabling correct lighting and slope calculations.
+ * - Level of detail: The grid is split into chunks held in a quadtree; visible chunks are drawn with coarser index
+ *   buffers as they get further away, and edges next to coarser chunks are stitched so no cracks appear.
+ * - Vertex format: The GPU keeps 8 bytes per vertex, a height and an octahedral 16-bit normal; x and z come from a
+ *   grid coordinate stream covering one chunk's rows that every chunk shares.
+ * - Index ordering: Index buffers walk the grid in narrow vertical bands so shared vertices stay in the post-transform
+ *   cache, and can be emitted as primitive-restart triangle strips.
+ * - Materials: The terrain shader blends grass, rock, sand, and snow per pixel from height, slope, and a weather
+ *   uniform, mixing in the rock and sand textures.
+ * - Editing: Brush edits refresh normals, bounds, and GPU vertex rows only around the touched rectangle.
+ * - Attribute map: Each grid cell gets a packed record (height above water, slope, material class, placement rule
+ *   bits) built once, so object placement is a table lookup instead of per-sample height, normal, and acos math.
+ * - Shadows: Horizon angles in eight directions are traced once per vertex and handed to the terrain shader, which
+ *   looks up the visibility of the light and an ambient occlusion term per vertex, so a moving sun costs no CPU work.
+ *   An edit retraces the horizons next to it at once and the rest of its reach a few rows per frame.
+ * - Ray casting: A min/max height pyramid over the grid cells lets rays skip whole regions they pass above.
+ * - Tiles: Landscapes carry a global grid offset, so neighbouring tiles continue the same noise and share their
+ *   border vertices and normals; tiles are built off the GL thread and uploaded later (terrain_stream.c).
+ * - Water: A static grid uploaded once; waves and the time-of-day color are computed in the water vertex shader.
  * - Integration: The landscape system is used by rendering, object placement, and physics modules to query terrain properties.
  *
  * This file is ideal for demoing procedural terrain generation, heightmap manipulation, and the integration of terrain data in a real-time graphics project.
@@ -15,9 +34,22 @@
 
 #include "CSCIx229.h"
 #include "landscape.h"
+#include "threadpool.h"
+#include "frustum.h"
+#include "shaders.h"
+#include "erosion.h"
+#include <stddef.h>
 
 #define HEIGHTMAP_OFFSET_X 53.0f
 #define HEIGHTMAP_OFFSET_Z 77.0f
+// Grid resolution the noise domain was designed for; other resolutions resample the same terrain.
+#define HEIGHTMAP_NOISE_SIZE 128
+// Primitive restart (OpenGL 3.1) lets terrain strips be drawn in one call; without it the terrain falls back to lists.
+#if defined(GL_PRIMITIVE_RESTART) && !defined(__APPLE__)
+#define LANDSCAPE_HAVE_RESTART
+#endif
+// Water grid quads per side; the grid is uploaded once and animated in the water shader.
+#define WATER_SEGMENTS 256
 
 // --- BEGIN DETAILED COMMENTARY FOR landscape.c ---
 
@@ -57,12 +89,12 @@ static float smoothHash2D(float x, float y) {
 // interpolatedHash2D: Computes a smoothly interpolated noise value at any (x, y) position.
 // Enables continuous, non-repetitive terrain by blending smoothHash2D values across the grid.
 static float interpolatedHash2D(float x, float y) {
-    // Integer part of x (grid cell coordinate).
-    int ix = (int)x;
+    // Integer part of x (grid cell coordinate), rounded down so coordinates below zero stay continuous.
+    int ix = (int)floorf(x);
     // Fractional part of x (distance within cell).
     float fx = x - ix;
     // Integer part of y (grid cell coordinate).
-    int iy = (int)y;
+    int iy = (int)floorf(y);
     // Fractional part of y (distance within cell).
     float fy = y - iy;
     // Value at (ix, iy)
@@ -81,91 +113,201 @@ static float interpolatedHash2D(float x, float y) {
     return lerp_f(i1, i2, fy);
 }
 
-// cubicStep: Performs cubic Hermite interpolation (smoothstep) between two values.
-// Used for smooth transitions in color and water shading, avoiding harsh edges.
-static float cubicStep(float a, float b, float x) {
-    // Normalize x to [0, 1] between a and b.
-    float t = (x - a) / (b - a);
-    // Clamp t to [0, 1].
-    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
-    // Cubic Hermite interpolation (smoothstep).
-    return t * t * (3.0f - 2.0f * t);
+// Controls how much each octave contributes to the final noise (lower = smoother terrain).
+#define HEIGHTMAP_PERSISTENCE 0.47f
+// Number of noise octaves to sum for fractal detail.
+#define HEIGHTMAP_OCTAVES 4
+// Number of heightmap rows a worker thread claims at a time.
+#define HEIGHTMAP_ROW_GRAIN 4
+
+// gridNoiseStep: Noise units per grid step. Every resolution spans the same noise per terrain width, so tiles of any
+// resolution sample the same hills (the step is exactly 1 at the default size).
+static float gridNoiseStep(const Landscape* land) {
+    return (HEIGHTMAP_NOISE_SIZE - 1.0f) / (land->size - 1);
 }
 
-// getLandColors: Defines the canonical RGB colors for different terrain materials (grass, rock, sand, snow).
-// Centralizes color definitions for consistent rendering and easy adjustment.
-void getLandColors(float* grass, float* lightRock, float* darkRock, float* sand, float* snow) {
-    // Assign RGB values for each terrain material type.
-    grass[0] = 0.14f; grass[1] = 0.44f; grass[2] = 0.15f;
-    lightRock[0] = 0.52f; lightRock[1] = 0.47f; lightRock[2] = 0.41f;
-    darkRock[0] = 0.23f; darkRock[1] = 0.21f; darkRock[2] = 0.19f;
-    sand[0] = 0.74f; sand[1] = 0.67f; sand[2] = 0.49f;
-    snow[0] = 0.96f; snow[1] = 0.96f; snow[2] = 0.96f;
+// shapeHeight: Normalizes a texel's octave sum and applies the east-west valley slope.
+// Shared by the scalar and SIMD row generators so both produce bit-identical heights. x is the global grid column in
+// noise units (see gridNoiseStep); beyond the home terrain the slope keeps the value it has at the nearest edge.
+static float shapeHeight(const Landscape* land, float x, float sum, float maxAmp) {
+    // Normalize the sum so the result stays in a reasonable range.
+    sum = sum / maxAmp;
+    // Normalize x to [-1, 1] for east-west slope.
+    float xNorm = (x / HEIGHTMAP_NOISE_SIZE - 0.5f) * 2.0f;
+    xNorm = xNorm < -1.0f ? -1.0f : (xNorm > 1.0f ? 1.0f : xNorm);
+    if(xNorm > 0) {
+        // Add a slope to the east side of the map for realism.
+        float hMult = 1.0f + xNorm * 1.3f;
+        // Apply the slope multiplier.
+        sum *= hMult;
+    } else {
+        // Lower the west side for valley effect.
+        sum *= 0.6f;
+    }
+    // Scale to world units.
+    return sum * land->height * 1.18f;
 }
 
-// buildHeightField: Generates the procedural heightmap for the landscape using fractal noise.
-// This is the heart of terrain generation, combining multiple octaves of noise and applying a slope for realism.
-static void buildHeightField(Landscape* land) {
-    // Controls how much each octave contributes to the final noise (lower = smoother terrain).
-    float persistence = 0.47f;
-    // Number of noise octaves to sum for fractal detail.
-    int octs = 4;
-    // Loop over every row in the heightmap grid.
-    for (int z = 0; z < LANDSCAPE_SIZE; z++) {
-        // Loop over every column in the heightmap grid.
-        for (int x = 0; x < LANDSCAPE_SIZE; x++) {
-            float sum = 0, freq = 1.0f, amp = 1.0f, maxAmp = 0; // Initialize noise sum, frequency, amplitude, and normalization factor.
-            for(int o = 0; o < octs; o++) { // For each octave...
-                // Offset and scale the coordinates for this octave's frequency.
-                float xf = ((float)x + HEIGHTMAP_OFFSET_X) * freq / LANDSCAPE_SIZE * 7.0f;
-                float zf = ((float)z + HEIGHTMAP_OFFSET_Z) * freq / LANDSCAPE_SIZE * 7.0f;
-                // Add the noise value for this octave, scaled by amplitude.
-                sum += interpolatedHash2D(xf, zf) * amp;
-                // Track the total amplitude for normalization.
-                maxAmp += amp;
-                // Reduce amplitude for the next octave.
-                amp *= persistence;
-                // Increase frequency for the next octave (higher detail).
-                freq *= 2.0f;
+// noiseHeight: Returns the generated height of grid vertex (x, z) of this landscape, which may lie outside its grid.
+// This is the reference generator. Noise coordinates follow from the global grid coordinate (the landscape's gridX and
+// gridZ plus the local one), so neighbouring tiles produce bit-identical heights along the border they share.
+static float noiseHeight(const Landscape* land, int x, int z) {
+    float noiseStep = gridNoiseStep(land);
+    int gx = x + land->gridX, gz = z + land->gridZ;
+    float sum = 0, freq = 1.0f, amp = 1.0f, maxAmp = 0; // Initialize noise sum, frequency, amplitude, and normalization factor.
+    for(int o = 0; o < HEIGHTMAP_OCTAVES; o++) { // For each octave...
+        // Offset and scale the coordinates for this octave's frequency.
+        float xf = ((float)gx * noiseStep + HEIGHTMAP_OFFSET_X) * freq / HEIGHTMAP_NOISE_SIZE * 7.0f;
+        float zf = ((float)gz * noiseStep + HEIGHTMAP_OFFSET_Z) * freq / HEIGHTMAP_NOISE_SIZE * 7.0f;
+        // Add the noise value for this octave, scaled by amplitude.
+        sum += interpolatedHash2D(xf, zf) * amp;
+        // Track the total amplitude for normalization.
+        maxAmp += amp;
+        // Reduce amplitude for the next octave.
+        amp *= HEIGHTMAP_PERSISTENCE;
+        // Increase frequency for the next octave (higher detail).
+        freq *= 2.0f;
+    }
+    return shapeHeight(land, (float)gx * noiseStep, sum, maxAmp);
+}
+
+// buildHeightRowScalar: Generates heights for one row of the heightmap, starting at column xBegin.
+// The SIMD path hands it any leftover columns at the end of a row.
+static void buildHeightRowScalar(Landscape* land, int z, int xBegin) {
+    // Loop over the remaining columns in this row, storing each height in the elevation data.
+    for (int x = xBegin; x < land->size; x++) land->elevationData[z * land->size + x] = noiseHeight(land, x, z);
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LANDSCAPE_HAVE_AVX2 1
+#include <immintrin.h>
+
+// hash2D8: AVX2 version of hash2D for eight x coordinates on the same row y.
+// Uses the same wrapping 32-bit integer math and float conversion as the scalar hash, lane for lane.
+__attribute__((target("avx2")))
+static inline __m256 hash2D8(__m256i x, int y) {
+    __m256i m = _mm256_add_epi32(x, _mm256_set1_epi32(y * 71)); // x + y * 71
+    m = _mm256_xor_si256(_mm256_slli_epi32(m, 13), m);         // (m << 13) ^ m
+    __m256i t = _mm256_mullo_epi32(m, m);                       // m * m
+    t = _mm256_add_epi32(_mm256_mullo_epi32(t, _mm256_set1_epi32(15731)), _mm256_set1_epi32(789221));
+    t = _mm256_add_epi32(_mm256_mullo_epi32(m, t), _mm256_set1_epi32(1376312589));
+    t = _mm256_and_si256(t, _mm256_set1_epi32(0x7fffffff));
+    __m256 f = _mm256_div_ps(_mm256_cvtepi32_ps(t), _mm256_set1_ps(1073741824.0f));
+    return _mm256_sub_ps(_mm256_set1_ps(1.0f), f);
+}
+
+// smoothHash8: AVX2 version of smoothHash2D built from a precomputed 4x4 block of hashes.
+// h[i][j] holds hash2D(ix + i - 1, iy + j - 1); (cx, cy) selects the center of the 3x3 kernel.
+// The additions happen in exactly the order the scalar function performs them.
+__attribute__((target("avx2")))
+static inline __m256 smoothHash8(__m256 h[4][4], int cx, int cy) {
+    __m256 c = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(h[cx-1][cy-1], h[cx+1][cy-1]), h[cx-1][cy+1]), h[cx+1][cy+1]);
+    c = _mm256_div_ps(c, _mm256_set1_ps(16.0f)); // Diagonal neighbors, less weight.
+    __m256 s = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(h[cx-1][cy], h[cx+1][cy]), h[cx][cy-1]), h[cx][cy+1]);
+    s = _mm256_div_ps(s, _mm256_set1_ps(8.0f));  // Adjacent neighbors, medium weight.
+    __m256 ctr = _mm256_div_ps(h[cx][cy], _mm256_set1_ps(4.0f)); // Center point, highest weight.
+    return _mm256_add_ps(_mm256_add_ps(c, s), ctr);
+}
+
+// buildHeightRowAVX2: Generates one heightmap row eight texels at a time.
+// The 16 hashes shared by the four smoothHash2D lookups of each lane are evaluated in AVX2 lanes;
+// the cosine lerps reuse the scalar lerp_f so results match the reference generator exactly.
+// Returns the first column that was not processed (the scalar generator finishes the row).
+__attribute__((target("avx2")))
+static int buildHeightRowAVX2(Landscape* land, int z) {
+    int x0;
+    float noiseStep = gridNoiseStep(land); // Same grid-to-noise step as the scalar path.
+    for (x0 = 0; x0 + 8 <= land->size; x0 += 8) {
+        float sum[8] = {0}, freq = 1.0f, amp = 1.0f, maxAmp = 0; // Per-lane noise sums and shared octave state.
+        __m256 xs = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x0 + land->gridX), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+        for (int o = 0; o < HEIGHTMAP_OCTAVES; o++) {
+            // Same coordinate math as the scalar path, one lane per column.
+            __m256 xf = _mm256_add_ps(_mm256_mul_ps(xs, _mm256_set1_ps(noiseStep)), _mm256_set1_ps(HEIGHTMAP_OFFSET_X));
+            xf = _mm256_mul_ps(_mm256_div_ps(_mm256_mul_ps(xf, _mm256_set1_ps(freq)), _mm256_set1_ps((float)HEIGHTMAP_NOISE_SIZE)), _mm256_set1_ps(7.0f));
+            float zf = ((float)(z + land->gridZ) * noiseStep + HEIGHTMAP_OFFSET_Z) * freq / HEIGHTMAP_NOISE_SIZE * 7.0f; // The row coordinate is shared by all lanes.
+            __m256i ix = _mm256_cvttps_epi32(_mm256_floor_ps(xf)); // Integer cell coordinate (rounded down, like the scalar path).
+            __m256 fx = _mm256_sub_ps(xf, _mm256_cvtepi32_ps(ix)); // Fractional position inside the cell.
+            int iy = (int)floorf(zf);
+            float fy = zf - iy;
+            // Evaluate the 4x4 block of hashes around each lane's cell once.
+            __m256 h[4][4];
+            for (int i = 0; i < 4; i++) {
+                __m256i hx = _mm256_add_epi32(ix, _mm256_set1_epi32(i - 1));
+                for (int j = 0; j < 4; j++) h[i][j] = hash2D8(hx, iy + j - 1);
             }
-            // Normalize the sum so the result stays in a reasonable range.
-            sum = sum / maxAmp;
-            // Normalize x to [-1, 1] for east-west slope.
-            float xNorm = ((float)x / LANDSCAPE_SIZE - 0.5f) * 2.0f;
-            if(xNorm > 0) {
-                // Add a slope to the east side of the map for realism.
-                float hMult = 1.0f + xNorm * 1.3f;
-                // Apply the slope multiplier.
-                sum *= hMult;
-            } else {
-                // Lower the west side for valley effect.
-                sum *= 0.6f;
+            float v1[8], v2[8], v3[8], v4[8], fxs[8];
+            _mm256_storeu_ps(v1, smoothHash8(h, 1, 1)); // Value at (ix, iy)
+            _mm256_storeu_ps(v2, smoothHash8(h, 2, 1)); // Value at (ix+1, iy)
+            _mm256_storeu_ps(v3, smoothHash8(h, 1, 2)); // Value at (ix, iy+1)
+            _mm256_storeu_ps(v4, smoothHash8(h, 2, 2)); // Value at (ix+1, iy+1)
+            _mm256_storeu_ps(fxs, fx);
+            for (int l = 0; l < 8; l++) {
+                float i1 = lerp_f(v1[l], v2[l], fxs[l]); // Interpolate along x for the bottom edge.
+                float i2 = lerp_f(v3[l], v4[l], fxs[l]); // Interpolate along x for the top edge.
+                sum[l] += lerp_f(i1, i2, fy) * amp;      // Interpolate along y and accumulate the octave.
             }
-            // Store the final height value in the elevation data.
-            land->elevationData[z * LANDSCAPE_SIZE + x] = sum * LANDSCAPE_HEIGHT * 1.18f;
+            maxAmp += amp;
+            amp *= HEIGHTMAP_PERSISTENCE;
+            freq *= 2.0f;
+        }
+        for (int l = 0; l < 8; l++) {
+            land->elevationData[z * land->size + x0 + l] = shapeHeight(land, (float)(x0 + l + land->gridX) * noiseStep, sum[l], maxAmp);
         }
     }
+    return x0;
+}
+#endif
+
+// useAVX2: Whether the running CPU supports the AVX2 row generator (checked once at first use).
+static int useAVX2 = -1;
+
+// buildHeightRows: Thread pool callback that generates heightmap rows [begin, end).
+static void buildHeightRows(int begin, int end, void* userData) {
+    Landscape* land = (Landscape*)userData;
+    for (int z = begin; z < end; z++) {
+        int x = 0;
+#ifdef LANDSCAPE_HAVE_AVX2
+        if (useAVX2) x = buildHeightRowAVX2(land, z); // Vectorized bulk of the row.
+#endif
+        buildHeightRowScalar(land, z, x); // Scalar remainder (or the whole row without AVX2).
+    }
 }
 
-// computeNormals: Calculates per-vertex normals for the terrain mesh based on triangle geometry.
-// Essential for correct lighting, shading, and slope-based effects in the terrain rendering pipeline.
-static void computeNormals(Landscape* land) {
+// buildHeightField: Generates the procedural heightmap for the landscape using fractal noise.
+// This is the heart of terrain generation, combining multiple octaves of noise and applying a slope for realism.
+// Rows are independent, so they are split across the thread pool; output is identical for any thread count.
+static void buildHeightField(Landscape* land) {
+    if (useAVX2 < 0) {
+#ifdef LANDSCAPE_HAVE_AVX2
+        __builtin_cpu_init();
+        useAVX2 = __builtin_cpu_supports("avx2") ? 1 : 0; // Pick the vector path only on CPUs that have it.
+#else
+        useAVX2 = 0;
+#endif
+    }
+    threadPoolParallelFor(land->size, HEIGHTMAP_ROW_GRAIN, buildHeightRows, land);
+}
+
+// landscapeComputeMeshNormals: Calculates per-vertex normals for an arbitrary indexed triangle mesh.
+// Face normals are scattered into every vertex they touch, so this works for any topology but runs serially.
+// The terrain grid uses the faster gather-based landscapeCalculateNormals instead.
+void landscapeComputeMeshNormals(const float* vertices, int vertexCount, const unsigned int* indices, int indexCount, float* normals) {
     // Zero out the normals array before accumulating face normals.
-    memset(land->normals, 0, land->vertexCount * 3 * sizeof(float));
+    memset(normals, 0, vertexCount * 3 * sizeof(float));
     // Loop over every triangle in the mesh (each set of 3 indices forms a triangle).
-    for (int i = 0; i < land->indexCount; i += 3) {
+    for (int i = 0; i < indexCount; i += 3) {
         // Index of the first vertex of the triangle.
-        unsigned int i1 = land->indices[i];
+        unsigned int i1 = indices[i];
         // Index of the second vertex.
-        unsigned int i2 = land->indices[i+1];
+        unsigned int i2 = indices[i+1];
         // Index of the third vertex.
-        unsigned int i3 = land->indices[i+2];
+        unsigned int i3 = indices[i+2];
         // Pointer to the first vertex's position (x, y, z).
-        float* v1 = &land->vertices[i1*3];
+        const float* v1 = &vertices[i1*3];
         // Pointer to the second vertex's position.
-        float* v2 = &land->vertices[i2*3];
+        const float* v2 = &vertices[i2*3];
         // Pointer to the third vertex's position.
-        float* v3 = &land->vertices[i3*3];
+        const float* v3 = &vertices[i3*3];
         // Compute two edge vectors of the triangle: u = v2 - v1, v = v3 - v1.
         float ux = v2[0] - v1[0];
         float uy = v2[1] - v1[1];
@@ -178,19 +320,19 @@ static void computeNormals(Landscape* land) {
         float ny = uz*vx - ux*vz;
         float nz = ux*vy - uy*vx;
         // Add the face normal to each vertex normal (accumulating for smooth shading).
-        land->normals[i1*3 + 0] += nx;
-        land->normals[i1*3 + 1] += ny;
-        land->normals[i1*3 + 2] += nz;
-        land->normals[i2*3 + 0] += nx;
-        land->normals[i2*3 + 1] += ny;
-        land->normals[i2*3 + 2] += nz;
-        land->normals[i3*3 + 0] += nx;
-        land->normals[i3*3 + 1] += ny;
-        land->normals[i3*3 + 2] += nz;
+        normals[i1*3 + 0] += nx;
+        normals[i1*3 + 1] += ny;
+        normals[i1*3 + 2] += nz;
+        normals[i2*3 + 0] += nx;
+        normals[i2*3 + 1] += ny;
+        normals[i2*3 + 2] += nz;
+        normals[i3*3 + 0] += nx;
+        normals[i3*3 + 1] += ny;
+        normals[i3*3 + 2] += nz;
     }
     // Normalize all vertex normals to unit length for correct lighting.
-    for (int i = 0; i < land->vertexCount; i++) {
-        float* n = &land->normals[i*3];
+    for (int i = 0; i < vertexCount; i++) {
+        float* n = &normals[i*3];
         // Compute the length of the normal vector.
         float len = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
         if (len > 0) {
@@ -202,189 +344,872 @@ static void computeNormals(Landscape* land) {
     }
 }
 
-// landscapeRender: Renders the terrain mesh with color blending based on slope, height, and weather.
-// Integrates procedural color logic, lighting, and OpenGL drawing to visualize the generated landscape.
-void landscapeRender(Landscape* land, int weatherType) {
-    if (!land) return; // If the landscape pointer is null, do nothing.
-    float noSpec[] = {0.0f, 0.0f, 0.0f, 1.0f}; // No specular reflection for terrain (matte look).
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, noSpec); // Set the material's specular property for all faces.
-    glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, 1.0f);   // Set the material's shininess (low for rough terrain).
-    float grass[3], lightRock[3], darkRock[3], sand[3], snow[3]; // Arrays to hold the base colors for different terrain types.
-    getLandColors(grass, lightRock, darkRock, sand, snow); // Fill the color arrays with predefined values.
-    glBegin(GL_TRIANGLES); // Begin drawing triangles for the terrain mesh.
-    for(int i = 0; i < land->indexCount; i++) { // Loop over every index in the mesh.
-        int idx = land->indices[i]; // Get the vertex index for this triangle corner.
-        float h = land->vertices[idx * 3 + 1]; // Get the height (y) of this vertex.
-        float normY = land->normals[idx * 3 + 1]; // Get the y-component of the normal (used for slope).
-        float color[3]; // Array to hold the final color for this vertex.
-        if (weatherType == 1) { // If it's winter weather...
-            float slope = 1.0f - normY; // Slope is higher when the normal is less vertical.
-            float rockFac = (slope - 0.19f) / 0.41f; // Blend factor for snow vs. rock based on slope.
-            rockFac = fmax(0.0f, fmin(1.0f, rockFac)); // Clamp blend factor to [0, 1].
-            for(int c = 0; c < 3; c++) {
-                color[c] = snow[c] * (1.0f - rockFac) + darkRock[c] * rockFac; // Blend snow and rock colors.
+// Number of rows a worker thread claims at a time when computing grid normals.
+#define NORMAL_ROW_GRAIN 16
+
+// gridSpacing: World-space distance between neighbouring grid vertices; the grid spans exactly scale from vertex 0 to
+// vertex size - 1, so adjacent tiles of the same scale share their border vertices.
+static float gridSpacing(const Landscape* land) {
+    return land->scale / (land->size - 1);
+}
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define LANDSCAPE_HAVE_SSE 1
+#include <emmintrin.h>
+#endif
+
+// computeNormalSpan: Computes the normals of columns [xBegin, xEnd) of one grid row from central differences of the heightmap.
+// Each normal is (-dh/dx, 1, -dh/dz) normalized; border vertices fall back to one-sided differences.
+// Only reads elevationData and writes this span's normals, so spans can be processed in any order on any thread.
+static void computeNormalSpan(Landscape* land, int z, int xBegin, int xEnd) {
+    int size = land->size;
+    float spacing = gridSpacing(land);                  // World-space distance between neighbouring vertices.
+    const float* row = &land->elevationData[z * size];  // Heights of this row.
+    const float* up = z > 0 ? row - size : row;         // Row above (clamped at the border).
+    const float* down = z < size - 1 ? row + size : row; // Row below (clamped at the border).
+    float invDz = 1.0f / (spacing * (z > 0 && z < size - 1 ? 2.0f : 1.0f)); // Central or one-sided z difference.
+    float invDx = 1.0f / (spacing * 2.0f);
+    float* out = &land->normals[z * size * 3];
+    int simdBegin = xBegin > 1 ? xBegin : 1;   // The SIMD loop only handles interior columns.
+    int simdEnd = xEnd < size - 1 ? xEnd : size - 1;
+    int x = simdBegin;
+#ifdef LANDSCAPE_HAVE_SSE
+    // Interior columns four at a time: the gradient and normalization run in SSE lanes.
+    __m128 vInvDx = _mm_set1_ps(invDx), vInvDz = _mm_set1_ps(invDz), one = _mm_set1_ps(1.0f);
+    for (; x + 4 <= simdEnd; x += 4) {
+        __m128 gx = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(row + x + 1), _mm_loadu_ps(row + x - 1)), vInvDx); // dh/dx
+        __m128 gz = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(down + x), _mm_loadu_ps(up + x)), vInvDz);         // dh/dz
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, gx), one), _mm_mul_ps(gz, gz));
+        __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(len2)); // Exact 1/length, matching the scalar path.
+        float nx[4], ny[4], nz[4];
+        _mm_storeu_ps(nx, _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), gx), inv));
+        _mm_storeu_ps(ny, inv);
+        _mm_storeu_ps(nz, _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), gz), inv));
+        for (int l = 0; l < 4; l++) { // Interleave into the packed xyz normal array.
+            out[(x + l) * 3 + 0] = nx[l];
+            out[(x + l) * 3 + 1] = ny[l];
+            out[(x + l) * 3 + 2] = nz[l];
+        }
+    }
+#endif
+    // Scalar pass for the border columns and any columns the SIMD loop left over.
+    for (int c = xBegin; c < xEnd; c++) {
+        if (c >= simdBegin && c < x) continue; // Already done by the SIMD loop.
+        int left = c > 0 ? c - 1 : c;
+        int right = c < size - 1 ? c + 1 : c;
+        float gx = (row[right] - row[left]) * (right - left == 2 ? invDx : invDx * 2.0f); // dh/dx
+        float gz = (down[c] - up[c]) * invDz;                            // dh/dz
+        float inv = 1.0f / sqrtf(gx * gx + 1.0f + gz * gz);
+        out[c * 3 + 0] = -gx * inv;
+        out[c * 3 + 1] = inv;
+        out[c * 3 + 2] = -gz * inv;
+    }
+}
+
+// computeNormalRows: Thread pool callback that computes grid normals for rows [begin, end).
+static void computeNormalRows(int begin, int end, void* userData) {
+    Landscape* land = (Landscape*)userData;
+    for (int z = begin; z < end; z++) computeNormalSpan(land, z, 0, land->size);
+}
+
+// landscapeCalculateNormals: Recomputes every terrain vertex normal directly from the heightmap.
+// Gathering from neighbouring heights instead of scattering face normals lets rows run in parallel.
+void landscapeCalculateNormals(Landscape* land) {
+    threadPoolParallelFor(land->size, NORMAL_ROW_GRAIN, computeNormalRows, land);
+}
+
+// seamNormal: Sets the normal of grid vertex (x, z) from central differences of the raw noise, which look past the grid edge.
+static void seamNormal(Landscape* land, int x, int z, float invD) {
+    float gx = (noiseHeight(land, x + 1, z) - noiseHeight(land, x - 1, z)) * invD; // dh/dx
+    float gz = (noiseHeight(land, x, z + 1) - noiseHeight(land, x, z - 1)) * invD; // dh/dz
+    float inv = 1.0f / sqrtf(gx * gx + 1.0f + gz * gz);
+    float* n = &land->normals[((size_t)z * land->size + x) * 3];
+    n[0] = -gx * inv;
+    n[1] = inv;
+    n[2] = -gz * inv;
+}
+
+// computeSeamNormals: Replaces the one-sided border normals with central differences that look past the grid edge.
+// The neighbours are regenerated from the noise, which is what the adjacent tile is built from, so both tiles compute
+// the same normal for a shared border vertex and lighting has no seam between them. (Erosion only changes the home
+// terrain's interior, so its border normals are taken from the raw noise as well.) Only the border vertices inside
+// [x0, x1) x [z0, z1) are touched, so an edit can restore the part of the seam it recomputed.
+static void computeSeamNormals(Landscape* land, int x0, int z0, int x1, int z1) {
+    int size = land->size;
+    float invD = 1.0f / (2.0f * gridSpacing(land));
+    for (int z = z0; z < z1; z++) {
+        if (z == 0 || z == size - 1) { // The first and last rows are border all along.
+            for (int x = x0; x < x1; x++) seamNormal(land, x, z, invD);
+            continue;
+        }
+        if (x0 == 0) seamNormal(land, 0, z, invD); // Only the end columns in between.
+        if (x1 == size) seamNormal(land, size - 1, z, invD);
+    }
+}
+
+// LandscapeVertex: Packed per-vertex record uploaded to the GPU (8 bytes instead of 24 for float position + normal).
+// Only the height varies per vertex; x and z are rebuilt in the terrain shader from the shared grid coordinate stream.
+typedef struct {
+    float height;      // World-space vertex height
+    short normal[2];   // Octahedral-encoded unit normal, read as normalized 16-bit values
+} LandscapeVertex;
+
+// LandscapeGridCoord: Grid column and chunk-relative row of one vertex, as read by the terrain shader.
+typedef struct {
+    unsigned short x, z;
+} LandscapeGridCoord;
+
+// gridToWorld: Returns the world-space x (axis 0) or z (axis 1) of grid column (or row) i.
+static float gridToWorld(const Landscape* land, int axis, int i) {
+    return land->origin[axis] + (float)i * gridSpacing(land);
+}
+
+// encodeOctNormal: Packs a unit normal into two 16-bit octahedral coordinates.
+// The normal is projected onto the octahedron |x| + |y| + |z| = 1 and the lower half is folded over the upper one,
+// which spreads the precision evenly over the sphere; 16 bits per axis keep the error far below a shading step.
+static void encodeOctNormal(const float n[3], short out[2]) {
+    float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+    float u = l1 > 0.0f ? n[0] / l1 : 0.0f;
+    float v = l1 > 0.0f ? n[2] / l1 : 0.0f;
+    if (n[1] < 0.0f) { // Fold the lower hemisphere; terrain normals never point down, but stay general.
+        float fu = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float fv = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = fu;
+        v = fv;
+    }
+    out[0] = (short)lrintf(u * 32767.0f);
+    out[1] = (short)lrintf(v * 32767.0f);
+}
+
+// packVertices: Packs 'count' grid vertices starting at grid index 'first' into dst.
+static void packVertices(const Landscape* land, size_t first, int count, LandscapeVertex* dst) {
+    for (int i = 0; i < count; i++) {
+        dst[i].height = land->elevationData[first + i];
+        encodeOctNormal(&land->normals[(first + i) * 3], dst[i].normal);
+    }
+}
+
+// uploadHorizons: Creates the horizon stream read by the terrain shader, if the landscape has horizons and no stream yet.
+static void uploadHorizons(Landscape* land) {
+    if (!land->horizons || land->horizonBuffer) return;
+    glGenBuffers(1, &land->horizonBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, land->horizonBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)land->vertexCount * LANDSCAPE_HORIZON_DIRECTIONS, land->horizons, GL_DYNAMIC_DRAW); // Rewritten by edits.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// uploadBuffers: Builds the packed vertex buffer, the shared grid coordinate buffer, and the horizon stream for the terrain mesh.
+// The same buffers serve every weather type, since materials are blended per pixel from a weather uniform.
+static void uploadBuffers(Landscape* land) {
+    // Scratch arrays for the packed vertices and for one chunk's worth of grid rows.
+    int rows = land->chunkQuads + 1;
+    LandscapeVertex* verts = (LandscapeVertex*)malloc(sizeof(LandscapeVertex) * land->vertexCount);
+    LandscapeGridCoord* grid = (LandscapeGridCoord*)malloc(sizeof(LandscapeGridCoord) * rows * land->size);
+    if (!verts || !grid) {
+        free(verts);
+        free(grid);
+        return;
+    }
+    packVertices(land, 0, land->vertexCount, verts);
+    for (int z = 0; z < rows; z++) {
+        for (int x = 0; x < land->size; x++) {
+            grid[z * land->size + x].x = (unsigned short)x;
+            grid[z * land->size + x].z = (unsigned short)z;
+        }
+    }
+    glGenBuffers(1, &land->vertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, land->vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(LandscapeVertex) * land->vertexCount, verts, GL_STATIC_DRAW); // Upload to GPU.
+    glGenBuffers(1, &land->gridBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, land->gridBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(LandscapeGridCoord) * rows * land->size, grid, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    uploadHorizons(land);
+    free(verts); // The GPU now owns the packed copies.
+    free(grid);
+}
+
+// gridIndex: Returns the chunk-relative vertex index of local grid point (x, z), snapping seam vertices.
+// On an edge flagged in stitchMask, every other vertex is moved onto its coarser neighbour so the edge
+// matches a chunk drawn at the next LOD level exactly and no cracks appear between them.
+static unsigned int gridIndex(int rowStride, int x, int z, int quadsX, int quadsZ, int step, int stitchMask) {
+    int coarse = step * 2; // Vertex step of the coarser neighbour.
+    if (((stitchMask & 1) && x == 0) || ((stitchMask & 2) && x == quadsX)) z = (z / coarse) * coarse; // Snap along the x edges.
+    if (((stitchMask & 4) && z == 0) || ((stitchMask & 8) && z == quadsZ)) x = (x / coarse) * coarse; // Snap along the z edges.
+    return (unsigned int)(z * rowStride + x);
+}
+
+// emitGridIndices: Writes triangle indices for a quadsX x quadsZ block of the grid, sampled every 'step' vertices.
+// Used for the full-resolution mesh and for every chunk LOD mesh. Triangles collapsed by seam snapping are skipped.
+// The block is walked in vertical bands 'band' cells wide (0 = one band spanning the block, i.e. plain row order),
+// so consecutive rows share vertices that are still in the post-transform vertex cache.
+// Returns the number of indices written.
+static int emitGridIndices(unsigned int* out, int rowStride, int quadsX, int quadsZ, int step, int stitchMask, int band) {
+    int idx = 0;
+    int bandQuads = band > 0 ? band * step : quadsX;
+    // Loop over every band, then every quad of the band in row order.
+    for (int bx = 0; bx < quadsX; bx += bandQuads) {
+        int bandEnd = bx + bandQuads < quadsX ? bx + bandQuads : quadsX;
+        for (int z = 0; z < quadsZ; z += step) {
+            for (int x = bx; x < bandEnd; x += step) {
+                // Compute the four corner indices of the quad.
+                unsigned int tl = gridIndex(rowStride, x, z, quadsX, quadsZ, step, stitchMask);               // Top-left
+                unsigned int tr = gridIndex(rowStride, x + step, z, quadsX, quadsZ, step, stitchMask);        // Top-right
+                unsigned int bl = gridIndex(rowStride, x, z + step, quadsX, quadsZ, step, stitchMask);        // Bottom-left
+                unsigned int br = gridIndex(rowStride, x + step, z + step, quadsX, quadsZ, step, stitchMask); // Bottom-right
+                // First triangle of the quad (tl, bl, tr)
+                if (tl != bl && tl != tr && bl != tr) {
+                    out[idx++] = tl;
+                    out[idx++] = bl;
+                    out[idx++] = tr;
+                }
+                // Second triangle of the quad (tr, bl, br)
+                if (tr != bl && tr != br && bl != br) {
+                    out[idx++] = tr;
+                    out[idx++] = bl;
+                    out[idx++] = br;
+                }
             }
-        } else { // Otherwise, use fall/normal blending.
-            float slope = 1.0f - normY; // Slope is higher when the normal is less vertical.
-            float hAboveWater = h - WATER_LEVEL; // Height above water for beach blending.
-            float darkFac = (slope - 0.28f) / 0.32f; // Blend factor for light vs. dark rock.
-            darkFac = fmax(0.0f, fmin(1.0f, darkFac)); // Clamp to [0, 1].
-            float rock[3];
-            for(int c=0; c<3; c++) {
-                rock[c] = lightRock[c] * (1.0f - darkFac) + darkRock[c] * darkFac; // Blend light and dark rock colors.
+        }
+    }
+    return idx;
+}
+
+// gridStripIndexBound: Upper bound on the indices emitGridStrips writes for a block (for sizing buffers).
+static size_t gridStripIndexBound(int quadsX, int quadsZ, int step, int band) {
+    int cellsX = quadsX / step, cellsZ = quadsZ / step;
+    int bands = band > 0 ? (cellsX + band - 1) / band : 1;
+    return (size_t)cellsZ * ((size_t)(cellsX + bands) * 2 + bands); // Two indices per column plus a restart, per band row.
+}
+
+// emitGridStrips: Writes the same block as emitGridIndices as triangle strips separated by LANDSCAPE_RESTART_INDEX.
+// Each band row becomes one strip alternating top and bottom vertices, which reproduces the (tl, bl, tr) / (tr, bl, br)
+// triangles of the list version. Triangles collapsed by seam snapping stay in as degenerates, which the GPU discards.
+// Returns the number of indices written and stores the number of non-degenerate triangles in *triangles.
+static int emitGridStrips(unsigned int* out, int rowStride, int quadsX, int quadsZ, int step, int stitchMask, int band, int* triangles) {
+    int idx = 0, tris = 0;
+    int bandQuads = band > 0 ? band * step : quadsX;
+    for (int bx = 0; bx < quadsX; bx += bandQuads) {
+        int bandEnd = bx + bandQuads < quadsX ? bx + bandQuads : quadsX;
+        for (int z = 0; z < quadsZ; z += step) {
+            if (idx > 0) out[idx++] = LANDSCAPE_RESTART_INDEX; // Start a new strip for every band row.
+            for (int x = bx; x <= bandEnd; x += step) {
+                out[idx++] = gridIndex(rowStride, x, z, quadsX, quadsZ, step, stitchMask);        // Top vertex
+                out[idx++] = gridIndex(rowStride, x, z + step, quadsX, quadsZ, step, stitchMask); // Bottom vertex
+                if (x > bx) { // Count the quad just closed, skipping snapped-away triangles.
+                    unsigned int tl = out[idx - 4], bl = out[idx - 3], tr = out[idx - 2], br = out[idx - 1];
+                    tris += (tl != bl && tl != tr && bl != tr) + (tr != bl && tr != br && bl != br);
+                }
             }
-            float grassFac = (slope - 0.13f) / 0.23f; // Blend factor for grass vs. rock.
-            grassFac = fmax(0.0f, fmin(1.0f, grassFac)); // Clamp to [0, 1].
-            float base[3];
-            for(int c=0; c<3; c++) {
-                base[c] = grass[c] * (1.0f - grassFac) + rock[c] * grassFac; // Blend grass and rock colors.
+        }
+    }
+    *triangles = tris;
+    return idx;
+}
+
+// landscapeIndexACMR: Simulates a FIFO post-transform vertex cache of cacheSize entries over an index buffer and
+// returns the average cache miss ratio (vertex shader runs per non-degenerate triangle). For strips, indices equal
+// to LANDSCAPE_RESTART_INDEX separate the strips. An offline statistic; 0.5 is the ideal for a large regular grid.
+float landscapeIndexACMR(const unsigned int* indices, int count, int strips, int cacheSize) {
+    unsigned int* fifo = (unsigned int*)malloc(sizeof(unsigned int) * cacheSize);
+    if (!fifo || count <= 0) {
+        free(fifo);
+        return 0.0f;
+    }
+    for (int i = 0; i < cacheSize; i++) fifo[i] = LANDSCAPE_RESTART_INDEX; // Empty slots never match a real index.
+    long misses = 0, triangles = 0;
+    int head = 0, run = 0; // run = vertices since the last strip restart.
+    for (int i = 0; i < count; i++) {
+        unsigned int v = indices[i];
+        if (strips && v == LANDSCAPE_RESTART_INDEX) {
+            run = 0;
+            continue;
+        }
+        int hit = 0;
+        for (int k = 0; k < cacheSize && !hit; k++) hit = fifo[k] == v;
+        if (!hit) { // A miss runs the vertex shader and pushes the oldest entry out.
+            misses++;
+            fifo[head] = v;
+            head = (head + 1) % cacheSize;
+        }
+        if (strips) {
+            if (++run >= 3 && indices[i - 2] != indices[i - 1] && indices[i - 2] != v && indices[i - 1] != v) triangles++;
+        } else if (i % 3 == 2) {
+            triangles++;
+        }
+    }
+    free(fifo);
+    return triangles ? (float)misses / triangles : 0.0f;
+}
+
+// landscapePrintIndexStats: Prints the simulated vertex cache miss ratio of the terrain index orders for this grid.
+// Compares plain row order with the cache-banded lists and strips, for the full mesh and one full-detail chunk.
+void landscapePrintIndexStats(const Landscape* land) {
+    int grid = land->size - 1;
+    int chunk = land->chunkQuads < grid ? land->chunkQuads : grid;
+    int blocks[2] = {grid, chunk};
+    const char* names[2] = {"full mesh", "chunk"};
+    unsigned int* indices = (unsigned int*)malloc(sizeof(unsigned int) * ((size_t)grid * grid * 6 + gridStripIndexBound(grid, grid, 1, LANDSCAPE_CACHE_BAND)));
+    if (!indices) return;
+    printf("Average cache miss ratio (vertex shader runs per triangle), FIFO cache of 16 / 32 entries:\n");
+    for (int b = 0; b < 2; b++) {
+        int q = blocks[b], tris;
+        int rows = emitGridIndices(indices, land->size, q, q, 1, 0, 0);
+        float rows16 = landscapeIndexACMR(indices, rows, 0, 16), rows32 = landscapeIndexACMR(indices, rows, 0, 32);
+        int banded = emitGridIndices(indices, land->size, q, q, 1, 0, LANDSCAPE_CACHE_BAND);
+        float band16 = landscapeIndexACMR(indices, banded, 0, 16), band32 = landscapeIndexACMR(indices, banded, 0, 32);
+        int strips = emitGridStrips(indices, land->size, q, q, 1, 0, LANDSCAPE_CACHE_BAND, &tris);
+        float strip16 = landscapeIndexACMR(indices, strips, 1, 16), strip32 = landscapeIndexACMR(indices, strips, 1, 32);
+        printf("  %-9s %4dx%-4d  rows %.3f / %.3f   bands %.3f / %.3f   strips %.3f / %.3f (%d indices vs %d)\n",
+               names[b], q, q, rows16, rows32, band16, band32, strip16, strip32, strips, banded);
+    }
+    free(indices);
+}
+
+// chunkHeightRange: Sets the vertical extent of a chunk's bounding box from the heights inside it.
+static void chunkHeightRange(const Landscape* land, LandscapeChunk* ch) {
+    ch->boxMin[1] = 1e30f; ch->boxMax[1] = -1e30f;
+    for (int z = ch->z0; z <= ch->z0 + ch->quadsZ; z++) {
+        for (int x = ch->x0; x <= ch->x0 + ch->quadsX; x++) {
+            float h = land->elevationData[z * land->size + x];
+            if (h < ch->boxMin[1]) ch->boxMin[1] = h;
+            if (h > ch->boxMax[1]) ch->boxMax[1] = h;
+        }
+    }
+}
+
+// buildChunks: Splits the grid into square chunks and records each chunk's bounds and coarsest LOD level.
+// Chunks grow with the terrain resolution so the chunk count (and the number of draw calls) stays bounded.
+static int buildChunks(Landscape* land) {
+    int grid = land->size - 1;
+    land->chunkQuads = LANDSCAPE_CHUNK_QUADS;
+    while (grid > land->chunkQuads * 64) land->chunkQuads *= 2; // At most 64 chunks per side.
+    land->chunksX = land->chunksZ = (grid + land->chunkQuads - 1) / land->chunkQuads;
+    land->chunks = (LandscapeChunk*)malloc(sizeof(LandscapeChunk) * land->chunksX * land->chunksZ);
+    if (!land->chunks) return 0;
+    for (int cz = 0; cz < land->chunksZ; cz++) {
+        for (int cx = 0; cx < land->chunksX; cx++) {
+            LandscapeChunk* ch = &land->chunks[cz * land->chunksX + cx];
+            ch->x0 = cx * land->chunkQuads;
+            ch->z0 = cz * land->chunkQuads;
+            ch->quadsX = grid - ch->x0 < land->chunkQuads ? grid - ch->x0 : land->chunkQuads; // Edge chunks take the remainder.
+            ch->quadsZ = grid - ch->z0 < land->chunkQuads ? grid - ch->z0 : land->chunkQuads;
+            // A level is usable only when its vertex step divides both chunk dimensions.
+            ch->maxLevel = 0;
+            while (ch->maxLevel < LANDSCAPE_MAX_LOD && ch->quadsX % (2 << ch->maxLevel) == 0 && ch->quadsZ % (2 << ch->maxLevel) == 0) {
+                ch->maxLevel++;
             }
-            float beach = 2.1f; // Height range for beach blending.
-            if(hAboveWater < beach && hAboveWater > -1.0f) { // If near the water level...
-                float beachFac = hAboveWater / beach; // Blend factor for sand vs. base color.
-                beachFac = fmax(0.0f, fmin(1.0f, beachFac)); // Clamp to [0, 1].
-                for(int c = 0; c < 3; c++) {
-                    color[c] = sand[c] * (1-beachFac) + base[c] * beachFac; // Blend sand and base color.
+            ch->level = 0;
+            // Bounding box from the corner vertices and the height range inside the chunk.
+            ch->boxMin[0] = gridToWorld(land, 0, ch->x0); ch->boxMax[0] = gridToWorld(land, 0, ch->x0 + ch->quadsX);
+            ch->boxMin[2] = gridToWorld(land, 1, ch->z0); ch->boxMax[2] = gridToWorld(land, 1, ch->z0 + ch->quadsZ);
+            chunkHeightRange(land, ch);
+        }
+    }
+    return 1;
+}
+
+// buildQuadtreeNode: Recursively builds the quadtree over chunks [cx0, cx1) x [cz0, cz1) and returns the node index.
+// Each inner node's box encloses its children, so culling a node skips every chunk beneath it.
+static int buildQuadtreeNode(Landscape* land, int cx0, int cz0, int cx1, int cz1) {
+    int index = land->nodeCount++;
+    LandscapeNode* node = &land->nodes[index];
+    for (int i = 0; i < 4; i++) node->children[i] = -1;
+    if (cx1 - cx0 == 1 && cz1 - cz0 == 1) { // A single chunk: make a leaf.
+        LandscapeChunk* ch = &land->chunks[cz0 * land->chunksX + cx0];
+        node->chunk = cz0 * land->chunksX + cx0;
+        memcpy(node->boxMin, ch->boxMin, sizeof(node->boxMin));
+        memcpy(node->boxMax, ch->boxMax, sizeof(node->boxMax));
+        return index;
+    }
+    node->chunk = -1;
+    // Split the range in half along each axis that spans more than one chunk.
+    int mx = cx1 - cx0 > 1 ? (cx0 + cx1) / 2 : cx1;
+    int mz = cz1 - cz0 > 1 ? (cz0 + cz1) / 2 : cz1;
+    int ranges[4][4] = {{cx0, cz0, mx, mz}, {mx, cz0, cx1, mz}, {cx0, mz, mx, cz1}, {mx, mz, cx1, cz1}};
+    int n = 0;
+    for (int i = 0; i < 4; i++) {
+        if (ranges[i][0] >= ranges[i][2] || ranges[i][1] >= ranges[i][3]) continue; // Empty quadrant.
+        int child = buildQuadtreeNode(land, ranges[i][0], ranges[i][1], ranges[i][2], ranges[i][3]);
+        node = &land->nodes[index];
+        node->children[n++] = child;
+        LandscapeNode* c = &land->nodes[child];
+        for (int k = 0; k < 3; k++) {
+            if (n == 1 || c->boxMin[k] < node->boxMin[k]) node->boxMin[k] = c->boxMin[k];
+            if (n == 1 || c->boxMax[k] > node->boxMax[k]) node->boxMax[k] = c->boxMax[k];
+        }
+    }
+    return index;
+}
+
+// buildQuadtree: Allocates and builds the chunk quadtree (a tree over N leaves never needs more than 2N - 1 nodes).
+static int buildQuadtree(Landscape* land) {
+    int chunkCount = land->chunksX * land->chunksZ;
+    land->nodes = (LandscapeNode*)malloc(sizeof(LandscapeNode) * (2 * chunkCount - 1));
+    if (!land->nodes) return 0;
+    land->nodeCount = 0;
+    buildQuadtreeNode(land, 0, 0, land->chunksX, land->chunksZ);
+    return 1;
+}
+
+// getLodMesh: Returns the shared index buffer for a chunk shape, LOD level, stitch pattern, and primitive type, building it on first use.
+// Indices are relative to the chunk's first vertex, so every chunk with the same shape reuses the same buffer.
+static LandscapeLodMesh* getLodMesh(Landscape* land, int quadsX, int quadsZ, int level, int stitchMask, int strips) {
+    for (int i = 0; i < land->lodMeshCount; i++) {
+        LandscapeLodMesh* m = &land->lodMeshes[i];
+        if (m->quadsX == quadsX && m->quadsZ == quadsZ && m->level == level && m->stitchMask == stitchMask && m->strips == strips) return m;
+    }
+    if (land->lodMeshCount == land->lodMeshCapacity) { // Grow the cache.
+        int cap = land->lodMeshCapacity ? land->lodMeshCapacity * 2 : 32;
+        LandscapeLodMesh* grown = (LandscapeLodMesh*)realloc(land->lodMeshes, sizeof(LandscapeLodMesh) * cap);
+        if (!grown) return NULL;
+        land->lodMeshes = grown;
+        land->lodMeshCapacity = cap;
+    }
+    int step = 1 << level;
+    size_t capacity = strips ? gridStripIndexBound(quadsX, quadsZ, step, LANDSCAPE_CACHE_BAND) : (size_t)(quadsX / step) * (quadsZ / step) * 6;
+    unsigned int* indices = (unsigned int*)malloc(sizeof(unsigned int) * capacity);
+    if (!indices) return NULL;
+    LandscapeLodMesh* m = &land->lodMeshes[land->lodMeshCount++];
+    m->quadsX = quadsX;
+    m->quadsZ = quadsZ;
+    m->level = level;
+    m->stitchMask = stitchMask;
+    m->strips = strips;
+    if (strips) {
+        m->indexCount = emitGridStrips(indices, land->size, quadsX, quadsZ, step, stitchMask, LANDSCAPE_CACHE_BAND, &m->triangleCount);
+    } else {
+        m->indexCount = emitGridIndices(indices, land->size, quadsX, quadsZ, step, stitchMask, LANDSCAPE_CACHE_BAND);
+        m->triangleCount = m->indexCount / 3;
+    }
+    glGenBuffers(1, &m->buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m->buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * m->indexCount, indices, GL_STATIC_DRAW);
+    free(indices);
+    return m;
+}
+
+// restartSupported: Reports whether the current context can draw primitive-restart strips (OpenGL 3.1 or later).
+static int restartSupported(void) {
+#ifdef LANDSCAPE_HAVE_RESTART
+    static int supported = -1;
+    if (supported < 0) {
+        int major = 0, minor = 0;
+        const char* version = (const char*)glGetString(GL_VERSION);
+        supported = version && sscanf(version, "%d.%d", &major, &minor) == 2 && (major > 3 || (major == 3 && minor >= 1));
+    }
+    return supported;
+#else
+    return 0;
+#endif
+}
+
+// landscapeDrawsStrips: Reports whether the landscape is actually drawn as primitive-restart strips: they must be
+// enabled and supported by the context, otherwise the triangle lists are drawn.
+int landscapeDrawsStrips(const Landscape* land) {
+    return land->stripsEnabled && restartSupported();
+}
+
+// selectChunkLevels: Picks each chunk's LOD level from its distance to the camera.
+// Every doubling of distance beyond the full-detail range drops one level; afterwards neighbouring chunks are
+// refined until no two neighbours differ by more than one level, which keeps seam stitching simple.
+static void selectChunkLevels(Landscape* land, const ViewFrustum* frustum) {
+    float chunkWidth = gridSpacing(land) * land->chunkQuads; // World-space width of a full chunk.
+    float range = chunkWidth * LANDSCAPE_LOD_RANGE;
+    int count = land->chunksX * land->chunksZ;
+    for (int i = 0; i < count; i++) {
+        LandscapeChunk* ch = &land->chunks[i];
+        float d = viewFrustumBoxDistance(frustum, ch->boxMin, ch->boxMax) / range;
+        int level = 0;
+        while (d >= 1.0f && level < ch->maxLevel) { // One level per doubling of distance.
+            d *= 0.5f;
+            level++;
+        }
+        ch->level = level;
+    }
+    // Restrict neighbouring levels to differ by at most one.
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int cz = 0; cz < land->chunksZ; cz++) {
+            for (int cx = 0; cx < land->chunksX; cx++) {
+                LandscapeChunk* ch = &land->chunks[cz * land->chunksX + cx];
+                int limit = ch->level;
+                int neighbours[4] = {
+                    cx > 0 ? cz * land->chunksX + cx - 1 : -1,
+                    cx < land->chunksX - 1 ? cz * land->chunksX + cx + 1 : -1,
+                    cz > 0 ? (cz - 1) * land->chunksX + cx : -1,
+                    cz < land->chunksZ - 1 ? (cz + 1) * land->chunksX + cx : -1
+                };
+                for (int n = 0; n < 4; n++) {
+                    if (neighbours[n] >= 0 && land->chunks[neighbours[n]].level + 1 < limit) limit = land->chunks[neighbours[n]].level + 1;
                 }
-            } else {
-                for(int c = 0; c < 3; c++) {
-                    color[c] = base[c]; // Use the base color (grass/rock blend).
+                if (limit < ch->level) {
+                    ch->level = limit;
+                    changed = 1;
                 }
             }
         }
-        glColor3fv(color); // Set the current color for this vertex.
-        glNormal3fv(&land->normals[idx * 3]); // Set the normal for lighting calculations.
-        glVertex3fv(&land->vertices[idx * 3]); // Specify the vertex position.
     }
-    glEnd(); // End drawing triangles.
 }
 
-// fillVerticesAndUVs: Populates the vertex position and texture coordinate arrays for the terrain mesh.
-// Converts grid-based heightmap data into world-space geometry and UVs for rendering and texturing.
-static void fillVerticesAndUVs(Landscape* land) {
-    // Loop over every grid point in the heightmap.
-    for (int z = 0; z < LANDSCAPE_SIZE; z++) {
-        for (int x = 0; x < LANDSCAPE_SIZE; x++) {
-            int idx = z * LANDSCAPE_SIZE + x;
-            // Compute world-space x coordinate for this vertex.
-            land->vertices[idx*3 + 0] = ((float)x/LANDSCAPE_SIZE - 0.5f) * LANDSCAPE_SCALE;
-            // Set y coordinate from the elevation data.
-            land->vertices[idx*3 + 1] = land->elevationData[idx];
-            // Compute world-space z coordinate for this vertex.
-            land->vertices[idx*3 + 2] = ((float)z/LANDSCAPE_SIZE - 0.5f) * LANDSCAPE_SCALE;
-            // Set texture coordinate u (horizontal).
-            land->texCoords[idx*2 + 0] = (float)x/LANDSCAPE_SIZE;
-            // Set texture coordinate v (vertical).
-            land->texCoords[idx*2 + 1] = (float)z/LANDSCAPE_SIZE;
+// Number of rows a worker thread claims at a time during a region edit or shadow update.
+#define EDIT_ROW_GRAIN 8
+
+// EditSpan: Column range handed to the thread pool when updating a rectangular region of the grid.
+typedef struct {
+    Landscape* land;
+    int z0;              // First row of the region
+    int xBegin, xEnd;    // Column range [xBegin, xEnd)
+} EditSpan;
+
+// Horizon angles are stored in 1/255ths of a right angle; occluders below the vertex count as a flat horizon.
+#define HORIZON_ANGLE_STEP (1.5707963f / 255.0f)
+#define HORIZON_ROW_GRAIN 4 // Vertex rows per thread pool chunk when tracing horizons
+
+// Grid step of each horizon direction, counter-clockwise from +x when seen from above (+x towards +z).
+// Using the eight grid directions keeps every sample on a vertex, so no height interpolation is needed.
+static const int horizonSteps[LANDSCAPE_HORIZON_DIRECTIONS][2] = {
+    {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
+};
+
+// buildHorizonSpan: Traces the horizon of vertices [xBegin, xEnd) in row z.
+// Each direction is marched out to LANDSCAPE_HORIZON_DISTANCE with steps that grow with the distance (distant
+// occluders need to be wide to matter), keeping the steepest rise seen.
+static void buildHorizonSpan(Landscape* land, int z, int xBegin, int xEnd) {
+    int size = land->size;
+    float cell = gridSpacing(land);
+    int reach = (int)(LANDSCAPE_HORIZON_DISTANCE / cell);
+    if (reach < 1) reach = 1;
+    const float* h = land->elevationData;
+    for (int x = xBegin; x < xEnd; x++) {
+        size_t v = (size_t)z * size + x;
+        unsigned char* out = &land->horizons[v * LANDSCAPE_HORIZON_DIRECTIONS];
+        for (int d = 0; d < LANDSCAPE_HORIZON_DIRECTIONS; d++) {
+            int dx = horizonSteps[d][0], dz = horizonSteps[d][1];
+            float stepLength = (dx && dz) ? cell * 1.41421356f : cell;
+            float maxRise = 0.0f; // Tangent of the horizon angle.
+            for (int k = 1; k <= reach; k += 1 + k / 8) {
+                int sx = x + dx * k, sz = z + dz * k;
+                if (sx < 0 || sx >= size || sz < 0 || sz >= size) break; // Open sky past the edge of the grid.
+                float rise = (h[(size_t)sz * size + sx] - h[v]) / (k * stepLength);
+                if (rise > maxRise) maxRise = rise;
+            }
+            out[d] = (unsigned char)lrintf(fminf(atanf(maxRise) / HORIZON_ANGLE_STEP, 255.0f));
         }
     }
 }
 
-// fillIndices: Constructs the index buffer for the terrain mesh, defining how vertices form triangles.
-// Enables efficient rendering of the landscape as a triangle mesh using OpenGL.
-static void fillIndices(Landscape* land) {
-    // The grid is LANDSCAPE_SIZE x LANDSCAPE_SIZE, so there are LANDSCAPE_SIZE-1 quads per row/col.
-    int grid = LANDSCAPE_SIZE - 1;
-    int idx = 0;
-    // Loop over every quad in the grid.
-    for (int z = 0; z < grid; z++) {
-        for (int x = 0; x < grid; x++) {
-            // Compute the four corner indices of the quad.
-            int tl = z * LANDSCAPE_SIZE + x;       // Top-left
-            int tr = tl + 1;                       // Top-right
-            int bl = (z + 1) * LANDSCAPE_SIZE + x; // Bottom-left
-            int br = bl + 1;                       // Bottom-right
-            // First triangle of the quad (tl, bl, tr)
-            land->indices[idx++] = tl;
-            land->indices[idx++] = bl;
-            land->indices[idx++] = tr;
-            // Second triangle of the quad (tr, bl, br)
-            land->indices[idx++] = tr;
-            land->indices[idx++] = bl;
-            land->indices[idx++] = br;
+// buildHorizonRows: Thread pool callback that traces the horizons of region rows [begin, end) (an EditSpan).
+static void buildHorizonRows(int begin, int end, void* userData) {
+    EditSpan* span = (EditSpan*)userData;
+    for (int z = begin; z < end; z++) buildHorizonSpan(span->land, span->z0 + z, span->xBegin, span->xEnd);
+}
+
+// horizonLight: Reduces a world-space direction towards the light to what the terrain shader's horizon lookup needs:
+// a weight per horizon direction (the two directions bracketing the light's azimuth, blended linearly) and the
+// light's elevation above the horizontal plane in radians.
+static void horizonLight(const float dir[3], float weights[LANDSCAPE_HORIZON_DIRECTIONS], float* elevation) {
+    float len = sqrtf(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+    float azimuth = atan2f(dir[2], dir[0]) * (LANDSCAPE_HORIZON_DIRECTIONS / (2.0f * (float)M_PI));
+    if (azimuth < 0.0f) azimuth += LANDSCAPE_HORIZON_DIRECTIONS;
+    int d0 = (int)azimuth % LANDSCAPE_HORIZON_DIRECTIONS;
+    float t = azimuth - floorf(azimuth);
+    for (int d = 0; d < LANDSCAPE_HORIZON_DIRECTIONS; d++) weights[d] = 0.0f;
+    weights[d0] = 1.0f - t;
+    weights[(d0 + 1) % LANDSCAPE_HORIZON_DIRECTIONS] += t;
+    *elevation = asinf(fminf(fmaxf(dir[1] / len, -1.0f), 1.0f));
+}
+
+// uploadHorizonRows: Copies the horizons of columns [x0, x1) in rows [z0, z1) to the GPU stream.
+static void uploadHorizonRows(const Landscape* land, int x0, int z0, int x1, int z1) {
+    if (!land->horizonBuffer) return;
+    const size_t stride = LANDSCAPE_HORIZON_DIRECTIONS;
+    glBindBuffer(GL_ARRAY_BUFFER, land->horizonBuffer);
+    if (x0 == 0 && x1 == land->size) { // Whole rows are contiguous.
+        size_t first = (size_t)z0 * land->size;
+        glBufferSubData(GL_ARRAY_BUFFER, stride * first, stride * (size_t)(z1 - z0) * land->size, land->horizons + stride * first);
+    } else {
+        for (int z = z0; z < z1; z++) {
+            size_t first = (size_t)z * land->size + x0;
+            glBufferSubData(GL_ARRAY_BUFFER, stride * first, stride * (x1 - x0), land->horizons + stride * first);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// buildHorizons: Allocates the horizon array and traces every vertex; returns 0 on allocation failure.
+static int buildHorizons(Landscape* land) {
+    land->horizons = (unsigned char*)malloc((size_t)land->vertexCount * LANDSCAPE_HORIZON_DIRECTIONS);
+    if (!land->horizons) return 0;
+    EditSpan span = {land, 0, 0, land->size};
+    threadPoolParallelFor(land->size, HORIZON_ROW_GRAIN, buildHorizonRows, &span);
+    return 1;
+}
+
+// retraceDirtyHorizons: Retraces the next rows of the horizons an edit left pending, at most
+// LANDSCAPE_HORIZON_RETRACE_BUDGET vertices (but at least one row) per call, and uploads them.
+static void retraceDirtyHorizons(Landscape* land) {
+    int* dirty = land->horizonDirty;
+    if (!land->horizons || dirty[1] >= dirty[3]) return;
+    int rows = LANDSCAPE_HORIZON_RETRACE_BUDGET / (dirty[2] - dirty[0]);
+    if (rows < 1) rows = 1;
+    if (rows > dirty[3] - dirty[1]) rows = dirty[3] - dirty[1];
+    EditSpan span = {land, dirty[1], dirty[0], dirty[2]};
+    threadPoolParallelFor(rows, HORIZON_ROW_GRAIN, buildHorizonRows, &span);
+    uploadHorizonRows(land, dirty[0], dirty[1], dirty[2], dirty[1] + rows);
+    dirty[1] += rows;
+}
+
+// worldLightDirection: Returns the world-space direction towards light 0 in dir (0 if it cannot be recovered).
+// GL stores the light position in eye space, transformed by the view matrix current when it was set; that matrix is
+// still on the modelview stack while the terrain draws, so undoing its rotation gives the world-space direction.
+static int worldLightDirection(float dir[3]) {
+    float pos[4], m[16];
+    glGetLightfv(GL_LIGHT0, GL_POSITION, pos);
+    glGetFloatv(GL_MODELVIEW_MATRIX, m);
+    // The view rotation is orthonormal, so its inverse is its transpose (column-major m[col * 4 + row]).
+    for (int i = 0; i < 3; i++) dir[i] = m[i * 4 + 0] * pos[0] + m[i * 4 + 1] * pos[1] + m[i * 4 + 2] * pos[2];
+    return dir[0] != 0.0f || dir[1] != 0.0f || dir[2] != 0.0f;
+}
+
+static GLuint terrainShader = 0; // Texture-splatting terrain shader program
+static GLint terrainGridAttrib, terrainHeightAttrib, terrainNormalAttrib; // Packed vertex attribute locations
+static GLint terrainHorizonAttribs[2]; // Horizon angle attributes (directions 0-3 and 4-7)
+static GLint terrainRowUniform; // Location of the chunk's first grid row
+static GLint terrainWeatherLoc, terrainWaterLevelLoc, terrainLightingLoc, terrainFogLoc, terrainShadowsLoc; // Uniform locations
+static GLint terrainSpacingLoc, terrainOriginLoc, terrainRockLoc, terrainSandLoc;
+static GLint terrainHorizonWeightsLoc[2], terrainLightElevationLoc, terrainPenumbraLoc;
+
+// initTerrainShader: Loads the terrain shader on first use (a GL context is required).
+static void initTerrainShader(void) {
+    if (terrainShader) return;
+    terrainShader = loadShader("shaders/terrain.vert", "shaders/terrain.frag");
+    terrainGridAttrib = glGetAttribLocation(terrainShader, "gridPos");
+    terrainHeightAttrib = glGetAttribLocation(terrainShader, "height");
+    terrainNormalAttrib = glGetAttribLocation(terrainShader, "octNormal");
+    terrainHorizonAttribs[0] = glGetAttribLocation(terrainShader, "horizonsA");
+    terrainHorizonAttribs[1] = glGetAttribLocation(terrainShader, "horizonsB");
+    terrainRowUniform = glGetUniformLocation(terrainShader, "gridRow");
+    terrainWeatherLoc = glGetUniformLocation(terrainShader, "weather");
+    terrainWaterLevelLoc = glGetUniformLocation(terrainShader, "waterLevel");
+    terrainLightingLoc = glGetUniformLocation(terrainShader, "lightingEnabled");
+    terrainFogLoc = glGetUniformLocation(terrainShader, "fogEnabled");
+    terrainShadowsLoc = glGetUniformLocation(terrainShader, "shadowsEnabled");
+    terrainSpacingLoc = glGetUniformLocation(terrainShader, "gridSpacing");
+    terrainOriginLoc = glGetUniformLocation(terrainShader, "gridOrigin");
+    terrainRockLoc = glGetUniformLocation(terrainShader, "rockTex");
+    terrainSandLoc = glGetUniformLocation(terrainShader, "sandTex");
+    terrainHorizonWeightsLoc[0] = glGetUniformLocation(terrainShader, "horizonWeightsA");
+    terrainHorizonWeightsLoc[1] = glGetUniformLocation(terrainShader, "horizonWeightsB");
+    terrainLightElevationLoc = glGetUniformLocation(terrainShader, "lightElevation");
+    terrainPenumbraLoc = glGetUniformLocation(terrainShader, "shadowPenumbra");
+}
+
+// setVertexPointers: Points the packed vertex attributes at grid vertex (x0, z0) of the terrain VBO.
+// Offsetting the pointers to a chunk's first vertex lets chunk-relative index buffers be shared between chunks. The grid
+// coordinate stream holds one chunk's rows for the full grid width, so it is offset by column only and the row is
+// passed as a uniform.
+static void setVertexPointers(const Landscape* land, int x0, int z0) {
+    size_t first = (size_t)z0 * land->size + x0;
+    glBindBuffer(GL_ARRAY_BUFFER, land->vertexBuffer);
+    glVertexAttribPointer(terrainHeightAttrib, 1, GL_FLOAT, GL_FALSE, sizeof(LandscapeVertex), (void*)(first * sizeof(LandscapeVertex) + offsetof(LandscapeVertex, height)));
+    glVertexAttribPointer(terrainNormalAttrib, 2, GL_SHORT, GL_TRUE, sizeof(LandscapeVertex), (void*)(first * sizeof(LandscapeVertex) + offsetof(LandscapeVertex, normal)));
+    if (land->horizonBuffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, land->horizonBuffer);
+        for (int i = 0; i < 2; i++) {
+            glVertexAttribPointer(terrainHorizonAttribs[i], 4, GL_UNSIGNED_BYTE, GL_TRUE, LANDSCAPE_HORIZON_DIRECTIONS, (void*)(first * LANDSCAPE_HORIZON_DIRECTIONS + i * 4));
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, land->gridBuffer);
+    glVertexAttribPointer(terrainGridAttrib, 2, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(LandscapeGridCoord), (void*)((size_t)x0 * sizeof(LandscapeGridCoord)));
+    glUniform1f(terrainRowUniform, (float)z0);
+}
+
+// drawChunk: Draws one chunk at its selected level, stitching edges that border a coarser neighbour.
+static void drawChunk(Landscape* land, int chunkIndex, int strips) {
+    LandscapeChunk* ch = &land->chunks[chunkIndex];
+    int cx = chunkIndex % land->chunksX;
+    int cz = chunkIndex / land->chunksX;
+    int stitchMask = 0;
+    if (cx > 0 && land->chunks[chunkIndex - 1].level > ch->level) stitchMask |= 1;
+    if (cx < land->chunksX - 1 && land->chunks[chunkIndex + 1].level > ch->level) stitchMask |= 2;
+    if (cz > 0 && land->chunks[chunkIndex - land->chunksX].level > ch->level) stitchMask |= 4;
+    if (cz < land->chunksZ - 1 && land->chunks[chunkIndex + land->chunksX].level > ch->level) stitchMask |= 8;
+    LandscapeLodMesh* mesh = getLodMesh(land, ch->quadsX, ch->quadsZ, ch->level, stitchMask, strips);
+    if (!mesh) return;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->buffer);
+    setVertexPointers(land, ch->x0, ch->z0); // Start at the chunk's first vertex.
+    glDrawElements(strips ? GL_TRIANGLE_STRIP : GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_INT, 0);
+    land->drawnChunks++;
+    land->drawnTriangles += mesh->triangleCount;
+}
+
+// drawQuadtreeNode: Culls a quadtree node against the frustum and draws the visible chunks below it.
+static void drawQuadtreeNode(Landscape* land, const ViewFrustum* frustum, int nodeIndex, int strips) {
+    LandscapeNode* node = &land->nodes[nodeIndex];
+    if (!viewFrustumTestBox(frustum, node->boxMin, node->boxMax)) return; // The whole region is off screen.
+    if (node->chunk >= 0) {
+        drawChunk(land, node->chunk, strips);
+        return;
+    }
+    for (int i = 0; i < 4 && node->children[i] >= 0; i++) drawQuadtreeNode(land, frustum, node->children[i], strips);
+}
+
+// landscapeRender: Renders the terrain mesh with texture-splatted materials based on slope, height, and weather.
+// The mesh lives in GPU buffers and the material blend runs in the terrain shader, so changing weather only
+// changes a uniform. With LOD enabled only visible chunks are drawn, each at a level of detail chosen by its
+// distance from the camera; otherwise every chunk is drawn at full detail. Horizon shadows follow light 0: the shader
+// looks the light up in each vertex's horizons, so only a handful of uniforms change as the light moves.
+void landscapeRender(Landscape* land, int weatherType) {
+    if (!land || !land->vertexBuffer) return; // If the landscape or its buffers are missing, do nothing.
+    initTerrainShader();
+    retraceDirtyHorizons(land); // Finish the horizons of recent edits a few rows at a time.
+    int shadows = land->shadowsEnabled && land->horizonBuffer;
+    float lightDir[3], weights[LANDSCAPE_HORIZON_DIRECTIONS] = {0}, elevation = (float)M_PI * 0.5f; // Fully lit by default
+    if (shadows && worldLightDirection(lightDir)) horizonLight(lightDir, weights, &elevation);
+    glUseProgram(terrainShader);
+    glUniform1i(terrainWeatherLoc, weatherType == 1 ? 1 : 0);    // Material rules
+    glUniform1f(terrainWaterLevelLoc, WATER_LEVEL);              // Beach band height
+    glUniform1i(terrainLightingLoc, glIsEnabled(GL_LIGHTING));   // Match scene lighting
+    glUniform1i(terrainFogLoc, glIsEnabled(GL_FOG));             // Match scene fog
+    glUniform1i(terrainShadowsLoc, shadows);                     // Horizon shadows and AO
+    glUniform4fv(terrainHorizonWeightsLoc[0], 1, weights);      // Weight of each horizon direction towards the light
+    glUniform4fv(terrainHorizonWeightsLoc[1], 1, weights + 4);
+    glUniform1f(terrainLightElevationLoc, elevation);            // Light elevation in radians
+    glUniform1f(terrainPenumbraLoc, LANDSCAPE_SHADOW_PENUMBRA);  // Width of the fade into shadow
+    glUniform1f(terrainSpacingLoc, gridSpacing(land));           // Grid to world scale
+    glUniform2f(terrainOriginLoc, land->origin[0], land->origin[1]); // World x/z of vertex (0, 0)
+    // Bind the rock and sand textures to units 0 and 1.
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, sandTexture);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, rockTexture);
+    glUniform1i(terrainRockLoc, 0);
+    glUniform1i(terrainSandLoc, 1);
+    glEnableVertexAttribArray(terrainGridAttrib);
+    glEnableVertexAttribArray(terrainHeightAttrib);
+    glEnableVertexAttribArray(terrainNormalAttrib);
+    for (int i = 0; i < 2; i++) {
+        if (land->horizonBuffer) glEnableVertexAttribArray(terrainHorizonAttribs[i]);
+        else glVertexAttrib4f(terrainHorizonAttribs[i], 0.0f, 0.0f, 0.0f, 0.0f); // No horizons: open sky everywhere.
+    }
+    land->drawnChunks = 0;
+    land->drawnTriangles = 0;
+    int strips = landscapeDrawsStrips(land);
+#ifdef LANDSCAPE_HAVE_RESTART
+    if (strips) {
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(LANDSCAPE_RESTART_INDEX);
+    }
+#endif
+    if (land->lodEnabled) {
+        // Chunked path: cull the quadtree and draw each visible chunk at a distance-based level of detail.
+        ViewFrustum frustum;
+        viewFrustumExtract(&frustum);
+        selectChunkLevels(land, &frustum);
+        drawQuadtreeNode(land, &frustum, 0, strips);
+    } else {
+        // Full-detail path: every chunk at level 0, without culling.
+        int count = land->chunksX * land->chunksZ;
+        for (int i = 0; i < count; i++) land->chunks[i].level = 0;
+        for (int i = 0; i < count; i++) drawChunk(land, i, strips);
+    }
+#ifdef LANDSCAPE_HAVE_RESTART
+    if (strips) glDisable(GL_PRIMITIVE_RESTART);
+#endif
+    // Restore state so the fixed-function code that follows is unaffected.
+    glDisableVertexAttribArray(terrainHorizonAttribs[0]);
+    glDisableVertexAttribArray(terrainHorizonAttribs[1]);
+    glDisableVertexAttribArray(terrainNormalAttrib);
+    glDisableVertexAttribArray(terrainHeightAttrib);
+    glDisableVertexAttribArray(terrainGridAttrib);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
+
+// Water surface state, shared by every landscape. The grid is a unit square built once; the shader scales it.
+static GLuint waterShader = 0;     // Water wave/color shader program
+static GLuint waterVertexBuffer = 0; // Unit grid positions (x, z) in [-0.5, 0.5]
+static GLuint waterIndexBuffer = 0;  // Triangle indices for the grid
+static int waterIndexCount = 0;      // Number of indices in waterIndexBuffer
+static GLint waterTimeLoc, waterDayTimeLoc, waterSizeLoc, waterCenterLoc, waterFogLoc; // Water shader uniform locations
+static GLint waterGridAttrib;        // Location of the grid position attribute
+
+// initWaterGrid: Builds the static water grid buffers and loads the water shader on first use.
+// Returns 0 (and leaves water disabled) if the grid memory cannot be allocated.
+static int initWaterGrid(void) {
+    if (waterVertexBuffer) return 1;
+    int n = WATER_SEGMENTS + 1; // Vertices per side.
+    float* grid = (float*)malloc((size_t)n * n * 2 * sizeof(float));
+    unsigned int* indices = (unsigned int*)malloc((size_t)WATER_SEGMENTS * WATER_SEGMENTS * 6 * sizeof(unsigned int));
+    if (!grid || !indices) {
+        free(grid);
+        free(indices);
+        return 0;
+    }
+    for (int j = 0; j < n; j++) { // Unit grid positions, centered on the origin.
+        for (int i = 0; i < n; i++) {
+            grid[(j * n + i) * 2 + 0] = (float)i / WATER_SEGMENTS - 0.5f;
+            grid[(j * n + i) * 2 + 1] = (float)j / WATER_SEGMENTS - 0.5f;
         }
     }
+    waterIndexCount = emitGridIndices(indices, n, WATER_SEGMENTS, WATER_SEGMENTS, 1, 0, LANDSCAPE_CACHE_BAND); // Same winding as the terrain.
+    glGenBuffers(1, &waterVertexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, waterVertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)n * n * 2 * sizeof(float), grid, GL_STATIC_DRAW);
+    glGenBuffers(1, &waterIndexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, waterIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (size_t)waterIndexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    free(grid);
+    free(indices);
+    waterShader = loadShader("shaders/water.vert", "shaders/water.frag");
+    waterTimeLoc = glGetUniformLocation(waterShader, "time");
+    waterDayTimeLoc = glGetUniformLocation(waterShader, "dayTime");
+    waterSizeLoc = glGetUniformLocation(waterShader, "waterSize");
+    waterCenterLoc = glGetUniformLocation(waterShader, "waterCenter");
+    waterFogLoc = glGetUniformLocation(waterShader, "fogEnabled");
+    waterGridAttrib = glGetAttribLocation(waterShader, "gridPos");
+    return 1;
 }
 
 // landscapeRenderWater: Renders the animated water surface with time-of-day color blending and wave simulation.
-// Demonstrates dynamic environmental effects and integrates with the terrain for realism.
-void landscapeRenderWater(float waterLevel, Landscape* land, float dayTime) {
+// The grid is static on the GPU; wave displacement and the day color blend run in the water vertex shader. The plane
+// covers the given landscape, so every streamed tile can draw its own.
+void landscapeRenderWater(float waterLevel, Landscape* land, float dayTime, float time) {
+    if (!initWaterGrid() || !waterShader) return;
     // Set the size of the water plane to match the landscape.
-    float waterSize = LANDSCAPE_SCALE;
-    // Number of segments for the water mesh (higher = smoother waves).
-    int segs = 64;
-    // Size of each segment.
-    float segSize = waterSize / segs;
-    // Specular highlight for water (shiny surface).
-    float spec[4] = {1.0f, 1.0f, 1.0f, 0.3f};
+    float waterSize = land ? land->scale : LANDSCAPE_SCALE;
+    float waterCenter[2] = {land ? land->origin[0] + waterSize * 0.5f : 0.0f, land ? land->origin[1] + waterSize * 0.5f : 0.0f};
     // Enable blending for water transparency.
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    // Compute the time of day as a fraction (0.0 = midnight, 1.0 = next midnight).
-    float t = dayTime / 24.0f;
-    // Define color stops for water at different times of day.
-    const int NUM_COLS = 6;
-    float tPoints[6] = {0.0f, 0.25f, 0.4f, 0.6f, 0.75f, 1.0f};
-    float cols[6][4] = {
-        {0.02f, 0.02f, 0.1f, 0.9f},
-        {0.3f, 0.2f, 0.3f, 0.9f},
-        {0.2f, 0.3f, 0.5f, 0.9f},
-        {0.2f, 0.3f, 0.5f, 0.9f},
-        {0.3f, 0.2f, 0.3f, 0.9f},
-        {0.02f, 0.02f, 0.1f, 0.9f}
-    };
-    // Find which two color stops the current time falls between.
-    int i;
-    for(i = 0; i < NUM_COLS-1; i++) {
-        if(t >= tPoints[i] && t <= tPoints[i+1]) break;
-    }
-    // Compute the blend factor between the two color stops.
-    float segPos = (t - tPoints[i]) / (tPoints[i+1] - tPoints[i]);
-    float blend = cubicStep(0.0f, 1.0f, segPos);
-    float wColor[4];
-    // Interpolate between the two color stops for the current water color.
-    for(int j = 0; j < 4; j++) {
-        wColor[j] = cols[i][j] * (1.0f - blend) + cols[i+1][j] * blend;
-    }
-    // Get the current time in seconds for animated waves.
-    float now = glutGet(GLUT_ELAPSED_TIME) / 1000.0;
     glPushMatrix();
     // Move the water plane to the correct height.
     glTranslatef(0, waterLevel, 0);
-    // Set the water's specular properties.
-    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, spec);
-    glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, 100.0f);
-    glBegin(GL_QUADS);
-    // Loop over every quad in the water mesh.
-    for(int i = -segs/2; i < segs/2; i++) {
-        for(int j = -segs/2; j < segs/2; j++) {
-            // Compute the four corners of the quad.
-            float x1 = i * segSize;
-            float x2 = x1 + segSize;
-            float z1 = j * segSize;
-            float z2 = z1 + segSize;
-            // Compute animated wave heights for each corner.
-            float waveF = 0.021f;
-            float waveA = 0.052f;
-            float y1 = sin(x1*waveF + z1*waveF + now) * waveA;
-            float y2 = sin(x2*waveF + z1*waveF + now) * waveA;
-            float y3 = sin(x2*waveF + z2*waveF + now) * waveA;
-            float y4 = sin(x1*waveF + z2*waveF + now) * waveA;
-            // Add a small color variation based on wave height for realism.
-            float cVar = (y1 + 0.05f) * 0.05f;
-            float fColor[4];
-            for(int c = 0; c < 4; c++) {
-                fColor[c] = wColor[c] + (c < 3 ? cVar : 0);
-            }
-            // Set the color and draw the quad.
-            glColor4fv(fColor);
-            glVertex3f(x1, y1, z1);
-            glVertex3f(x2, y2, z1);
-            glVertex3f(x2, y3, z2);
-            glVertex3f(x1, y4, z2);
-        }
-    }
-    glEnd();
+    glUseProgram(waterShader);
+    glUniform1f(waterTimeLoc, time);           // Wave animation time
+    glUniform1f(waterDayTimeLoc, dayTime);     // Time of day for the color blend
+    glUniform1f(waterSizeLoc, waterSize);      // Unit grid to world scale
+    glUniform2f(waterCenterLoc, waterCenter[0], waterCenter[1]); // Plane center
+    glUniform1i(waterFogLoc, glIsEnabled(GL_FOG)); // Match the scene fog
+    GLint loc = waterGridAttrib;
+    glBindBuffer(GL_ARRAY_BUFFER, waterVertexBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, waterIndexBuffer);
+    glEnableVertexAttribArray(loc);
+    glVertexAttribPointer(loc, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glDrawElements(GL_TRIANGLES, waterIndexCount, GL_UNSIGNED_INT, (void*)0);
+    glDisableVertexAttribArray(loc);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
     glPopMatrix();
     glDisable(GL_BLEND);
 }
@@ -392,26 +1217,27 @@ void landscapeRenderWater(float waterLevel, Landscape* land, float dayTime) {
 // landscapeGetHeight: Returns the interpolated terrain height at any (x, z) world coordinate.
 // Enables smooth object placement, collision, and physics by providing continuous height queries.
 float landscapeGetHeight(Landscape* land, float x, float z) {
-    // Convert world-space x coordinate to normalized grid-space (0 to LANDSCAPE_SIZE-1)
-    float nx = (x / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1);
-    // Convert world-space z coordinate to normalized grid-space (0 to LANDSCAPE_SIZE-1)
-    float nz = (z / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1);
+    int size = land->size;
+    // Convert world-space x coordinate to normalized grid-space (0 to size-1)
+    float nx = (x - land->origin[0]) / gridSpacing(land);
+    // Convert world-space z coordinate to normalized grid-space (0 to size-1)
+    float nz = (z - land->origin[1]) / gridSpacing(land);
     // Get the integer grid cell coordinates (lower-left corner of the cell)
     int x0 = (int)nx;
     int z0 = (int)nz;
     // Clamp x0 and z0 to valid grid range to avoid out-of-bounds access
     if (x0 < 0) x0 = 0;
     if (z0 < 0) z0 = 0;
-    if (x0 >= LANDSCAPE_SIZE-1) x0 = LANDSCAPE_SIZE-2;
-    if (z0 >= LANDSCAPE_SIZE-1) z0 = LANDSCAPE_SIZE-2;
+    if (x0 >= size-1) x0 = size-2;
+    if (z0 >= size-1) z0 = size-2;
     // Compute the fractional part within the grid cell (for interpolation)
     float fx = nx - x0;
     float fz = nz - z0;
     // Sample the four corner heights of the grid cell
-    float h00 = land->elevationData[z0 * LANDSCAPE_SIZE + x0];       // Lower-left
-    float h10 = land->elevationData[z0 * LANDSCAPE_SIZE + (x0+1)];   // Lower-right
-    float h01 = land->elevationData[(z0+1) * LANDSCAPE_SIZE + x0];   // Upper-left
-    float h11 = land->elevationData[(z0+1) * LANDSCAPE_SIZE + (x0+1)]; // Upper-right
+    float h00 = land->elevationData[z0 * size + x0];         // Lower-left
+    float h10 = land->elevationData[z0 * size + (x0+1)];     // Lower-right
+    float h01 = land->elevationData[(z0+1) * size + x0];     // Upper-left
+    float h11 = land->elevationData[(z0+1) * size + (x0+1)]; // Upper-right
     // Interpolate along the x direction for the bottom and top edges of the cell
     float h0 = h00 * (1-fx) + h10 * fx; // Bottom edge (z0)
     float h1 = h01 * (1-fx) + h11 * fx; // Top edge (z0+1)
@@ -419,16 +1245,532 @@ float landscapeGetHeight(Landscape* land, float x, float z) {
     return h0 * (1-fz) + h1 * fz; // Bilinear interpolation for smooth height
 }
 
+// Number of (x, z) queries handled per SIMD step by the batched lookups.
+#define QUERY_LANES 4
+
+// gridCell: Converts world (x, z) to the clamped lower-left grid cell and the fractional position inside it.
+// Uses exactly the same mapping and clamping as landscapeGetHeight.
+static void gridCell(const Landscape* land, float x, float z, int* cx, int* cz, float* fx, float* fz) {
+    int size = land->size;
+    float nx = (x - land->origin[0]) / gridSpacing(land);
+    float nz = (z - land->origin[1]) / gridSpacing(land);
+    int x0 = (int)nx;
+    int z0 = (int)nz;
+    if (x0 < 0) x0 = 0;
+    if (z0 < 0) z0 = 0;
+    if (x0 >= size-1) x0 = size-2;
+    if (z0 >= size-1) z0 = size-2;
+    *cx = x0;
+    *cz = z0;
+    if (fx) *fx = nx - x0;
+    if (fz) *fz = nz - z0;
+}
+
+// acosApprox: Polynomial arc cosine (Abramowitz & Stegun 4.4.46), absolute error around 2e-7 radians.
+// Turns normal y components into slope angles while the attribute map is built.
+static float acosApprox(float c) {
+    float a = fabsf(c);
+    float p = -0.0012624911f;
+    p = p * a + 0.0066700901f;
+    p = p * a - 0.0170881256f;
+    p = p * a + 0.0308918810f;
+    p = p * a - 0.0501743046f;
+    p = p * a + 0.0889789874f;
+    p = p * a - 0.2145988016f;
+    p = p * a + 1.5707963050f;
+    float r = sqrtf(1.0f - a) * p; // acos(|c|)
+    return c < 0.0f ? 3.14159265f - r : r; // acos(-c) = pi - acos(c)
+}
+
+#ifdef LANDSCAPE_HAVE_SSE
+// cellCoords4: SSE version of gridCell for four queries; writes clamped cell indices and fractions.
+static void cellCoords4(const Landscape* land, const float* xs, const float* zs, int* idx, float* fx, float* fz) {
+    __m128 spacing = _mm_set1_ps(gridSpacing(land));
+    __m128 nx = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(xs), _mm_set1_ps(land->origin[0])), spacing);
+    __m128 nz = _mm_div_ps(_mm_sub_ps(_mm_loadu_ps(zs), _mm_set1_ps(land->origin[1])), spacing);
+    // Truncate like the scalar (int) cast, then clamp to [0, size-2] in float (exact for grid-sized integers).
+    __m128 maxCell = _mm_set1_ps((float)(land->size - 2));
+    __m128 x0 = _mm_min_ps(_mm_max_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(nx)), _mm_setzero_ps()), maxCell);
+    __m128 z0 = _mm_min_ps(_mm_max_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(nz)), _mm_setzero_ps()), maxCell);
+    if (fx) _mm_storeu_ps(fx, _mm_sub_ps(nx, x0));
+    if (fz) _mm_storeu_ps(fz, _mm_sub_ps(nz, z0));
+    int cx[4], cz[4];
+    _mm_storeu_si128((__m128i*)cx, _mm_cvttps_epi32(x0));
+    _mm_storeu_si128((__m128i*)cz, _mm_cvttps_epi32(z0));
+    for (int l = 0; l < 4; l++) idx[l] = cz[l] * land->size + cx[l]; // Integer math: large grids exceed float precision.
+}
+#endif
+
+// landscapeGetHeightBatch: Bilinear terrain heights for 'count' world positions (xs[i], zs[i]) written to out[i].
+// Produces the same values as calling landscapeGetHeight per point; the coordinate math and the
+// interpolation run four queries at a time in SSE lanes, leaving only the height fetches scalar.
+void landscapeGetHeightBatch(const Landscape* land, const float* xs, const float* zs, int count, float* out) {
+    const float* h = land->elevationData;
+    int size = land->size;
+    int i = 0;
+#ifdef LANDSCAPE_HAVE_SSE
+    for (; i + QUERY_LANES <= count; i += QUERY_LANES) {
+        int idx[QUERY_LANES];
+        float fx[QUERY_LANES], fz[QUERY_LANES], h00[QUERY_LANES], h10[QUERY_LANES], h01[QUERY_LANES], h11[QUERY_LANES];
+        cellCoords4(land, xs + i, zs + i, idx, fx, fz);
+        for (int l = 0; l < QUERY_LANES; l++) { // Fetch the four corners of each lane's cell.
+            h00[l] = h[idx[l]];
+            h10[l] = h[idx[l] + 1];
+            h01[l] = h[idx[l] + size];
+            h11[l] = h[idx[l] + size + 1];
+        }
+        __m128 vfx = _mm_loadu_ps(fx), vfz = _mm_loadu_ps(fz), one = _mm_set1_ps(1.0f);
+        __m128 ifx = _mm_sub_ps(one, vfx);
+        __m128 h0 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(h00), ifx), _mm_mul_ps(_mm_loadu_ps(h10), vfx)); // Bottom edge (z0)
+        __m128 h1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(h01), ifx), _mm_mul_ps(_mm_loadu_ps(h11), vfx)); // Top edge (z0+1)
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(h0, _mm_sub_ps(one, vfz)), _mm_mul_ps(h1, vfz)));
+    }
+#endif
+    for (; i < count; i++) out[i] = landscapeGetHeight((Landscape*)land, xs[i], zs[i]); // Scalar remainder.
+}
+
+// Slope angle (radians) covered by one step of the quantized attribute slope.
+#define ATTRIBUTE_SLOPE_STEP (1.5707963f / 255.0f)
+#define ATTRIBUTE_ROW_GRAIN 32 // Cell rows per thread pool chunk when building the attribute map
+
+// cellMaterial: Classifies a cell with the terrain shader's default (non-winter) rules: a sand band near the water,
+// rock where 1 - normal.y passes the middle of the grass-to-rock blend, grass elsewhere.
+static int cellMaterial(float aboveWater, float minNormalY) {
+    if (aboveWater < -1.0f) return LANDSCAPE_MATERIAL_WATER;
+    if (aboveWater < 1.05f) return LANDSCAPE_MATERIAL_SAND;  // Beach blend factor below one half.
+    if (1.0f - minNormalY > 0.245f) return LANDSCAPE_MATERIAL_ROCK; // Grass-to-rock blend factor above one half.
+    return LANDSCAPE_MATERIAL_GRASS;
+}
+
+// ruleAccepts: Tests a placement rule against a packed cell record.
+// Rules see the quantized values, so a rule gives the same answer whenever it is registered.
+static int ruleAccepts(const LandscapePlacementRule* rule, const LandscapeCellAttributes* cell) {
+    float aboveWater = (float)cell->aboveWater / LANDSCAPE_ATTRIBUTE_HEIGHT_STEPS;
+    float slope = cell->slope * ATTRIBUTE_SLOPE_STEP;
+    if (aboveWater < rule->minAboveWater || aboveWater > rule->maxAboveWater) return 0;
+    if (slope < rule->minSlope || slope > rule->maxSlope) return 0;
+    return rule->materials == 0 || (rule->materials & (1u << cell->material)) != 0;
+}
+
+// buildAttributeSpan: Fills the attribute records of cells [xBegin, xEnd) in cell row z.
+// A cell takes its lowest corner height and its steepest corner slope, so a cell that dips into the water or
+// touches a cliff is treated as such everywhere inside it.
+static void buildAttributeSpan(Landscape* land, int z, int xBegin, int xEnd) {
+    int size = land->size;
+    for (int x = xBegin; x < xEnd; x++) {
+        int v = z * size + x; // Lower-left corner vertex.
+        int corners[4] = {v, v + 1, v + size, v + size + 1};
+        float minHeight = 1e30f, minNormalY = 1.0f;
+        for (int c = 0; c < 4; c++) {
+            if (land->elevationData[corners[c]] < minHeight) minHeight = land->elevationData[corners[c]];
+            if (land->normals[corners[c] * 3 + 1] < minNormalY) minNormalY = land->normals[corners[c] * 3 + 1];
+        }
+        LandscapeCellAttributes* cell = &land->attributes[z * (size - 1) + x];
+        float aboveWater = (minHeight - WATER_LEVEL) * LANDSCAPE_ATTRIBUTE_HEIGHT_STEPS;
+        aboveWater = aboveWater < -32768.0f ? -32768.0f : (aboveWater > 32767.0f ? 32767.0f : aboveWater);
+        cell->aboveWater = (short)lrintf(aboveWater);
+        float slope = acosApprox(fminf(fmaxf(minNormalY, -1.0f), 1.0f));
+        cell->slope = (unsigned char)lrintf(fminf(slope / ATTRIBUTE_SLOPE_STEP, 255.0f));
+        cell->material = (unsigned char)cellMaterial(minHeight - WATER_LEVEL, minNormalY);
+        cell->placement = 0;
+        for (int r = 0; r < land->ruleCount; r++) {
+            if (ruleAccepts(&land->rules[r], cell)) cell->placement |= (unsigned short)(1u << r);
+        }
+    }
+}
+
+// buildAttributeRows: Thread pool callback that builds the attribute map for cell rows [begin, end).
+static void buildAttributeRows(int begin, int end, void* userData) {
+    Landscape* land = (Landscape*)userData;
+    for (int z = begin; z < end; z++) buildAttributeSpan(land, z, 0, land->size - 1);
+}
+
+// buildAttributeMap: Allocates and fills the per-cell attribute map; returns 0 on allocation failure.
+static int buildAttributeMap(Landscape* land) {
+    size_t cells = (size_t)(land->size - 1) * (land->size - 1);
+    land->attributes = (LandscapeCellAttributes*)malloc(sizeof(LandscapeCellAttributes) * cells);
+    if (!land->attributes) return 0;
+    threadPoolParallelFor(land->size - 1, ATTRIBUTE_ROW_GRAIN, buildAttributeRows, land);
+    return 1;
+}
+
+// RuleJob: Shared state for marking the cells one newly added rule accepts.
+typedef struct {
+    Landscape* land;
+    int rule;
+} RuleJob;
+
+// markRuleRows: Thread pool callback that sets the rule's bit on the accepting cells of rows [begin, end).
+static void markRuleRows(int begin, int end, void* userData) {
+    const RuleJob* job = (const RuleJob*)userData;
+    Landscape* land = job->land;
+    const LandscapePlacementRule* rule = &land->rules[job->rule];
+    int cells = land->size - 1;
+    for (int z = begin; z < end; z++) {
+        for (int x = 0; x < cells; x++) {
+            LandscapeCellAttributes* cell = &land->attributes[z * cells + x];
+            if (ruleAccepts(rule, cell)) cell->placement |= (unsigned short)(1u << job->rule);
+        }
+    }
+}
+
+// landscapeAddPlacementRule: Registers a placement rule and marks every cell it accepts; returns the rule's bit index.
+// Registering a rule identical to an existing one returns the existing index. Returns -1 when all
+// LANDSCAPE_MAX_PLACEMENT_RULES bits are taken. The bits stay up to date through landscapeModifyRegion.
+int landscapeAddPlacementRule(Landscape* land, const LandscapePlacementRule* rule) {
+    for (int r = 0; r < land->ruleCount; r++) {
+        if (memcmp(&land->rules[r], rule, sizeof(LandscapePlacementRule)) == 0) return r;
+    }
+    if (land->ruleCount >= LANDSCAPE_MAX_PLACEMENT_RULES) return -1;
+    RuleJob job = {land, land->ruleCount};
+    land->rules[land->ruleCount++] = *rule;
+    threadPoolParallelFor(land->size - 1, ATTRIBUTE_ROW_GRAIN, markRuleRows, &job);
+    return job.rule;
+}
+
+// landscapeGetPlacementBatch: Placement rule bits of the cells under 'count' world positions (xs[i], zs[i]).
+// Test bit i with (outMasks[k] >> i) & 1 for the rule landscapeAddPlacementRule returned as i.
+void landscapeGetPlacementBatch(const Landscape* land, const float* xs, const float* zs, int count, unsigned int* outMasks) {
+    int cells = land->size - 1;
+    for (int i = 0; i < count; i++) {
+        int cx, cz;
+        gridCell(land, xs[i], zs[i], &cx, &cz, NULL, NULL);
+        outMasks[i] = land->attributes[cz * cells + cx].placement;
+    }
+}
+
+// landscapeGetCellInfo: Decodes the attributes of the cell under world position (x, z).
+void landscapeGetCellInfo(const Landscape* land, float x, float z, LandscapeCellInfo* info) {
+    int cx, cz;
+    gridCell(land, x, z, &cx, &cz, NULL, NULL);
+    const LandscapeCellAttributes* cell = &land->attributes[cz * (land->size - 1) + cx];
+    info->aboveWater = (float)cell->aboveWater / LANDSCAPE_ATTRIBUTE_HEIGHT_STEPS;
+    info->slope = cell->slope * ATTRIBUTE_SLOPE_STEP;
+    info->material = cell->material;
+    info->placement = cell->placement;
+}
+
+// Number of pyramid rows a worker thread claims at a time.
+#define PYRAMID_ROW_GRAIN 16
+
+// pyramidLevel: Returns the (min, max) pairs of one pyramid level.
+static float* pyramidLevel(const LandscapeHeightPyramid* p, int level) {
+    return p->minMax + p->offsets[level] * 2;
+}
+
+// pyramidBaseSpan: Sets level 0 cells [xBegin, xEnd) of row z to the height range of each cell's four corners.
+static void pyramidBaseSpan(Landscape* land, int z, int xBegin, int xEnd) {
+    int size = land->size, dim = land->pyramid.dims[0];
+    float* out = pyramidLevel(&land->pyramid, 0) + (size_t)z * dim * 2;
+    const float* row0 = &land->elevationData[z * size];
+    const float* row1 = row0 + size;
+    for (int x = xBegin; x < xEnd; x++) {
+        out[x * 2 + 0] = fminf(fminf(row0[x], row0[x + 1]), fminf(row1[x], row1[x + 1]));
+        out[x * 2 + 1] = fmaxf(fmaxf(row0[x], row0[x + 1]), fmaxf(row1[x], row1[x + 1]));
+    }
+}
+
+// buildPyramidBaseRows: Thread pool callback that fills level 0 rows [begin, end) of the pyramid.
+static void buildPyramidBaseRows(int begin, int end, void* userData) {
+    Landscape* land = (Landscape*)userData;
+    for (int z = begin; z < end; z++) pyramidBaseSpan(land, z, 0, land->pyramid.dims[0]);
+}
+
+// reducePyramidRect: Sets cells [x0, x1) x [z0, z1) of a level to the height range of their (up to) four children.
+static void reducePyramidRect(LandscapeHeightPyramid* p, int level, int x0, int z0, int x1, int z1) {
+    int dim = p->dims[level], childDim = p->dims[level - 1];
+    const float* child = pyramidLevel(p, level - 1);
+    float* out = pyramidLevel(p, level);
+    for (int z = z0; z < z1; z++) {
+        for (int x = x0; x < x1; x++) {
+            float lo = 1e30f, hi = -1e30f;
+            for (int k = 0; k < 4; k++) {
+                int cx = x * 2 + (k & 1), cz = z * 2 + (k >> 1);
+                if (cx >= childDim || cz >= childDim) continue; // Odd dimensions leave the last row/column unpaired.
+                lo = fminf(lo, child[(cz * childDim + cx) * 2 + 0]);
+                hi = fmaxf(hi, child[(cz * childDim + cx) * 2 + 1]);
+            }
+            out[(z * dim + x) * 2 + 0] = lo;
+            out[(z * dim + x) * 2 + 1] = hi;
+        }
+    }
+}
+
+// buildHeightPyramid: Builds the min/max height pyramid over the grid cells, halving the resolution per level.
+// Returns 0 on allocation failure.
+static int buildHeightPyramid(Landscape* land) {
+    LandscapeHeightPyramid* p = &land->pyramid;
+    size_t total = 0;
+    int dim = land->size - 1;
+    for (p->levels = 0; ; ) { // Lay the levels out back to back, finest first, down to a single cell.
+        p->dims[p->levels] = dim;
+        p->offsets[p->levels] = total;
+        total += (size_t)dim * dim;
+        p->levels++;
+        if (dim == 1) break;
+        dim = (dim + 1) / 2;
+    }
+    p->minMax = (float*)malloc(sizeof(float) * 2 * total);
+    if (!p->minMax) return 0;
+    threadPoolParallelFor(p->dims[0], PYRAMID_ROW_GRAIN, buildPyramidBaseRows, land);
+    for (int level = 1; level < p->levels; level++) reducePyramidRect(p, level, 0, 0, p->dims[level], p->dims[level]);
+    return 1;
+}
+
+// planeHit: Finds where the ray first reaches one triangle's height plane between parameters tA and tB.
+// fA and fB are the ray height minus the plane height at each end; returns -1 when the ray stays above.
+static double planeHit(double tA, double tB, double fA, double fB) {
+    if (fA <= 0.0) return tA; // Already at or below the surface where this piece starts.
+    if (fB > 0.0) return -1.0;
+    return tA + (tB - tA) * fA / (fA - fB);
+}
+
+// raycastCell: Intersects the ray with the two triangles of grid cell (cx, cz) between parameters tA and tB.
+// Works in grid space (one unit per cell) and splits the segment at the cell diagonal, matching the mesh triangulation.
+// On a hit stores the parameter and the plane slopes (height change per cell along x and z) and returns 1.
+static int raycastCell(const Landscape* land, int cx, int cz, const double o[3], const double d[3], double tA, double tB,
+                       double* tHit, double* slopeX, double* slopeZ) {
+    const float* e = &land->elevationData[cz * land->size + cx];
+    double h00 = e[0], h10 = e[1], h01 = e[land->size], h11 = e[land->size + 1];
+    // Height planes h = p0 + px * fx + pz * fz for the triangles (tl, bl, tr) and (tr, bl, br).
+    double planes[2][3] = {{h00, h10 - h00, h01 - h00}, {h01 + h10 - h11, h11 - h01, h11 - h10}};
+    double fx0 = o[0] - cx, fz0 = o[2] - cz;
+    double gA = fx0 + fz0 - 1.0 + (d[0] + d[2]) * tA; // Which side of the diagonal (fx + fz = 1) each end lies on.
+    double gB = fx0 + fz0 - 1.0 + (d[0] + d[2]) * tB;
+    double pieces[2][2] = {{tA, tB}, {tB, tB}};
+    int tris[2] = {gA <= 0.0 ? 0 : 1, gA <= 0.0 ? 1 : 0};
+    if ((gA < 0.0 && gB > 0.0) || (gA > 0.0 && gB < 0.0)) { // The ray crosses the diagonal inside the cell.
+        double tD = tA + (tB - tA) * gA / (gA - gB);
+        pieces[0][1] = tD;
+        pieces[1][0] = tD;
+    }
+    for (int i = 0; i < 2; i++) {
+        double t0 = pieces[i][0], t1 = pieces[i][1];
+        if (i == 1 && t0 >= t1) break; // Whole segment was on one side.
+        const double* pl = planes[tris[i]];
+        double f0 = o[1] + d[1] * t0 - (pl[0] + pl[1] * (fx0 + d[0] * t0) + pl[2] * (fz0 + d[2] * t0));
+        double f1 = o[1] + d[1] * t1 - (pl[0] + pl[1] * (fx0 + d[0] * t1) + pl[2] * (fz0 + d[2] * t1));
+        double t = planeHit(t0, t1, f0, f1);
+        if (t >= 0.0) {
+            *tHit = t;
+            *slopeX = pl[1];
+            *slopeZ = pl[2];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// landscapeRaycast: Casts a ray from origin along dir (any length, not necessarily normalized) against the terrain mesh.
+// Walks the min/max pyramid top-down: a cell whose highest point lies below the ray over the cell is skipped at
+// once, so large empty stretches cost one step per level instead of one step per grid cell. Only level 0 cells
+// under the ray are tested against their triangles. The terrain is treated as solid, so a ray that starts below the
+// surface (or enters the grid from the side below it) hits where it enters.
+// Returns 1 and fills *hit when the ray meets the terrain, 0 otherwise.
+int landscapeRaycast(const Landscape* land, const float origin[3], const float dir[3], LandscapeRayHit* hit) {
+    const LandscapeHeightPyramid* p = &land->pyramid;
+    if (!p->minMax) return 0;
+    // Move to grid space, where vertex (x, z) sits at (x, z); the mapping is affine, so ray parameters carry over.
+    double toGrid = (land->size - 1) / (double)land->scale;
+    double o[3] = {(origin[0] - (double)land->origin[0]) * toGrid, origin[1], (origin[2] - (double)land->origin[1]) * toGrid};
+    double d[3] = {dir[0] * toGrid, dir[1], dir[2] * toGrid};
+    int top = p->levels - 1;
+    const float* root = pyramidLevel(p, top);
+    // Clip the ray to the terrain footprint below its highest point (the ground is solid all the way down).
+    double boxMin[3] = {0.0, -1e30, 0.0}, boxMax[3] = {p->dims[0], root[1], p->dims[0]};
+    double tMin = 0.0, tMax = 1e300;
+    for (int k = 0; k < 3; k++) {
+        if (d[k] == 0.0) {
+            if (o[k] < boxMin[k] || o[k] > boxMax[k]) return 0; // Parallel to this slab and outside it.
+            continue;
+        }
+        double t0 = (boxMin[k] - o[k]) / d[k], t1 = (boxMax[k] - o[k]) / d[k];
+        if (t0 > t1) { double tmp = t0; t0 = t1; t1 = tmp; }
+        if (t0 > tMin) tMin = t0;
+        if (t1 < tMax) tMax = t1;
+    }
+    if (tMin > tMax) return 0;
+    // Nudge cell lookups toward the direction of travel so a point on a cell boundary belongs to the cell being entered.
+    double biasX = d[0] > 0.0 ? 1e-6 : (d[0] < 0.0 ? -1e-6 : 0.0);
+    double biasZ = d[2] > 0.0 ? 1e-6 : (d[2] < 0.0 ? -1e-6 : 0.0);
+    double t = tMin;
+    int level = top;
+    while (t <= tMax) {
+        int cellSize = 1 << level, dim = p->dims[level];
+        int cx = (int)floor((o[0] + d[0] * t + biasX) / cellSize);
+        int cz = (int)floor((o[2] + d[2] * t + biasZ) / cellSize);
+        cx = cx < 0 ? 0 : (cx >= dim ? dim - 1 : cx);
+        cz = cz < 0 ? 0 : (cz >= dim ? dim - 1 : cz);
+        // Parameter at which the ray leaves this cell (or the terrain box).
+        double x0 = (double)cx * cellSize, x1 = fmin(x0 + cellSize, p->dims[0]);
+        double z0 = (double)cz * cellSize, z1 = fmin(z0 + cellSize, p->dims[0]);
+        double tExit = tMax;
+        if (d[0] != 0.0) tExit = fmin(tExit, ((d[0] > 0.0 ? x1 : x0) - o[0]) / d[0]);
+        if (d[2] != 0.0) tExit = fmin(tExit, ((d[2] > 0.0 ? z1 : z0) - o[2]) / d[2]);
+        if (tExit < t) tExit = t;
+        const float* mm = pyramidLevel(p, level) + (cz * dim + cx) * 2;
+        double yLow = fmin(o[1] + d[1] * t, o[1] + d[1] * tExit); // The ray is straight, so its lowest point is an end.
+        if (yLow <= mm[1]) {
+            if (level > 0) { // The ray may touch something in here: look at the children.
+                level--;
+                continue;
+            }
+            double tHit, slopeX, slopeZ;
+            if (raycastCell(land, cx, cz, o, d, t, tExit, &tHit, &slopeX, &slopeZ)) {
+                if (hit) {
+                    for (int k = 0; k < 3; k++) hit->position[k] = origin[k] + dir[k] * (float)tHit;
+                    // Convert the per-cell slopes back to world units for the normal.
+                    float n[3] = {(float)(-slopeX * toGrid), 1.0f, (float)(-slopeZ * toGrid)};
+                    float len = sqrtf(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+                    for (int k = 0; k < 3; k++) hit->normal[k] = n[k] / len;
+                    hit->distance = (float)tHit * sqrtf(dir[0]*dir[0] + dir[1]*dir[1] + dir[2]*dir[2]);
+                }
+                return 1;
+            }
+        }
+        if (tExit >= tMax) break; // Left the terrain.
+        t = tExit;
+        if (level < top) level++; // Try to skip a larger stretch from the next cell on.
+    }
+    return 0;
+}
+
+// computeEditNormalRows: Thread pool callback that recomputes the normals of region rows [begin, end).
+static void computeEditNormalRows(int begin, int end, void* userData) {
+    EditSpan* span = (EditSpan*)userData;
+    for (int z = begin; z < end; z++) computeNormalSpan(span->land, span->z0 + z, span->xBegin, span->xEnd);
+}
+
+// refitQuadtreeNode: Refreshes the vertical extent of the chunks and quadtree nodes overlapping a world-space xz rectangle.
+// Only branches that touch the rectangle are visited, so the cost follows the edit size rather than the node count.
+static void refitQuadtreeNode(Landscape* land, int nodeIndex, const float editMin[2], const float editMax[2]) {
+    LandscapeNode* node = &land->nodes[nodeIndex];
+    if (node->boxMax[0] < editMin[0] || node->boxMin[0] > editMax[0] || node->boxMax[2] < editMin[1] || node->boxMin[2] > editMax[1]) return;
+    if (node->chunk >= 0) {
+        LandscapeChunk* ch = &land->chunks[node->chunk];
+        chunkHeightRange(land, ch);
+        node->boxMin[1] = ch->boxMin[1];
+        node->boxMax[1] = ch->boxMax[1];
+        return;
+    }
+    node->boxMin[1] = 1e30f; node->boxMax[1] = -1e30f;
+    for (int i = 0; i < 4 && node->children[i] >= 0; i++) {
+        refitQuadtreeNode(land, node->children[i], editMin, editMax);
+        const LandscapeNode* c = &land->nodes[node->children[i]];
+        if (c->boxMin[1] < node->boxMin[1]) node->boxMin[1] = c->boxMin[1];
+        if (c->boxMax[1] > node->boxMax[1]) node->boxMax[1] = c->boxMax[1];
+    }
+}
+
+// landscapeModifyRegion: Reshapes the grid vertices in [x0, x1) x [z0, z1) with a brush and refreshes everything derived from them.
+// The brush returns each vertex's new height. Normals (and so slopes) are recomputed for the region plus a one-vertex
+// border, keeping the seam normals on the grid edge, then the cell attributes, the min/max pyramid, the horizons next
+// to the edit, the chunk and quadtree bounds, and the matching rows of the GPU vertex and horizon buffers are updated
+// for that area only, so the cost scales with the brush size rather than the terrain size. Horizons further out (up to
+// LANDSCAPE_HORIZON_DISTANCE) are queued and retraced by landscapeRender a bounded number of vertices per frame.
+// Materials need no update because the terrain shader derives them from height and normal. Returns 0 if the region
+// misses the grid.
+int landscapeModifyRegion(Landscape* land, int x0, int z0, int x1, int z1, LandscapeBrush brush, void* userData) {
+    int size = land->size;
+    // Clip the region to the grid.
+    if (x0 < 0) x0 = 0;
+    if (z0 < 0) z0 = 0;
+    if (x1 > size) x1 = size;
+    if (z1 > size) z1 = size;
+    if (x0 >= x1 || z0 >= z1) return 0;
+    // Apply the brush to the heightmap.
+    for (int z = z0; z < z1; z++) {
+        for (int x = x0; x < x1; x++) {
+            int idx = z * size + x;
+            land->elevationData[idx] = brush(x, z, land->elevationData[idx], userData);
+        }
+    }
+    // Normals depend on the neighbouring heights, so refresh a one-vertex border around the region too.
+    int nx0 = x0 > 0 ? x0 - 1 : 0, nz0 = z0 > 0 ? z0 - 1 : 0;
+    int nx1 = x1 < size ? x1 + 1 : size, nz1 = z1 < size ? z1 + 1 : size;
+    EditSpan span = {land, nz0, nx0, nx1};
+    threadPoolParallelFor(nz1 - nz0, EDIT_ROW_GRAIN, computeEditNormalRows, &span);
+    // Border vertices fell back to one-sided differences; give them back the seam normals the neighbouring tiles share.
+    if (nx0 == 0 || nz0 == 0 || nx1 == size || nz1 == size) computeSeamNormals(land, nx0, nz0, nx1, nz1);
+    // A vertex touches the cells on either side of it; refresh those cells, then their ancestors level by level.
+    LandscapeHeightPyramid* p = &land->pyramid;
+    if (p->minMax) {
+        int cx0 = x0 > 0 ? x0 - 1 : 0, cz0 = z0 > 0 ? z0 - 1 : 0;
+        int cx1 = x1 < p->dims[0] ? x1 : p->dims[0], cz1 = z1 < p->dims[0] ? z1 : p->dims[0];
+        for (int z = cz0; z < cz1; z++) pyramidBaseSpan(land, z, cx0, cx1);
+        for (int level = 1; level < p->levels; level++) {
+            cx0 >>= 1; cz0 >>= 1;
+            cx1 = ((cx1 - 1) >> 1) + 1; cz1 = ((cz1 - 1) >> 1) + 1;
+            reducePyramidRect(p, level, cx0, cz0, cx1, cz1);
+        }
+    }
+    // Cells with a refreshed corner get new attributes and placement bits.
+    if (land->attributes) {
+        int ax0 = nx0 > 0 ? nx0 - 1 : 0, az0 = nz0 > 0 ? nz0 - 1 : 0;
+        int ax1 = nx1 < size - 1 ? nx1 : size - 1, az1 = nz1 < size - 1 ? nz1 : size - 1;
+        for (int z = az0; z < az1; z++) buildAttributeSpan(land, z, ax0, ax1);
+    }
+    // Any vertex within the horizon search distance may look across the edit. The vertices right next to it change
+    // most, so retrace a fixed halo now; the rest of the reach, which grows with the grid resolution, is queued.
+    if (land->horizons) {
+        int halo = LANDSCAPE_HORIZON_EDIT_HALO;
+        int hx0 = x0 > halo ? x0 - halo : 0, hz0 = z0 > halo ? z0 - halo : 0;
+        int hx1 = x1 + halo < size ? x1 + halo : size, hz1 = z1 + halo < size ? z1 + halo : size;
+        EditSpan horizonSpan = {land, hz0, hx0, hx1};
+        threadPoolParallelFor(hz1 - hz0, HORIZON_ROW_GRAIN, buildHorizonRows, &horizonSpan);
+        uploadHorizonRows(land, hx0, hz0, hx1, hz1);
+        int reach = (int)(LANDSCAPE_HORIZON_DISTANCE / gridSpacing(land));
+        int rect[4] = {x0 > reach ? x0 - reach : 0, z0 > reach ? z0 - reach : 0,
+                       x1 + reach < size ? x1 + reach : size, z1 + reach < size ? z1 + reach : size};
+        int* dirty = land->horizonDirty;
+        if (dirty[1] < dirty[3]) { // Merge with the part of earlier edits not retraced yet.
+            for (int i = 0; i < 2; i++) {
+                if (dirty[i] < rect[i]) rect[i] = dirty[i];
+                if (dirty[i + 2] > rect[i + 2]) rect[i + 2] = dirty[i + 2];
+            }
+        }
+        for (int i = 0; i < 4; i++) dirty[i] = rect[i];
+    }
+    // Refresh the culling bounds of the chunks and quadtree nodes the edit touches.
+    if (land->nodes) {
+        float editMin[2] = {gridToWorld(land, 0, x0), gridToWorld(land, 1, z0)};
+        float editMax[2] = {gridToWorld(land, 0, x1 - 1), gridToWorld(land, 1, z1 - 1)};
+        refitQuadtreeNode(land, 0, editMin, editMax);
+    }
+    // Re-upload only the changed vertex range of each affected row.
+    if (land->vertexBuffer) {
+        int width = nx1 - nx0;
+        LandscapeVertex* row = (LandscapeVertex*)malloc(sizeof(LandscapeVertex) * width);
+        if (row) {
+            glBindBuffer(GL_ARRAY_BUFFER, land->vertexBuffer);
+            for (int z = nz0; z < nz1; z++) {
+                packVertices(land, (size_t)z * size + nx0, width, row);
+                glBufferSubData(GL_ARRAY_BUFFER, sizeof(LandscapeVertex) * ((size_t)z * size + nx0), sizeof(LandscapeVertex) * width, row);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            free(row);
+        }
+    }
+    return 1;
+}
+
 // landscapeDestroy: Frees all memory associated with a Landscape object.
 // Ensures proper resource management and prevents memory leaks in the terrain system.
 void landscapeDestroy(Landscape* land) {
     // Free all dynamically allocated memory for the landscape.
     if (land) {
+        if (land->vertexBuffer) glDeleteBuffers(1, &land->vertexBuffer);    // Free the vertex buffer.
+        if (land->gridBuffer) glDeleteBuffers(1, &land->gridBuffer);        // Free the grid coordinate buffer.
+        if (land->horizonBuffer) glDeleteBuffers(1, &land->horizonBuffer);  // Free the horizon stream.
+        for (int i = 0; i < land->lodMeshCount; i++) glDeleteBuffers(1, &land->lodMeshes[i].buffer); // Free the chunk LOD index buffers.
+        if (land->lodMeshes) free(land->lodMeshes);         // Free the LOD mesh cache.
+        if (land->chunks) free(land->chunks);               // Free the chunk grid.
+        if (land->nodes) free(land->nodes);                 // Free the chunk quadtree.
+        if (land->pyramid.minMax) free(land->pyramid.minMax); // Free the min/max height pyramid.
+        if (land->attributes) free(land->attributes);       // Free the cell attribute map.
+        if (land->horizons) free(land->horizons);           // Free the horizon angles.
         if (land->elevationData) free(land->elevationData); // Free heightmap data.
-        if (land->vertices) free(land->vertices);           // Free vertex positions.
         if (land->normals) free(land->normals);             // Free normals.
-        if (land->texCoords) free(land->texCoords);         // Free texture coordinates.
-        if (land->indices) free(land->indices);             // Free mesh indices.
         free(land);                                         // Free the Landscape struct itself.
     }
 }
@@ -460,34 +1802,150 @@ float landscapeGetSnowBlend(float h, float s) {
     return hFac * sFac;
 }
 
-// landscapeCreate: Allocates and initializes a new Landscape object, generating all geometry and data.
-// Orchestrates the entire procedural terrain pipeline, returning a ready-to-render landscape.
-Landscape* landscapeCreate() {
+// landscapeAllocate: Allocates a Landscape and its CPU-side arrays for a size x size grid.
+// gridX and gridZ are the global grid coordinates of vertex (0, 0); the home terrain is at (0, 0) and centered on
+// the world origin. Shared by every constructor; returns NULL on bad sizes or allocation failure.
+static Landscape* landscapeAllocate(int size, float scale, float height, int gridX, int gridZ) {
+    // Reject grids that are too small to form a mesh or too large for 32-bit indices.
+    if (size < LANDSCAPE_MIN_SIZE || size > LANDSCAPE_MAX_SIZE) return NULL;
     // Allocate memory for the Landscape struct.
     Landscape* land = (Landscape*)malloc(sizeof(Landscape));
     if (!land) return NULL;
-    // Allocate memory for the heightmap, vertices, normals, texture coordinates, and indices.
-    land->elevationData = (float*)malloc(sizeof(float) * LANDSCAPE_SIZE * LANDSCAPE_SIZE);
-    land->vertices = (float*)malloc(sizeof(float) * LANDSCAPE_SIZE * LANDSCAPE_SIZE * 3);
-    land->normals = (float*)malloc(sizeof(float) * LANDSCAPE_SIZE * LANDSCAPE_SIZE * 3);
-    land->texCoords = (float*)malloc(sizeof(float) * LANDSCAPE_SIZE * LANDSCAPE_SIZE * 2);
-    land->indices = (unsigned int*)malloc(sizeof(unsigned int) * (LANDSCAPE_SIZE - 1) * (LANDSCAPE_SIZE - 1) * 6);
-    land->vertexCount = LANDSCAPE_SIZE * LANDSCAPE_SIZE;
-    land->indexCount = (LANDSCAPE_SIZE - 1) * (LANDSCAPE_SIZE - 1) * 6;
+    land->size = size;
+    land->scale = scale;
+    land->height = height;
+    land->gridX = gridX;
+    land->gridZ = gridZ;
+    land->origin[0] = ((float)gridX / (size - 1) - 0.5f) * scale;
+    land->origin[1] = ((float)gridZ / (size - 1) - 0.5f) * scale;
+    // Allocate memory for the heightmap and normals; vertex x/z and texture coordinates follow from the grid index.
+    size_t verts = (size_t)size * size;
+    land->elevationData = (float*)malloc(sizeof(float) * verts);
+    land->normals = (float*)malloc(sizeof(float) * verts * 3);
+    land->vertexCount = (int)verts;
+    land->vertexBuffer = 0;
+    land->gridBuffer = 0;
+    land->horizonBuffer = 0;
+    land->chunks = NULL;
+    land->nodes = NULL;
+    land->lodMeshes = NULL;
+    land->pyramid.minMax = NULL;
+    land->attributes = NULL;
+    land->ruleCount = 0;
+    land->horizons = NULL;
+    land->horizonDirty[0] = land->horizonDirty[1] = land->horizonDirty[2] = land->horizonDirty[3] = 0; // Nothing pending
+    land->nodeCount = land->lodMeshCount = land->lodMeshCapacity = 0;
+    land->lodEnabled = 1;
+    land->stripsEnabled = 1;
+    land->shadowsEnabled = 1;
+    land->drawnChunks = land->drawnTriangles = 0;
     // Check for allocation failure and clean up if necessary.
-    if (!land->elevationData || !land->vertices || !land->normals || !land->texCoords || !land->indices) {
+    if (!land->elevationData || !land->normals) {
+        landscapeDestroy(land);
+        return NULL;
+    }
+    return land;
+}
+
+// landscapeFinish: Builds the LOD chunks, quadtree, height pyramid, attribute map, and (if 'horizons' is set) the
+// horizons once the grid data is filled in. Touches no GL state, so it may run on any thread; landscapeUpload does the
+// GPU side afterwards.
+static Landscape* landscapeFinish(Landscape* land, int horizons) {
+    // Split the grid into LOD chunks, build the culling quadtree over them, the ray casting pyramid, the attribute map,
+    // and the horizon angles for shadows and ambient occlusion.
+    if (!buildChunks(land) || !buildQuadtree(land) || !buildHeightPyramid(land) || !buildAttributeMap(land) ||
+        (horizons && !buildHorizons(land))) {
         landscapeDestroy(land);
         return NULL;
     }
+    // Return the fully constructed landscape.
+    return land;
+}
+
+// landscapeUpload: Creates the GPU buffers of a landscape built by landscapeCreateTile. Must run on the GL thread.
+// Does nothing if the buffers already exist.
+void landscapeUpload(Landscape* land) {
+    if (land && !land->vertexBuffer) uploadBuffers(land);
+}
+
+// landscapeCreate: Allocates and initializes a new Landscape object, generating all geometry and data.
+// Orchestrates the entire procedural terrain pipeline, returning a ready-to-render landscape.
+// size is the number of grid vertices per side, scale the world-space width, and height the vertical scale.
+// erosionIterations rounds of hydraulic and thermal erosion (0 = none) weather the noise, seeded by erosionSeed.
+Landscape* landscapeCreate(int size, float scale, float height, int erosionIterations, unsigned int erosionSeed) {
+    Landscape* land = landscapeAllocate(size, scale, height, 0, 0);
+    if (!land) return NULL;
     // Build the procedural heightmap.
     buildHeightField(land);
-    // Fill the vertex and texture coordinate arrays.
-    fillVerticesAndUVs(land);
-    // Fill the index array for mesh triangles.
-    fillIndices(land);
-    // Compute normals for lighting.
-    computeNormals(land);
-    // Return the fully constructed landscape.
+    // Weather it, if requested, before anything is derived from the heights.
+    if (erosionIterations > 0) {
+        if (erosionApply(land->elevationData, size, gridSpacing(land), erosionIterations, erosionSeed) < 0) {
+            landscapeDestroy(land);
+            return NULL;
+        }
+        // Put the outer ring back to the raw noise so it still meets the (uneroded) streamed tiles without cracks.
+        for (int i = 0; i < size; i++) {
+            land->elevationData[i] = noiseHeight(land, i, 0);
+            land->elevationData[(size_t)(size - 1) * size + i] = noiseHeight(land, i, size - 1);
+            land->elevationData[(size_t)i * size] = noiseHeight(land, 0, i);
+            land->elevationData[(size_t)i * size + size - 1] = noiseHeight(land, size - 1, i);
+        }
+    }
+    // Compute normals for lighting, matching the neighbouring tiles along the border.
+    landscapeCalculateNormals(land);
+    computeSeamNormals(land, 0, 0, size, size);
+    if (!landscapeFinish(land, 1)) return NULL;
+    // Upload the mesh to the GPU.
+    uploadBuffers(land);
+    return land;
+}
+
+// landscapeCreateTile: Generates the terrain tile (tileX, tileZ) next to the home terrain, (0, 0) being the home itself.
+// Tiles continue the home noise and share their border vertices and normals with neighbours of the same resolution,
+// but are not eroded. Without 'horizons' the tile is drawn without shadows until landscapeTraceHorizons and
+// landscapeSetHorizons add them. Only CPU-side data is built, so this may run on a worker thread; call
+// landscapeUpload on the GL thread before rendering the tile.
+Landscape* landscapeCreateTile(int size, float scale, float height, int tileX, int tileZ, int horizons) {
+    Landscape* land = landscapeAllocate(size, scale, height, tileX * (size - 1), tileZ * (size - 1));
+    if (!land) return NULL;
+    buildHeightField(land);
+    landscapeCalculateNormals(land);
+    computeSeamNormals(land, 0, 0, size, size);
+    return landscapeFinish(land, horizons);
+}
+
+// landscapeTraceHorizons: Traces the horizons of every vertex into a new array without attaching it to the landscape,
+// so it may run on a worker thread while the landscape is drawn. Returns NULL on allocation failure.
+unsigned char* landscapeTraceHorizons(const Landscape* land) {
+    Landscape view; // Only the fields the trace reads, none of which change once the landscape is built.
+    memset(&view, 0, sizeof(view));
+    view.size = land->size;
+    view.scale = land->scale;
+    view.vertexCount = land->vertexCount;
+    view.elevationData = land->elevationData;
+    return buildHorizons(&view) ? view.horizons : NULL;
+}
+
+// landscapeSetHorizons: Attaches horizons from landscapeTraceHorizons, taking ownership, and uploads them if the
+// landscape is already on the GPU. Must run on the GL thread.
+void landscapeSetHorizons(Landscape* land, unsigned char* horizons) {
+    if (!land || !horizons) return;
+    if (land->horizonBuffer) glDeleteBuffers(1, &land->horizonBuffer);
+    land->horizonBuffer = 0;
+    free(land->horizons);
+    land->horizons = horizons;
+    if (land->vertexBuffer) uploadHorizons(land);
+}
+
+// landscapeCreateFromData: Builds a landscape from previously generated heights and normals (e.g. the world cache).
+// Skips noise generation and normal computation; only chunking and the GPU upload run.
+Landscape* landscapeCreateFromData(int size, float scale, float height, const float* elevation, const float* normals) {
+    Landscape* land = landscapeAllocate(size, scale, height, 0, 0);
+    if (!land) return NULL;
+    memcpy(land->elevationData, elevation, sizeof(float) * land->vertexCount);
+    memcpy(land->normals, normals, sizeof(float) * land->vertexCount * 3);
+    if (!landscapeFinish(land, 1)) return NULL;
+    uploadBuffers(land);
     return land;
 }
-// --- END DETAILED COMMENTARY FOR landscape.c ---
\ No newline at end of file
+// --- END DETAILED COMMENTARY FOR landscape.c ---
@@ -10,17 +10,127 @@
 #include <GL/gl.h>
 #include <GL/glu.h>
 #endif
+#include <stddef.h>
 
 #define WATER_LEVEL -4.0f
+#define LANDSCAPE_PYRAMID_LEVELS 16 // Min/max pyramid levels; enough for LANDSCAPE_MAX_SIZE
+#define LANDSCAPE_MAX_PLACEMENT_RULES 16   // One bit per rule in LandscapeCellAttributes.placement
+#define LANDSCAPE_ATTRIBUTE_HEIGHT_STEPS 64 // Height quantization steps per world unit in the attribute map
+#define LANDSCAPE_HORIZON_DIRECTIONS 8      // Horizon angles stored per vertex (the eight grid directions)
+#define LANDSCAPE_HORIZON_DISTANCE 60.0f    // World-space distance searched for occluders in each direction
+#define LANDSCAPE_SHADOW_PENUMBRA 0.05f     // Sun elevation range (radians) over which a vertex fades into shadow
+#define LANDSCAPE_HORIZON_EDIT_HALO 8       // Vertices around an edit whose horizons are retraced at once
+#define LANDSCAPE_HORIZON_RETRACE_BUDGET 32768 // Vertices per frame retraced from the rest of an edit's horizon range
 
+// LandscapeChunk: One rectangular block of the terrain grid drawn with its own level of detail.
 typedef struct {
-    float* elevationData;   
-    float* vertices;        
-    float* normals;         
-    float* texCoords;       
-    unsigned int* indices;  
+    int x0, z0;               // Grid coordinate of the chunk's first vertex
+    int quadsX, quadsZ;       // Number of grid quads the chunk covers along x and z
+    int maxLevel;             // Coarsest LOD level the chunk's dimensions allow
+    int level;                // LOD level chosen for the current frame (0 = full detail)
+    float boxMin[3];          // World-space bounding box, used for culling and LOD distance
+    float boxMax[3];
+} LandscapeChunk;
+
+// LandscapeNode: Quadtree node grouping neighbouring chunks so whole regions can be culled at once.
+typedef struct {
+    float boxMin[3];          // Bounding box of every chunk below this node
+    float boxMax[3];
+    int children[4];          // Child node indices (-1 when absent)
+    int chunk;                // Chunk index for leaves, -1 for inner nodes
+} LandscapeNode;
+
+// LandscapeLodMesh: Shared index buffer for one chunk shape, LOD level, and seam-stitching pattern.
+typedef struct {
+    int quadsX, quadsZ;       // Chunk dimensions the indices were built for
+    int level;                // LOD level (vertex step = 1 << level)
+    int stitchMask;           // Edges snapped to the next coarser level (bit 0 = -x, 1 = +x, 2 = -z, 3 = +z)
+    int strips;               // Whether the buffer holds restart-separated triangle strips instead of a triangle list
+    GLuint buffer;            // GL_ELEMENT_ARRAY_BUFFER holding chunk-relative indices
+    int indexCount;           // Number of indices in the buffer
+    int triangleCount;        // Number of non-degenerate triangles drawn
+} LandscapeLodMesh;
+
+// LandscapeHeightPyramid: Min/max height mip pyramid over the grid cells, used to skip empty space when ray casting.
+typedef struct {
+    float* minMax;            // (min, max) height pairs for every level, finest level first
+    int levels;               // Number of levels; the last one is a single cell covering the whole grid
+    int dims[LANDSCAPE_PYRAMID_LEVELS];       // Cells per side at each level (level 0 = size - 1)
+    size_t offsets[LANDSCAPE_PYRAMID_LEVELS]; // Index of each level's first pair in minMax
+} LandscapeHeightPyramid;
+
+// LandscapeRayHit: Result of a ray cast against the terrain surface.
+typedef struct {
+    float position[3];        // World-space hit point
+    float normal[3];          // Unit normal of the triangle that was hit
+    float distance;           // Distance from the ray origin to the hit point
+} LandscapeRayHit;
+
+// LandscapeMaterial: Dominant surface class of a terrain cell, following the terrain shader's default material rules.
+typedef enum {
+    LANDSCAPE_MATERIAL_WATER,  // Under the beach band (submerged)
+    LANDSCAPE_MATERIAL_SAND,   // Beach band just above the water line
+    LANDSCAPE_MATERIAL_GRASS,  // Gentle ground
+    LANDSCAPE_MATERIAL_ROCK,   // Steep ground
+    LANDSCAPE_MATERIAL_COUNT
+} LandscapeMaterial;
+
+// LandscapeCellAttributes: Packed per-cell record of the attribute map (6 bytes), built once from heights and normals.
+typedef struct {
+    short aboveWater;         // Lowest corner height above WATER_LEVEL, in 1/LANDSCAPE_ATTRIBUTE_HEIGHT_STEPS units
+    unsigned short placement; // Bit i set when placement rule i accepts the cell
+    unsigned char slope;      // Steepest corner slope angle, 0 (flat) .. 255 (vertical)
+    unsigned char material;   // LandscapeMaterial
+} LandscapeCellAttributes;
+
+// LandscapeCellInfo: Decoded attributes of one cell, as returned by landscapeGetCellInfo.
+typedef struct {
+    float aboveWater;         // Lowest corner height above WATER_LEVEL
+    float slope;              // Steepest corner slope angle in radians (0 = flat, pi/2 = vertical)
+    int material;             // LandscapeMaterial
+    unsigned int placement;   // Placement rule bits
+} LandscapeCellInfo;
+
+// LandscapePlacementRule: Where one kind of object may be placed, tested against the attribute map.
+typedef struct {
+    float minAboveWater, maxAboveWater; // Allowed range of the cell's lowest point relative to WATER_LEVEL
+    float minSlope, maxSlope;           // Allowed range of the cell's steepest slope angle, in radians
+    unsigned int materials;             // Allowed materials as (1 << LandscapeMaterial) bits; 0 accepts any
+} LandscapePlacementRule;
+
+// LandscapeBrush: Returns the new height of grid vertex (x, z) given its current height; used by landscapeModifyRegion.
+typedef float (*LandscapeBrush)(int x, int z, float height, void* userData);
+
+typedef struct {
+    float* elevationData;     // Grid heights, row-major; x and z follow from the grid index
+    float* normals;           // Unit vertex normals (3 floats per vertex)
     int vertexCount;        
-    int indexCount;         
+    int size;                 // Grid resolution (vertices per side)
+    float scale;              // World-space width and depth of the terrain
+    float height;             // Vertical scale applied to the noise
+    int gridX, gridZ;         // Global grid coordinates of vertex (0, 0); (0, 0) for the home terrain
+    float origin[2];          // World-space x and z of vertex (0, 0)
+    LandscapeChunk* chunks;   // Chunk grid, row-major (chunksX per row)
+    int chunksX, chunksZ;     // Number of chunks along x and z
+    int chunkQuads;           // Grid quads per chunk side (edge chunks may be smaller)
+    LandscapeNode* nodes;     // Quadtree over the chunks, root at index 0
+    int nodeCount;
+    LandscapeHeightPyramid pyramid; // Min/max heights over the cells, for ray casting
+    LandscapeCellAttributes* attributes; // Per-cell attribute map, (size - 1) x (size - 1) cells, row-major
+    LandscapePlacementRule rules[LANDSCAPE_MAX_PLACEMENT_RULES]; // Registered placement rules (bit i = rules[i])
+    int ruleCount;
+    unsigned char* horizons;  // Horizon elevation angles, LANDSCAPE_HORIZON_DIRECTIONS per vertex, 0..255 = 0..pi/2
+    int horizonDirty[4];      // Vertices [x0, x1) x [z0, z1) still to retrace after edits, as {x0, z0, x1, z1}; empty if z0 >= z1
+    LandscapeLodMesh* lodMeshes; // Lazily built index buffers shared by all chunks of the same shape
+    int lodMeshCount, lodMeshCapacity;
+    int lodEnabled;           // Whether chunked LOD rendering is used (otherwise every chunk is drawn at full detail)
+    int stripsEnabled;        // Whether terrain is drawn as primitive-restart triangle strips (when the GL supports it)
+    int shadowsEnabled;       // Whether the horizon shadows and ambient occlusion are applied
+    int drawnChunks;          // Chunks drawn in the last frame
+    int drawnTriangles;       // Triangles submitted in the last frame
+    GLuint vertexBuffer;      // Packed height/normal VBO (LandscapeVertex, 8 bytes per vertex)
+    GLuint gridBuffer;        // Grid coordinates for one chunk's rows, shared by every chunk
+    GLuint horizonBuffer;     // Copy of horizons for the terrain shader, which does the light and occlusion lookups
 } Landscape;
 
 extern GLuint rockTexture;
@@ -29,17 +139,40 @@ extern GLuint boulderTexture;
 extern GLuint barkTexture;
 extern GLuint leafTexture;
 
-Landscape* landscapeCreate();                  
+Landscape* landscapeCreate(int size, float scale, float height, int erosionIterations, unsigned int erosionSeed);
+Landscape* landscapeCreateFromData(int size, float scale, float height, const float* elevation, const float* normals);
+Landscape* landscapeCreateTile(int size, float scale, float height, int tileX, int tileZ, int horizons);
+unsigned char* landscapeTraceHorizons(const Landscape* landscape);
+void landscapeSetHorizons(Landscape* landscape, unsigned char* horizons);
+void landscapeUpload(Landscape* landscape);
 void landscapeGenerateHeightMap(Landscape* landscape);  
 void landscapeCalculateNormals(Landscape* landscape);   
+void landscapeComputeMeshNormals(const float* vertices, int vertexCount, const unsigned int* indices, int indexCount, float* normals);
 void landscapeRender(Landscape* landscape, int weatherType);  
 void landscapeDestroy(Landscape* landscape);    
 float landscapeGetHeight(Landscape* landscape, float x, float z);  
-void landscapeRenderWater(float waterLevel, Landscape* landscape, float dayTime);  
+void landscapeGetHeightBatch(const Landscape* landscape, const float* xs, const float* zs, int count, float* outHeights);
+int landscapeAddPlacementRule(Landscape* landscape, const LandscapePlacementRule* rule);
+void landscapeGetPlacementBatch(const Landscape* landscape, const float* xs, const float* zs, int count, unsigned int* outMasks);
+void landscapeGetCellInfo(const Landscape* landscape, float x, float z, LandscapeCellInfo* info);
+int landscapeModifyRegion(Landscape* landscape, int x0, int z0, int x1, int z1, LandscapeBrush brush, void* userData);
+void landscapePrintIndexStats(const Landscape* landscape);
+int landscapeDrawsStrips(const Landscape* landscape);
+float landscapeIndexACMR(const unsigned int* indices, int count, int strips, int cacheSize);
+int landscapeRaycast(const Landscape* landscape, const float origin[3], const float dir[3], LandscapeRayHit* hit);
+void landscapeRenderWater(float waterLevel, Landscape* landscape, float dayTime, float time);  
 float landscapeGetSnowBlend(float height, float slope);  
 float landscapeSmoothStep(float edge0, float edge1, float x);  
 
+// Defaults passed to landscapeCreate; consumers read the live values from the Landscape struct.
 #define LANDSCAPE_SIZE 128       
 #define LANDSCAPE_SCALE 200.0f   
 #define LANDSCAPE_HEIGHT 50.0f   
+#define LANDSCAPE_MIN_SIZE 16     // Smallest accepted grid resolution
+#define LANDSCAPE_MAX_SIZE 8192   // Largest accepted grid resolution (keeps index counts in range)
+#define LANDSCAPE_CHUNK_QUADS 32  // Minimum grid quads per chunk side
+#define LANDSCAPE_MAX_LOD 5       // Coarsest LOD level (vertex step 32)
+#define LANDSCAPE_LOD_RANGE 1.5f  // Distance, in chunk widths, covered by full detail before the first LOD switch
+#define LANDSCAPE_CACHE_BAND 7    // Grid cells per vertex-cache band in index buffers (two band rows fit a 16-entry cache)
+#define LANDSCAPE_RESTART_INDEX 0xFFFFFFFFu // Primitive restart index separating terrain triangle strips
 #endif
\ No newline at end of file
@@ -63,6 +63,11 @@
 #include "grass.h"
 #include "sound.h"
 #include "boulder.h"
+#include "threadpool.h"
+#include "world_cache.h"
+#include "erosion.h"
+#include "terrain_stream.h"
+#include "rng.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -101,6 +106,7 @@ static int showAxes = 0;   // Display coordinate axes
 
 // Landscape system instance
 Landscape* landscape = NULL; // Main terrain and elevation data
+TerrainStream* terrainStream = NULL; // Terrain tiles streamed around the camera (NULL with --nostream)
 
 // Time management for smooth animations
 static float lastTime = 0;     // Previous frame time
@@ -124,7 +130,13 @@ float treeSwayAngle = 0.0f; // Current tree sway angle for wind effects
 
 // Weather system parameters
 static int snowOn = 0;      // Snow particle system toggle
+static ParticleSystem* weather = NULL; // Falling snow or rain, following the weather type
 static int weatherType = 0; // Weather type (0 = Fall, 1 = Winter)
+#define WEATHER_PARTICLES_MIN 10000   // Fewest weather particles the [ key goes down to
+#define WEATHER_PARTICLES_MAX 2000000 // Most weather particles the ] key goes up to
+static int weatherGroundWindow[2] = {0, 0}; // Weather ground window, in quarter-terrain steps from the home terrain
+static int weatherGroundTiles = -1;         // Resident tiles when the window was last filled (-1 to refill it)
+static float* weatherGround = NULL;         // Heights of a weather ground window off the home terrain
 
 // Audio system
 static int ambientSoundOn = 1; // Ambient sound toggle
@@ -428,8 +440,12 @@ void display() {
         glDepthMask(GL_TRUE);
     }
     
-    // Render main terrain landscape
+    // Bring the streamed tiles up to date for this camera position, then render the main terrain and the tiles
+    terrainStreamUpdate(terrainStream, camera->fpPosition[0], camera->fpPosition[2]);
+    // Cull the grass on the GPU now, so the survivor counts are ready by the time the grass is drawn
+    grassSystemCull();
     landscapeRender(landscape, weatherType);
+    terrainStreamRender(terrainStream, weatherType);
     
     // Calculate sun position and lighting parameters
     float timeNormalized = dayTime / 24.0f;
@@ -461,13 +477,15 @@ void display() {
     
     // Render landscape objects (trees, rocks, etc.)
     renderLandscapeObjects(landscape);
+    terrainStreamRenderObjects(terrainStream);
     
     // Render water surface with transparency
     glDisable(GL_LIGHTING);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glDepthMask(GL_FALSE);
-    landscapeRenderWater(WATER_LEVEL, landscape, dayTime);
+    landscapeRenderWater(WATER_LEVEL, landscape, dayTime, waterTime);
+    terrainStreamRenderWater(terrainStream, WATER_LEVEL, dayTime, waterTime);
     glDepthMask(GL_TRUE);
     
     // Render coordinate axes if enabled
@@ -486,30 +504,35 @@ void display() {
     }
     
     // Render UI overlay with status information
+    int tilesLoaded, tilesPending;
+    terrainStreamGetStats(terrainStream, &tilesLoaded, &tilesPending);
     glDisable(GL_DEPTH_TEST);
     glColor3f(1,1,1);
     glWindowPos2i(5, glutGet(GLUT_WINDOW_HEIGHT) - 20);
-    Print("Time: %02d:%02d  Weather: %s", 
+    Print("Time: %02d:%02d  Weather: %s   |   Terrain: %dx%d  LOD: %s  Strips: %s  Shadows: %s  Chunks: %d  Triangles: %d  Tiles: %d (%d pending)  Grass: %d (%d verts, %s culling)", 
           (int)dayTime, (int)((dayTime-(int)dayTime)*60),
-          weatherType == 1 ? "Winter" : "Fall");
+          weatherType == 1 ? "Winter" : "Fall",
+          landscape->size, landscape->size, landscape->lodEnabled ? "On" : "Off",
+          landscapeDrawsStrips(landscape) ? "On" : landscape->stripsEnabled ? "Off (needs GL 3.1)" : "Off",
+          landscape->shadowsEnabled ? "On" : "Off",
+          landscape->drawnChunks, landscape->drawnTriangles, tilesLoaded, tilesPending, grassSystemDrawnBlades(), grassSystemDrawnVertices(),
+          grassSystemCulledOnGpu() ? "GPU" : "CPU");
     
     // Render detailed status information
     int y = 5;
     glWindowPos2i(5, y);
-    Print("Angle=%d,%d  Dim=%.1f  View=%s   |   Wireframe=%d   |   Axes=%d   |   TimeAnim: %s  Speed: %.1fx   |   Fog: %s  Snow: %s  |   Sound: %s",
+    Print("Angle=%d,%d  Dim=%.1f  View=%s   |   Wireframe=%d   |   Axes=%d   |   TimeAnim: %s  Speed: %.1fx   |   Fog: %s  %s: %s (%d)  |   Sound: %s",
         th, ph, dim, camera->mode == CAMERA_MODE_FREE_ORBIT ? "Free Orbit" : "First Person",
         wireframe,
         showAxes,
         animateTime ? "On" : "Off", timeSpeed,
         fogEnabled ? "On" : "Off",
-        snowOn ? "On" : "Off",
+        weatherType == 1 ? "Snow" : "Rain", snowOn ? "On" : "Off", particleSystemCapacity(weather),
         ambientSoundOn ? "On" : "Off");
     glEnable(GL_DEPTH_TEST);
     
-    // Render weather particles if enabled
-    if (snowOn) {
-        particleSystemRender();
-    }
+    // Render weather particles (a disabled system draws nothing)
+    particleSystemRender(weather);
     
     // Swap buffers for double buffering
     glutSwapBuffers();
@@ -626,6 +649,66 @@ void special(int key, int x, int y) {
     glutPostRedisplay();
 }
 
+/*
+ * Crater Brush
+ *
+ * Terrain brush that sinks a smooth bowl centered on a world-space point.
+ * The depth falls off as (1 - d^2)^2 with the distance d from the center
+ * (relative to the radius), so the crater blends into the ground at its edge.
+ */
+#define CRATER_RADIUS 6.0f  // Crater radius in world units
+#define CRATER_DEPTH 2.5f   // Depth at the crater center
+
+typedef struct {
+    float centerX, centerZ; // World-space crater center
+} CraterBrush;
+
+static float craterBrush(int x, int z, float height, void* userData) {
+    const CraterBrush* crater = (const CraterBrush*)userData;
+    // Same grid-to-world mapping as the terrain vertices
+    float wx = landscape->origin[0] + (float)x * landscape->scale / (landscape->size - 1);
+    float wz = landscape->origin[1] + (float)z * landscape->scale / (landscape->size - 1);
+    float dx = (wx - crater->centerX) / CRATER_RADIUS;
+    float dz = (wz - crater->centerZ) / CRATER_RADIUS;
+    float d2 = dx * dx + dz * dz;
+    if (d2 >= 1.0f) return height;
+    float falloff = 1.0f - d2;
+    return height - CRATER_DEPTH * falloff * falloff;
+}
+
+/*
+ * Crater Placement
+ *
+ * Casts a ray from the camera through the center of the view and, where it
+ * meets the terrain, sinks a crater. Only the grid rectangle under the brush
+ * is rebuilt, and the same rectangle of the particle heightmap is refreshed.
+ */
+static void makeCrater() {
+    float dir[3];
+    for (int i = 0; i < 3; i++) dir[i] = camera->lookAt[i] - camera->fpPosition[i];
+    LandscapeRayHit hit;
+    if (!landscapeRaycast(landscape, camera->fpPosition, dir, &hit)) return;
+    CraterBrush crater = {hit.position[0], hit.position[2]};
+    // Grid rectangle covered by the brush (vertex x sits at origin + x * scale / (size - 1))
+    float toGrid = (landscape->size - 1) / landscape->scale;
+    float gx = (hit.position[0] - landscape->origin[0]) * toGrid;
+    float gz = (hit.position[2] - landscape->origin[1]) * toGrid;
+    float r = CRATER_RADIUS * toGrid;
+    int x0 = (int)floorf(gx - r), z0 = (int)floorf(gz - r);
+    int x1 = (int)ceilf(gx + r) + 1, z1 = (int)ceilf(gz + r) + 1;
+    if (x0 < 0) x0 = 0;
+    if (z0 < 0) z0 = 0;
+    if (x1 > landscape->size) x1 = landscape->size;
+    if (z1 > landscape->size) z1 = landscape->size;
+    if (landscapeModifyRegion(landscape, x0, z0, x1, z1, craterBrush, &crater)) {
+        if (weatherGroundWindow[0] == 0 && weatherGroundWindow[1] == 0) {
+            particleSystemUpdateHeightmapRegion(landscape->elevationData, x0, z0, x1, z1);
+        } else {
+            weatherGroundTiles = -1; // The window off the home terrain may overlap the crater; fill it again.
+        }
+    }
+}
+
 /*
  * Keyboard Event Handler
  *
@@ -652,6 +735,7 @@ void keyboard(unsigned char key, int x, int y) {
         case 'e':
         case 'E': // Toggle weather type (Fall/Winter)
             weatherType = !weatherType;
+            particleSystemSetSpecies(weather, weatherType == 1 ? &particleSpeciesSnow : &particleSpeciesRain);
             break;
             
         case 'w':
@@ -762,7 +846,38 @@ void keyboard(unsigned char key, int x, int y) {
             
         case 'n': // Toggle snow/rain particles
             snowOn = !snowOn;
-            particleSystemSetEnabled(snowOn);
+            particleSystemSetEnabled(weather, snowOn);
+            break;
+            
+        case '[': // Halve the number of weather particles
+        case ']': // Double the number of weather particles
+            {
+                int count = particleSystemCapacity(weather);
+                count = key == ']' ? count * 2 : count / 2;
+                if (count < WEATHER_PARTICLES_MIN) count = WEATHER_PARTICLES_MIN;
+                if (count > WEATHER_PARTICLES_MAX) count = WEATHER_PARTICLES_MAX;
+                if (!particleSystemResize(weather, count)) fprintf(stderr, "Could not resize the weather to %d particles\n", count);
+            }
+            break;
+            
+        case 'o': // Toggle chunked terrain level of detail
+            landscape->lodEnabled = !landscape->lodEnabled;
+            break;
+            
+        case 'p': // Toggle triangle strips for the terrain
+            landscape->stripsEnabled = !landscape->stripsEnabled;
+            break;
+            
+        case 'h': // Toggle terrain horizon shadows and ambient occlusion
+            landscape->shadowsEnabled = !landscape->shadowsEnabled;
+            break;
+            
+        case 'g': // Toggle GPU grass culling
+            grassSystemSetGpuCulling(!grassSystemGpuCulling());
+            break;
+            
+        case 'c': // Blast a crater where the camera is looking
+            makeCrater();
             break;
             
         case 'm': // Toggle ambient sound
@@ -778,6 +893,64 @@ void keyboard(unsigned char key, int x, int y) {
     glutPostRedisplay();
 }
 
+/*
+ * Weather Origin
+ *
+ * Finds the point the weather box follows: the orbit target in orbit mode (the eye is dim units away from it, well
+ * outside the box) and the eye in first-person mode. The height is the ground's there, so the box's vertical offsets
+ * start at the terrain rather than at the eye.
+ *
+ * Parameters:
+ * - origin: Receives the world-space point
+ */
+static void weatherOrigin(float origin[3]) {
+    const float* focus = camera->mode == CAMERA_MODE_FREE_ORBIT ? camera->lookAt : camera->fpPosition;
+    origin[0] = focus[0];
+    origin[2] = focus[2];
+    origin[1] = terrainStream ? terrainStreamGetHeight(terrainStream, focus[0], focus[2]) : landscapeGetHeight(landscape, focus[0], focus[2]);
+}
+
+/*
+ * Weather Ground
+ *
+ * The weather particles land on a heightmap window as large as the home terrain. Over the home terrain it is the home
+ * heightmap itself, which crater edits update in place. When the weather origin heads onto the streamed tiles, the
+ * window moves with it in quarter-terrain steps and is filled from the tiles' heights, so the weather keeps falling
+ * around the camera; it is filled again whenever another tile arrives or a crater changes the ground under it.
+ *
+ * Parameters:
+ * - origin: The point the weather box follows (see weatherOrigin)
+ */
+static void updateWeatherGround(const float origin[3]) {
+    if (!terrainStream) return; // Without tiles the home terrain is all the ground there is.
+    int size = landscape->size;
+    float step = landscape->scale * 0.25f;
+    int window[2];
+    for (int a = 0; a < 2; a++) {
+        window[a] = (int)lrintf((origin[a * 2] - landscape->origin[a] - landscape->scale * 0.5f) / step);
+    }
+    int home = window[0] == 0 && window[1] == 0;
+    int resident, pending;
+    terrainStreamGetStats(terrainStream, &resident, &pending);
+    if (window[0] == weatherGroundWindow[0] && window[1] == weatherGroundWindow[1] && (home || resident == weatherGroundTiles)) return;
+    float minX = landscape->origin[0] + window[0] * step, minZ = landscape->origin[1] + window[1] * step;
+    if (home) {
+        particleSystemUploadHeightmap(landscape->elevationData, size, landscape->scale, minX, minZ);
+    } else {
+        if (!weatherGround && !(weatherGround = (float*)malloc(sizeof(float) * size * size))) return;
+        float spacing = landscape->scale / (size - 1);
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) {
+                weatherGround[z * size + x] = terrainStreamGetHeight(terrainStream, minX + x * spacing, minZ + z * spacing);
+            }
+        }
+        particleSystemUploadHeightmap(weatherGround, size, landscape->scale, minX, minZ);
+    }
+    weatherGroundWindow[0] = window[0];
+    weatherGroundWindow[1] = window[1];
+    weatherGroundTiles = resident;
+}
+
 /*
  * Idle Function
  *
@@ -806,15 +979,207 @@ void idle() {
         waterTime += deltaTime;
     }
     
-    // Update particle system if enabled
-    if (snowOn) {
-        particleSystemUpdate(deltaTime);
-    }
+    // Update weather particles around what the camera looks at (a disabled system costs nothing)
+    float origin[3];
+    weatherOrigin(origin);
+    updateWeatherGround(origin);
+    particleSystemFollow(weather, origin);
+    particleSystemUpdate(weather, deltaTime);
     
     // Request redisplay for continuous rendering
     glutPostRedisplay();
 }
 
+/*
+ * World Cache Loading
+ *
+ * Restores the terrain, grass, trees, and boulders from the binary world cache
+ * when it was written for the same seed and parameters. Grass instances are
+ * uploaded straight from the memory-mapped file; everything else is copied.
+ *
+ * Returns: 1 if the world was loaded, 0 if it has to be generated
+ */
+static int loadWorld(const WorldCacheKey* key) {
+    WorldCache cache;
+    if (!worldCacheOpen(&cache, WORLD_CACHE_FILE, key)) return 0;
+    size_t elevBytes, normalBytes, grassBytes, treeBytes, boulderBytes;
+    const float* elevation = (const float*)worldCacheSection(&cache, WORLD_CACHE_ELEVATION, &elevBytes);
+    const float* normals = (const float*)worldCacheSection(&cache, WORLD_CACHE_NORMALS, &normalBytes);
+    const void* grass = worldCacheSection(&cache, WORLD_CACHE_GRASS, &grassBytes);
+    const TreeInstance* trees = (const TreeInstance*)worldCacheSection(&cache, WORLD_CACHE_TREES, &treeBytes);
+    const BoulderInstance* rocks = (const BoulderInstance*)worldCacheSection(&cache, WORLD_CACHE_BOULDERS, &boulderBytes);
+    
+    // Sanity-check the section sizes against the key before trusting the data
+    size_t verts = (size_t)key->size * key->size;
+    if (elevBytes != verts * sizeof(float) || normalBytes != verts * 3 * sizeof(float)) {
+        worldCacheClose(&cache);
+        return 0;
+    }
+    landscape = landscapeCreateFromData(key->size, key->scale, key->height, elevation, normals);
+    if (landscape) {
+        grassSystemUpload(grass, grassBytes);
+        loadLandscapeObjects(trees, (int)(treeBytes / sizeof(TreeInstance)));
+        loadBoulders(rocks, (int)(boulderBytes / sizeof(BoulderInstance)));
+    }
+    worldCacheClose(&cache);
+    return landscape != NULL;
+}
+
+/*
+ * World Generation
+ *
+ * Generates the terrain and all object placements from the seed, then writes
+ * them to the world cache so the next launch can skip this work.
+ *
+ * Returns: 1 on success, 0 if the landscape could not be created
+ */
+static int generateWorld(const WorldCacheKey* key) {
+    landscape = landscapeCreate(key->size, key->scale, key->height, key->erosionIterations, key->seed);
+    if (!landscape) return 0;
+    
+    // Generate and upload the grass blades, keeping the CPU copy for the cache. The home terrain is
+    // tile (0, 0) of the streamed world and is seeded the same way as every other tile.
+    size_t grassBytes = 0;
+    void* grass = grassSystemGenerate(landscape, landscape->scale, key->grassBlades,
+                                      terrainTileSeed(key->seed, 0, 0, TERRAIN_SEED_GRASS), &grassBytes);
+    grassSystemUpload(grass, grassBytes);
+    
+    // Place trees, then boulders (boulders avoid the trees)
+    initLandscapeObjects(landscape, terrainTileSeed(key->seed, 0, 0, TERRAIN_SEED_TREES));
+    initBoulders(landscape, terrainTileSeed(key->seed, 0, 0, TERRAIN_SEED_BOULDERS));
+    
+    // Save everything for the next launch
+    int boulderCount = 0;
+    const BoulderInstance* rocks = getBoulders(&boulderCount);
+    const void* sections[WORLD_CACHE_SECTION_COUNT] = {
+        landscape->elevationData, landscape->normals, grass, treeInstances, rocks
+    };
+    size_t sizes[WORLD_CACHE_SECTION_COUNT] = {
+        sizeof(float) * landscape->vertexCount,
+        sizeof(float) * landscape->vertexCount * 3,
+        grassBytes,
+        sizeof(TreeInstance) * numTrees,
+        sizeof(BoulderInstance) * boulderCount
+    };
+    if (!worldCacheWrite(WORLD_CACHE_FILE, key, sections, sizes)) {
+        fprintf(stderr, "Could not write world cache %s\n", WORLD_CACHE_FILE);
+    }
+    free(grass);
+    return 1;
+}
+
+/*
+ * Ray Cast Benchmark
+ *
+ * Fires rayCount random rays at the terrain through landscapeRaycast and
+ * prints the throughput. Ray origins are spread over the terrain footprint
+ * above the highest peak, with random, mostly downward directions, so the
+ * rays cover everything from short vertical drops to long grazing sweeps.
+ * The rays come from the seed, so runs with the same seed fire the same rays.
+ */
+static void runRaycastBenchmark(int rayCount, unsigned int seed) {
+    float* rays = (float*)malloc(sizeof(float) * 6 * rayCount);
+    if (!rays) return;
+    float s = landscape->scale;
+    Rng rng;
+    rngSeed(&rng, seed, 0);
+    for (int i = 0; i < rayCount; i++) {
+        float* r = &rays[i * 6];
+        r[0] = rngRange(&rng, -0.5f, 0.5f) * s;                              // Origin x over the footprint
+        r[1] = landscape->height * (1.0f + rngFloat(&rng));                  // Origin height above the peaks
+        r[2] = rngRange(&rng, -0.5f, 0.5f) * s;                              // Origin z over the footprint
+        r[3] = rngRange(&rng, -1.0f, 1.0f);                                  // Direction x
+        r[4] = -rngFloat(&rng) * 0.6f - 0.01f;                               // Direction y (always downward)
+        r[5] = rngRange(&rng, -1.0f, 1.0f);                                  // Direction z
+    }
+    int hits = 0;
+    double distance = 0.0;
+    LandscapeRayHit hit;
+    int start = glutGet(GLUT_ELAPSED_TIME);
+    for (int i = 0; i < rayCount; i++) {
+        if (landscapeRaycast(landscape, &rays[i * 6], &rays[i * 6 + 3], &hit)) {
+            hits++;
+            distance += hit.distance;
+        }
+    }
+    int elapsed = glutGet(GLUT_ELAPSED_TIME) - start;
+    printf("Ray cast benchmark: %d rays against a %dx%d terrain in %d ms (%.2f million rays/s)\n",
+           rayCount, landscape->size, landscape->size, elapsed, elapsed > 0 ? rayCount / (elapsed * 1000.0) : 0.0);
+    printf("  %d hits (%.1f%%), mean hit distance %.2f\n", hits, 100.0 * hits / rayCount, hits ? distance / hits : 0.0);
+    free(rays);
+}
+
+/*
+ * Erosion Benchmark
+ *
+ * Runs 'iterations' hydraulic erosion iterations, each followed by a thermal
+ * pass, on a copy of the terrain heights and prints the droplet throughput.
+ * A checksum of the result is printed as well: it must not change with the
+ * number of worker threads for the same seed.
+ */
+static void runErosionBenchmark(int iterations, unsigned int seed) {
+    int size = landscape->size;
+    float cellSize = landscape->scale / (size - 1);
+    float* heights = (float*)malloc(sizeof(float) * landscape->vertexCount);
+    float* scratch = (float*)malloc(sizeof(float) * landscape->vertexCount);
+    if (!heights || !scratch) {
+        free(heights);
+        free(scratch);
+        return;
+    }
+    memcpy(heights, landscape->elevationData, sizeof(float) * landscape->vertexCount);
+    long long droplets = 0;
+    int hydraulicMs = 0, thermalMs = 0;
+    for (int i = 0; i < iterations; i++) {
+        int start = glutGet(GLUT_ELAPSED_TIME);
+        droplets += erosionHydraulic(heights, size, cellSize, i, seed);
+        int mid = glutGet(GLUT_ELAPSED_TIME);
+        erosionThermal(heights, scratch, size, cellSize);
+        hydraulicMs += mid - start;
+        thermalMs += glutGet(GLUT_ELAPSED_TIME) - mid;
+    }
+    // FNV-1a over the eroded heights, for comparing runs
+    unsigned int hash = 2166136261u;
+    const unsigned char* bytes = (const unsigned char*)heights;
+    for (size_t i = 0; i < sizeof(float) * landscape->vertexCount; i++) hash = (hash ^ bytes[i]) * 16777619u;
+    printf("Erosion benchmark: %d iterations on a %dx%d terrain with %d threads\n", iterations, size, size, threadPoolSize());
+    printf("  hydraulic: %lld droplets in %d ms (%.2f million droplets/s)\n",
+           droplets, hydraulicMs, hydraulicMs > 0 ? droplets / (hydraulicMs * 1000.0) : 0.0);
+    printf("  thermal: %d passes in %d ms (%.1f million cells/s)\n",
+           iterations, thermalMs, thermalMs > 0 ? (double)iterations * landscape->vertexCount / (thermalMs * 1000.0) : 0.0);
+    printf("  checksum %08x\n", hash);
+    free(heights);
+    free(scratch);
+}
+
+/*
+ * Particle Benchmark
+ *
+ * Sweeps the weather system from 10,000 to 2,000,000 particles, resizing it
+ * in place, and times 'steps' simulation steps of 1/60 s at each count. The
+ * GPU is drained before and after each run, so the time covers the transform
+ * feedback work and not just its submission.
+ */
+static void runParticleBenchmark(int steps) {
+    static const int counts[] = {10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000};
+    particleSystemSetEnabled(weather, 1);
+    printf("Particle benchmark: %d update steps per particle count\n", steps);
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        if (!particleSystemResize(weather, counts[c])) {
+            fprintf(stderr, "Could not resize the weather to %d particles\n", counts[c]);
+            break;
+        }
+        particleSystemUpdate(weather, 1.0f / 60.0f); // Warm up at the new size
+        glFinish();
+        int start = glutGet(GLUT_ELAPSED_TIME);
+        for (int i = 0; i < steps; i++) particleSystemUpdate(weather, 1.0f / 60.0f);
+        glFinish();
+        int elapsed = glutGet(GLUT_ELAPSED_TIME) - start;
+        printf("  %7d particles: %.3f ms per step (%.1f million particles/s)\n", counts[c], (double)elapsed / steps,
+               elapsed > 0 ? (double)counts[c] * steps / (elapsed * 1000.0) : 0.0);
+    }
+}
+
 /*
  * Main Application Entry Point
  *
@@ -825,6 +1190,13 @@ void idle() {
  * Parameters:
  * - argc: Number of command line arguments
  * - argv: Array of command line argument strings
+ *         (optional arguments: terrain grid resolution and world seed, e.g. "./final 512 7";
+ *          "--erode N" weathers the terrain with N erosion iterations, "--threads N" sets the
+ *          worker thread count, "--nostream" keeps the world to the home terrain, "--particles N"
+ *          sets the number of weather particles;
+ *          "--raybench [rays]" runs the terrain ray cast benchmark, "--erosionbench [iterations]"
+ *          the erosion benchmark, "--particlebench [steps]" the particle count sweep, and "--acmr"
+ *          prints the terrain index vertex cache statistics; each of these four exits afterwards)
  *
  * Returns: 0 on successful execution, 1 on error
  */
@@ -848,24 +1220,93 @@ int main(int argc, char* argv[]) {
     }
 #endif
     
-    // Initialize landscape system
-    landscape = landscapeCreate();
-    if (!landscape) {
+    // Pull out the named options so the positional arguments keep their meaning
+    int threadCount = 0;
+    int rayBenchCount = 0;
+    int erosionBenchIterations = 0;
+    int erosionIterations = 0;
+    int indexStats = 0;
+    int streamTiles = 1;
+    int particleCount = 20000;
+    int particleBenchSteps = 0;
+    int positional = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--acmr") == 0) {
+            indexStats = 1;
+        } else if (strcmp(argv[i], "--raybench") == 0) {
+            rayBenchCount = 2000000;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) rayBenchCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--erode") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Usage: --erode N (number of erosion iterations)\n");
+                return 1;
+            }
+            erosionIterations = atoi(argv[++i]);
+            if (erosionIterations < 0) erosionIterations = 0;
+        } else if (strcmp(argv[i], "--erosionbench") == 0) {
+            erosionBenchIterations = 10;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) erosionBenchIterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Usage: --threads N (number of worker threads)\n");
+                return 1;
+            }
+            threadCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--nostream") == 0) {
+            streamTiles = 0;
+        } else if (strcmp(argv[i], "--particles") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Usage: --particles N (number of weather particles)\n");
+                return 1;
+            }
+            particleCount = atoi(argv[++i]);
+            if (particleCount < 1) particleCount = 1;
+        } else if (strcmp(argv[i], "--particlebench") == 0) {
+            particleBenchSteps = 100;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) particleBenchSteps = atoi(argv[++i]);
+        } else {
+            argv[positional++] = argv[i];
+        }
+    }
+    argc = positional;
+    
+    // Start the worker thread pool used for terrain generation (one thread per core unless --threads says otherwise)
+    threadPoolInit(threadCount);
+    
+    // Pick the terrain resolution (vertices per side) from the command line, or use the default
+    int terrainSize = LANDSCAPE_SIZE;
+    if (argc > 1) {
+        terrainSize = atoi(argv[1]);
+        if (terrainSize < LANDSCAPE_MIN_SIZE || terrainSize > LANDSCAPE_MAX_SIZE) {
+            fprintf(stderr, "Terrain size must be between %d and %d\n", LANDSCAPE_MIN_SIZE, LANDSCAPE_MAX_SIZE);
+            return 1;
+        }
+    }
+    
+    // The world seed drives all random placement, the sky, and the weather
+    unsigned int worldSeed = argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : 1;
+    
+    // Load the landscape, 500,000 grass blades, trees and boulders from the world cache,
+    // or generate them (and refresh the cache) when it is missing or stale
+    WorldCacheKey worldKey = {worldSeed, terrainSize, LANDSCAPE_SCALE, LANDSCAPE_HEIGHT, 500000, erosionIterations};
+    int worldStart = glutGet(GLUT_ELAPSED_TIME);
+    int fromCache = loadWorld(&worldKey);
+    if (!fromCache && !generateWorld(&worldKey)) {
         fprintf(stderr, "Failed to create landscape\n");
         return 1;
     }
-    
-    // Initialize grass system with 500,000 grass blades
-    grassSystemInit(landscape, LANDSCAPE_SCALE, 500000);
+    printf("World %s in %d ms\n", fromCache ? "loaded from cache" : "generated", glutGet(GLUT_ELAPSED_TIME) - worldStart);
+    if (indexStats) landscapePrintIndexStats(landscape);
+    if (rayBenchCount > 0) runRaycastBenchmark(rayBenchCount, worldSeed);
+    if (erosionBenchIterations > 0) runErosionBenchmark(erosionBenchIterations, worldSeed);
+    if (indexStats || rayBenchCount > 0 || erosionBenchIterations > 0) return 0;
+    // Stream terrain tiles around the camera beyond the home terrain
+    if (streamTiles && !(terrainStream = terrainStreamCreate(landscape, worldSeed))) {
+        fprintf(stderr, "Failed to start terrain streaming; the world ends at the home terrain\n");
+    }
     
     // Upload terrain heightmap to particle system for collision detection
-    particleSystemUploadHeightmap(landscape->elevationData);
-    
-    // Initialize landscape objects (trees, rocks, etc.)
-    initLandscapeObjects(landscape);
-    
-    // Initialize boulder system
-    initBoulders(landscape);
+    particleSystemUploadHeightmap(landscape->elevationData, landscape->size, landscape->scale, landscape->origin[0], landscape->origin[1]);
     
     // Create and configure camera system
     camera = viewCameraCreate();
@@ -884,7 +1325,7 @@ int main(int argc, char* argv[]) {
     
     // Initialize sky and cloud systems
     skySystemInitialize(&skySystemInstance);
-    cloudSystem = atmosphericCloudSystemCreate(LANDSCAPE_SCALE * 0.4f);
+    cloudSystem = atmosphericCloudSystemCreate(landscape->scale * 0.4f, terrainTileSeed(worldSeed, 0, 0, TERRAIN_SEED_CLOUDS));
     if (!cloudSystem) {
         fprintf(stderr, "Failed to create cloud system\n");
         return 1;
@@ -922,8 +1363,21 @@ int main(int argc, char* argv[]) {
     // Initialize time tracking
     lastTime = glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
     
-    // Initialize particle system for weather effects
-    particleSystemInit(2000.0f, 20000.0f);
+    // Create the weather particles in a 60 x 60 box around the camera's focus (about a tenth of the terrain's area, so
+    // ten times the density where it can be seen) from 5 to 30 units above the ground; they start disabled, like the toggle
+    ParticleEmitter aroundCamera = {{-30.0f, 5.0f, -30.0f}, {30.0f, 30.0f, 30.0f}, PARTICLE_EMITTER_CAMERA, {0.0f, 0.0f, 0.0f}};
+    weatherOrigin(aroundCamera.origin);
+    weather = particleSystemCreate(particleCount, &aroundCamera, weatherType == 1 ? &particleSpeciesSnow : &particleSpeciesRain,
+                                   terrainTileSeed(worldSeed, 0, 0, TERRAIN_SEED_WEATHER));
+    if (!weather) {
+        fprintf(stderr, "Failed to create %d weather particles\n", particleCount);
+        return 1;
+    }
+    particleSystemSetEnabled(weather, snowOn);
+    if (particleBenchSteps > 0) {
+        runParticleBenchmark(particleBenchSteps);
+        return 0;
+    }
     
     // Initialize and start ambient sound system
     if (!soundInit("sounds/forest-ambience.mp3")) {
@@ -946,14 +1400,18 @@ int main(int argc, char* argv[]) {
     glutMainLoop();
     
     // Cleanup resources (this code is reached when glutMainLoop exits)
+    terrainStreamDestroy(terrainStream);
     landscapeDestroy(landscape);
     freeBoulders();
     freeLandscapeObjects();
     atmosphericCloudSystemDestroy(cloudSystem);
     viewCameraDestroy(camera);
+    particleSystemDestroy(weather);
     particleSystemCleanup();
+    free(weatherGround);
     grassSystemCleanup();
     soundCleanup();
+    threadPoolShutdown();
     
     return 0;
 }
\ No newline at end of file
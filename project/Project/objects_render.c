@@ -17,71 +17,32 @@
 #include "objects_render.h"
 #include "fractal_tree.h"
 #include "boulder.h"
+#include "rng.h"
 
 TreeInstance* treeInstances = NULL;
 int numTrees = 0;
 
 extern float treeSwayAngle;
 
-// Claude generated this function, because i had no clue how to get slope at a point
-static float getSlopeAt(Landscape* landscape, float x, float z) {
-    // 1. Calculate normalized coordinates for landscape grid lookup
-    // This scales the world coordinates (x, z) to the grid's index range.
-    // LANDSCAPE_SCALE is the size of each grid cell in the world.
-    // +0.5f centers the grid, so (x/LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1)
-    // gives the index of the grid cell closest to (x, z).
-    float nx = (x / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1);
-    float nz = (z / LANDSCAPE_SCALE + 0.5f) * (LANDSCAPE_SIZE - 1);
-
-    // 2. Convert normalized coordinates to integer indices
-    // Clamp indices to ensure they are within the valid range of the landscape grid.
-    int ix = (int)nx;
-    int iz = (int)nz;
-    if (ix < 0) ix = 0;
-    if (iz < 0) iz = 0;
-    if (ix >= LANDSCAPE_SIZE-1) ix = LANDSCAPE_SIZE-2;
-    if (iz >= LANDSCAPE_SIZE-1) iz = LANDSCAPE_SIZE-2;
-
-    // 3. Calculate the index in the landscape->normals array
-    // The normals are stored in a 1D array, so we need to calculate the 1D index
-    // from the 2D grid coordinates (ix, iz).
-    int idx = iz * LANDSCAPE_SIZE + ix;
-
-    // 4. Access the normal vector at the calculated index
-    // The normals are stored as a 3-component vector (nx, ny, nz).
-    // We only need the y-component for slope calculation.
-    float* n = &landscape->normals[idx*3];
-
-    // 5. Calculate the slope angle in radians
-    // The normal vector's y-component represents the vertical slope.
-    // acosf(fminf(fmaxf(n[1], -1.0f), 1.0f)) converts the y-component to an angle.
-    // fminf(fmaxf(n[1], -1.0f), 1.0f) clamps the y-component between -1 and 1.
-    // acosf(y) gives the angle in radians where y is the cosine of the angle.
-    float slope = acosf(fminf(fmaxf(n[1], -1.0f), 1.0f));
-
-    // 6. Convert slope angle to a normalized value (0 to 1)
-    // This is done by dividing the angle in radians by pi.
-    // The slope is typically between 0 and 1, where 0 is flat and 1 is steep.
-    return slope / (float)M_PI;
+// treePlacementRule: Converts the tree placement parameters into a terrain attribute placement rule.
+// Slopes in the parameters are normalized to 0 (flat) .. 1 by dividing the angle between the normal and vertical by pi.
+static LandscapePlacementRule treePlacementRule(const ObjectPlacementParams* params) {
+    LandscapePlacementRule rule;
+    rule.minAboveWater = params->minHeight - WATER_LEVEL; // Reject locations below the minimum allowed height (e.g., underwater or too low).
+    if (rule.minAboveWater < params->minDistanceFromWater) rule.minAboveWater = params->minDistanceFromWater; // Keep trees out of lakes.
+    rule.maxAboveWater = params->maxHeight - WATER_LEVEL; // Reject locations above the maximum allowed height (e.g., mountain tops).
+    rule.minSlope = params->minSlope * (float)M_PI;       // Reject locations that are too flat or too steep for trees.
+    rule.maxSlope = params->maxSlope * (float)M_PI;
+    rule.materials = 0;                                   // Any material.
+    return rule;
 }
-// Claude code ends here
 
-static int isValidTreeLocation(Landscape* landscape, float x, float z, const ObjectPlacementParams* params) {
-    float y = landscapeGetHeight(landscape, x, z); // Get the height of the landscape at the (x, z) position.
-    float slope = getSlopeAt(landscape, x, z);     // Get the normalized slope at the (x, z) position.
-    if (y < params->minHeight) return 0;           // Reject locations below the minimum allowed height (e.g., underwater or too low).
-    if (y > params->maxHeight) return 0;           // Reject locations above the maximum allowed height (e.g., mountain tops).
-    if (slope < params->minSlope || slope > params->maxSlope) return 0; // Reject locations that are too flat or too steep for trees.
-    if (y - WATER_LEVEL < params->minDistanceFromWater) return 0; // Reject locations too close to water (e.g., to avoid trees in lakes).
-    return 1; // If all checks pass, this is a valid location for a tree.
-}
-
-static TreeInstance makeRandomTreeInstance(float x, float y, float z) {
-    float scale = 1.8f + (rand()/(float)RAND_MAX) * 2.2f; // Randomize the tree's scale for natural size variation.
-    int depth = 4 + rand() % 2;                           // Randomize the recursion depth for branch complexity.
-    float rotation = (rand()/(float)RAND_MAX) * 360.0f;   // Randomize the tree's rotation for orientation diversity.
-    unsigned int branchBias = rand();                     // Randomize the branch bias for unique branch shapes.
-    int leafColorIndex = rand() % 5;                      // Randomize the leaf color index for seasonal/color variety.
+static TreeInstance makeRandomTreeInstance(Rng* rng, float x, float y, float z) {
+    float scale = rngRange(rng, 1.8f, 4.0f);              // Randomize the tree's scale for natural size variation.
+    int depth = 4 + rngInt(rng, 2);                       // Randomize the recursion depth for branch complexity.
+    float rotation = rngRange(rng, 0.0f, 360.0f);         // Randomize the tree's rotation for orientation diversity.
+    unsigned int branchBias = (unsigned int)rngInt(rng, 32768); // Randomize the branch bias for unique branch shapes.
+    int leafColorIndex = rngInt(rng, 5);                  // Randomize the leaf color index for seasonal/color variety.
     // Return a fully initialized TreeInstance struct with all randomized and provided parameters.
     return (TreeInstance){x, y, z, scale, depth, rotation, branchBias, leafColorIndex};
 }
@@ -96,35 +57,83 @@ void freeLandscapeObjects() {
     }
 }
 
-void initLandscapeObjects(Landscape* landscape) {
-    freeLandscapeObjects();              // Always free any existing objects before initializing new ones.
-    if (!landscape) return;              // If the landscape is not valid, do nothing.
+TreeInstance* generateTreeInstances(Landscape* landscape, unsigned int seed, int* outCount) {
+    // This function places trees over a landscape into a new array and stores how many were placed in *outCount.
+    // Every grid cell draws from its own two random streams of seed (jitter and tree attributes), and no GL or
+    // global state is touched, so streamed terrain tiles can be populated on worker threads and each cell's tree
+    // depends only on the seed and the cell. The caller owns the returned array.
+    *outCount = 0;
+    if (!landscape) return NULL;         // If the landscape is not valid, do nothing.
     // Set up the parameters for tree placement. These control where trees can be placed in the landscape.
     ObjectPlacementParams treeParams = {
         .minSlope = 0.0f,               // Minimum slope for tree placement (flat ground).
         .maxSlope = 0.35f,              // Maximum slope for tree placement (avoid steep hills).
         .minHeight = WATER_LEVEL + 1.5f,// Minimum height above water for tree placement.
-        .maxHeight = LANDSCAPE_HEIGHT * 1.2f, // Maximum height for tree placement.
+        .maxHeight = landscape->height * 1.2f, // Maximum height for tree placement.
         .minDistanceFromWater = 1.0f,   // Minimum distance from water for tree placement.
         .density = 15                   // Number of grid cells along one axis (controls total tree density).
     };
     int grid = treeParams.density;      // The number of grid cells along one axis.
     int maxTrees = grid * grid;         // The maximum number of trees (one per grid cell).
-    treeInstances = (TreeInstance*)malloc(sizeof(TreeInstance) * maxTrees); // Allocate memory for all possible tree instances.
-    numTrees = 0;                       // Start with zero trees; we'll increment as we place them.
-    float halfScale = LANDSCAPE_SCALE * 0.5f * 0.95f; // Half the landscape width, slightly reduced to avoid edge artifacts.
-    float step = (LANDSCAPE_SCALE * 0.95f) / (float)grid; // Step size between grid cells, covering most of the landscape.
+    TreeInstance* trees = (TreeInstance*)malloc(sizeof(TreeInstance) * maxTrees); // Allocate memory for all possible tree instances.
+    int count = 0;                      // Start with zero trees; we'll increment as we place them.
+    // Candidate positions plus their terrain height and placement bits, queried in one batch.
+    LandscapePlacementRule rule = treePlacementRule(&treeParams);
+    int ruleBit = landscapeAddPlacementRule(landscape, &rule);
+    float* xs = (float*)malloc(sizeof(float) * maxTrees * 3);
+    unsigned int* masks = (unsigned int*)malloc(sizeof(unsigned int) * maxTrees);
+    if (!trees || !xs || !masks || ruleBit < 0) { // Leave the scene without trees if allocation fails.
+        free(xs);
+        free(masks);
+        free(trees);
+        return NULL;
+    }
+    float* zs = xs + maxTrees;
+    float* ys = zs + maxTrees;
+    float minX = landscape->origin[0] + landscape->scale * 0.025f; // First grid line, slightly inside the landscape to avoid edge artifacts.
+    float minZ = landscape->origin[1] + landscape->scale * 0.025f;
+    float step = (landscape->scale * 0.95f) / (float)grid; // Step size between grid cells, covering most of the landscape.
     // Place trees in a grid, but add random jitter to each position for natural distribution.
     for (int i = 0; i < grid; ++i) {
         for (int j = 0; j < grid; ++j) {
-            float x = -halfScale + i * step + (rand()/(float)RAND_MAX - 0.5f) * step * 0.5f; // X position with random jitter.
-            float z = -halfScale + j * step + (rand()/(float)RAND_MAX - 0.5f) * step * 0.5f; // Z position with random jitter.
-            if (!isValidTreeLocation(landscape, x, z, &treeParams)) continue; // Skip if this location is not valid for a tree.
-            float y = landscapeGetHeight(landscape, x, z); // Get the Y (height) at this position.
-            treeInstances[numTrees++] = makeRandomTreeInstance(x, y, z); // Create and store a new tree instance at this location.
+            Rng rng;
+            rngSeed(&rng, seed, (unsigned int)(i * grid + j) * 2u); // The cell's position stream.
+            xs[i * grid + j] = minX + i * step + rngRange(&rng, -0.25f, 0.25f) * step; // X position with random jitter.
+            zs[i * grid + j] = minZ + j * step + rngRange(&rng, -0.25f, 0.25f) * step; // Z position with random jitter.
         }
-        // claude code ends here
     }
+    landscapeGetHeightBatch(landscape, xs, zs, maxTrees, ys);       // Get the Y (height) at every candidate.
+    landscapeGetPlacementBatch(landscape, xs, zs, maxTrees, masks); // Get the placement bits of every candidate's cell.
+    for (int c = 0; c < maxTrees; ++c) {
+        if (!((masks[c] >> ruleBit) & 1)) continue; // Skip if this location is not valid for a tree.
+        // The cell record holds the cell's lowest corner, so also test the ground right under the trunk: a cell
+        // rising past the height limits must not carry a tree above them.
+        float aboveWater = ys[c] - WATER_LEVEL;
+        if (aboveWater < rule.minAboveWater || aboveWater > rule.maxAboveWater) continue;
+        Rng rng;
+        rngSeed(&rng, seed, (unsigned int)c * 2u + 1u); // The cell's attribute stream.
+        trees[count++] = makeRandomTreeInstance(&rng, xs[c], ys[c], zs[c]); // Create and store a new tree instance at this location.
+    }
+    free(xs);
+    free(masks);
+    *outCount = count;
+    return trees;
+}
+
+void initLandscapeObjects(Landscape* landscape, unsigned int seed) {
+    // This function places the home terrain's trees from the seed.
+    freeLandscapeObjects();              // Always free any existing objects before initializing new ones.
+    treeInstances = generateTreeInstances(landscape, seed, &numTrees);
+}
+
+void loadLandscapeObjects(const TreeInstance* trees, int count) {
+    // This function restores previously generated tree instances (e.g. from the world cache) instead of placing new ones.
+    freeLandscapeObjects();              // Always free any existing objects before loading new ones.
+    if (count <= 0) return;              // Nothing to load.
+    treeInstances = (TreeInstance*)malloc(sizeof(TreeInstance) * count); // Allocate memory for the loaded trees.
+    if (!treeInstances) return;          // Leave the scene without trees if allocation fails.
+    memcpy(treeInstances, trees, sizeof(TreeInstance) * count); // Copy the instances so the source can be released.
+    numTrees = count;                    // Record how many trees were loaded.
 }
 
 static void renderTreeInstance(const TreeInstance* t) {
@@ -137,10 +146,15 @@ static void renderTreeInstance(const TreeInstance* t) {
     glPopMatrix(); // Restore the previous transformation matrix so subsequent objects are not affected.
 }
 
+void renderTreeInstances(const TreeInstance* trees, int count) {
+    // This function draws a list of trees, such as the home terrain's or those of a streamed terrain tile.
+    for (int i = 0; i < count; ++i) {   // Loop through all tree instances.
+        renderTreeInstance(&trees[i]);  // Render each tree at its unique position, scale, and orientation.
+    }
+}
+
 void renderLandscapeObjects(Landscape* landscape) {
     if (!landscape || !treeInstances) return; // If there is no landscape or no trees, do nothing.
-    for (int i = 0; i < numTrees; ++i) { // Loop through all tree instances.
-        renderTreeInstance(&treeInstances[i]); // Render each tree at its unique position, scale, and orientation.
-    }
+    renderTreeInstances(treeInstances, numTrees); // Render the home terrain's trees.
     renderBoulders(); // Render all boulders in the scene (other object types can be added here as needed).
 } 
\ No newline at end of file
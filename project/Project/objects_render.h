@@ -23,7 +23,10 @@ extern TreeInstance* treeInstances;
 extern int numTrees;
 
 void freeLandscapeObjects(void);
-void initLandscapeObjects(Landscape* landscape);
+TreeInstance* generateTreeInstances(Landscape* landscape, unsigned int seed, int* outCount);
+void initLandscapeObjects(Landscape* landscape, unsigned int seed);
+void loadLandscapeObjects(const TreeInstance* trees, int count);
+void renderTreeInstances(const TreeInstance* trees, int count);
 void renderLandscapeObjects(Landscape* landscape);
 
 #endif
\ No newline at end of file
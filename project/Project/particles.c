@@ -9,6 +9,13 @@
  * - Uses transform feedback to update particle positions, velocities, and states entirely on the GPU, minimizing CPU-GPU traffic.
  * - Employs two sets of Vertex Array Objects (VAOs) and Vertex Buffer Objects (VBOs) to "ping-pong" particle data between update and render passes.
  * - Particles are initialized with randomized positions, velocities, and lifetimes to create natural, varied weather effects.
+ * - Each ParticleSystem has its own capacity, emitter volume (the box particles spawn and respawn in), and species
+ *   (fall speed, wind, rest time, sprite shape, size, and color). Systems share the two shader programs and the heightmap, so
+ *   creating, resizing, or switching species never compiles or links a shader.
+ * - A disabled system skips its update and render passes entirely, so it costs no GPU time until it is enabled again.
+ * - A camera emitter keeps the box around the viewer instead of spreading it over the whole terrain: falling particles
+ *   that drift out of one side of the box come back in on the other (a toroidal box), so the same particle count
+ *   gives a much denser fall where it can actually be seen. Landed particles stay put until they respawn.
  * - The update pass is performed by a vertex shader (particle_update.vert) that simulates gravity, wind, and collision with the landscape.
  * - The render pass uses a separate shader (particle_render.vert/frag) to draw each particle as a point sprite, with blending for soft, semi-transparent effects.
  * - The system is modular: it can be initialized, updated, rendered, and cleaned up independently of other scene systems.
@@ -52,6 +59,7 @@
 #include "particles.h"     // Header for particle system types and function prototypes
 #include "shaders.h"       // Header for shader loading utilities
 #include "landscape.h"     // Header for landscape constants and types
+#include "rng.h"           // Header for the seeded random streams
 
 // --- Platform-specific macros for VAO and transform feedback support ---
 // These macros abstract away the differences between Apple and non-Apple OpenGL implementations.
@@ -87,26 +95,25 @@
     #define TF_SETUP(shader, count, varyings) glTransformFeedbackVaryings(shader, count, varyings, GL_INTERLEAVED_ATTRIBS) // Set up transform feedback varyings (standard OpenGL)
 #endif
 
-// --- Particle system state variables ---
-// These variables hold the OpenGL handles and simulation state for the particle system.
-static GLuint particleVBOs[2] = {0, 0}; // Two Vertex Buffer Objects (VBOs) for ping-ponging particle data between update and render passes
-static GLuint particleVAOs[2] = {0, 0}; // Two Vertex Array Objects (VAOs) for binding the correct VBO and attribute layout
+// --- Shared state ---
+// Every particle system runs the same two shader programs against the same landscape heightmap.
 static GLuint updateShader = 0;         // Handle for the shader program used to update particle state (vertex shader with transform feedback)
 static GLuint renderShader = 0;         // Handle for the shader program used to render particles (vertex + fragment shaders)
-static int curSrc = 0;                  // Index of the current source buffer (0 or 1); alternates each frame for ping-pong buffering
 static GLuint heightmapTex = 0;         // Handle for the texture containing the landscape heightmap, used for particle-ground collision
+static float terrainMinX = -LANDSCAPE_SCALE * 0.5f; // Minimum X coordinate the heightmap covers (the home landscape by default)
+static float terrainMaxX = LANDSCAPE_SCALE * 0.5f;  // Maximum X coordinate the heightmap covers
+static float terrainMinZ = -LANDSCAPE_SCALE * 0.5f; // Minimum Z coordinate the heightmap covers
+static float terrainMaxZ = LANDSCAPE_SCALE * 0.5f;  // Maximum Z coordinate the heightmap covers
+static float terrainScale = LANDSCAPE_SCALE;        // World-space width of the heightmap (set by the heightmap upload)
+static int terrainSize = LANDSCAPE_SIZE;            // Resolution of the uploaded heightmap grid
 
-#define NUM_PARTICLES 20000             // Number of particles in the system (tunable for performance/quality)
-static float cloudHeight = 128.0f;      // Default height above the terrain where cloud-originated particles spawn
-static float terrainMinX = -LANDSCAPE_SCALE * 0.5f; // Minimum X coordinate of the landscape (centered at origin)
-static float terrainMaxX = LANDSCAPE_SCALE * 0.5f;  // Maximum X coordinate of the landscape
-static float terrainMinZ = -LANDSCAPE_SCALE * 0.5f; // Minimum Z coordinate of the landscape
-static float terrainMaxZ = LANDSCAPE_SCALE * 0.5f;  // Maximum Z coordinate of the landscape
-
-// Uniform locations for shader variables (cached after first lookup for efficiency)
+// Uniform locations for shader variables (cached after the programs are linked)
 static GLint timeLoc = -1;             // Location of the 'time' uniform in the update shader
 static GLint dtLoc = -1;               // Location of the 'dt' (delta time) uniform in the update shader
-static GLint cloudHeightLoc = -1;      // Location of the 'cloudHeight' uniform in the update shader
+static GLint emitterMinLoc = -1;       // Location of the 'emitterMin' uniform in the update shader
+static GLint emitterMaxLoc = -1;       // Location of the 'emitterMax' uniform in the update shader
+static GLint emitterWrapLoc = -1;      // Location of the 'emitterWrap' uniform in the update shader
+static GLint fallSpeedLoc = -1;        // Location of the 'fallSpeed' uniform in the update shader
 static GLint restThresholdLoc = -1;    // Location of the 'restThreshold' uniform in the update shader
 static GLint landscapeScaleLoc = -1;   // Location of the 'landscapeScale' uniform in the update shader
 static GLint landscapeSizeLoc = -1;    // Location of the 'landscapeSize' uniform in the update shader
@@ -116,13 +123,32 @@ static GLint terrainMinZLoc = -1;      // Location of the 'terrainMinZ' uniform
 static GLint terrainMaxZLoc = -1;      // Location of the 'terrainMaxZ' uniform in the update shader
 static GLint windLoc = -1;             // Location of the 'wind' uniform in the update shader
 static GLint heightmapLoc = -1;        // Location of the 'heightmap' uniform in the update shader
+static GLint colorLoc = -1;            // Location of the 'color' uniform in the render shader
+static GLint spriteLoc = -1;           // Location of the 'sprite' uniform in the render shader
+
+// --- Species presets ---
+// Snow drifts down slowly and lies for a while; rain falls fast and soaks in almost at once.
+const ParticleSpecies particleSpeciesSnow = {{8.0f, 12.0f}, {1.0f, 0.5f}, 5.0f, 30.0f, {0.92f, 0.96f, 1.0f, 0.85f}, PARTICLE_SPRITE_FLAKE};
+const ParticleSpecies particleSpeciesRain = {{30.0f, 40.0f}, {2.0f, 1.0f}, 0.3f, 16.0f, {0.60f, 0.68f, 0.80f, 0.6f}, PARTICLE_SPRITE_STREAK};
 
-/* --- Function: particleSystemInit ---
- * Sets up the entire GPU-based particle system.
- * Loads and links the update and render shaders, sets up transform feedback,
- * and initializes all particle data and OpenGL buffers for efficient simulation.
+// --- Per-system state ---
+struct ParticleSystem {
+    GLuint vbos[2];             // Two Vertex Buffer Objects (VBOs) for ping-ponging particle data between update and render passes
+    GLuint vaos[2];             // Two Vertex Array Objects (VAOs) for binding the correct VBO and attribute layout
+    int current;                // Index of the current source buffer (0 or 1); alternates each frame for ping-pong buffering
+    int capacity;               // Number of particles in both buffers
+    int enabled;                // Disabled systems are neither updated nor drawn
+    ParticleEmitter emitter;    // Box particles spawn and respawn in
+    ParticleSpecies species;    // How the particles fall, rest, and look
+    Rng rng;                    // Random stream for the particles this system spawns on the CPU (at creation and growth)
+};
+
+/* --- Function: setupParticleShaders ---
+ * Loads and links the update and render shaders shared by every particle system, on first use,
+ * and sets up transform feedback so the update shader writes its outputs into a particle buffer.
  */
-void particleSystemInit(float terrainScale, float terrainHeight) {
+static void setupParticleShaders(void) {
+    if (updateShader) return; // Already loaded: systems of any size reuse the same programs.
     // Load and compile the update shader (vertex shader for transform feedback).
     // This shader is responsible for updating each particle's state (position, velocity, etc.) on the GPU.
     updateShader = loadShader("shaders/particle_update.vert", NULL); // Load the update shader from file.
@@ -136,38 +162,120 @@ void particleSystemInit(float terrainScale, float terrainHeight) {
     glBindAttribLocation(updateShader, 1, "vel");      // Attribute 1: Particle velocity (vec3)
     glBindAttribLocation(updateShader, 2, "restTime"); // Attribute 2: Particle rest time (float)
     glBindAttribLocation(updateShader, 3, "state");    // Attribute 3: Particle state (float)
+    glBindAttribLocation(renderShader, 0, "pos");      // The render shader reads the position from the same attribute.
 
     // Specify which outputs from the update shader should be captured by transform feedback.
     // This allows the GPU to write updated particle data directly into a buffer, avoiding CPU-GPU transfer.
     const char* varyings[] = { "outPos", "outVel", "outRestTime", "outState" }; // Names must match shader outputs.
     TF_SETUP(updateShader, 4, varyings); // Set up transform feedback to capture all four outputs.
     glLinkProgram(updateShader);         // Link the shader program so it's ready for use.
+    glLinkProgram(renderShader);         // Relink so the position attribute binding takes effect.
 
-    // Generate two VAOs and two VBOs for ping-ponging particle data.
-    // One buffer is used as the source (read), the other as the destination (write).
-    VAO_GEN(2, particleVAOs); // Generate two VAOs for the two buffer sets.
-    glGenBuffers(2, particleVBOs); // Generate two VBOs for the two buffer sets.
+    // Cache uniform locations now that the programs are final. This avoids repeated lookups every frame.
+    timeLoc = glGetUniformLocation(updateShader, "time");           // Uniform for elapsed time in seconds since program start.
+    dtLoc = glGetUniformLocation(updateShader, "dt");               // Uniform for delta time (time since last frame).
+    emitterMinLoc = glGetUniformLocation(updateShader, "emitterMin"); // Uniform for the low corner of the spawn box.
+    emitterMaxLoc = glGetUniformLocation(updateShader, "emitterMax"); // Uniform for the high corner of the spawn box.
+    emitterWrapLoc = glGetUniformLocation(updateShader, "emitterWrap"); // Uniform that makes falling particles wrap around the box.
+    fallSpeedLoc = glGetUniformLocation(updateShader, "fallSpeed");   // Uniform for the range of respawn fall speeds.
+    restThresholdLoc = glGetUniformLocation(updateShader, "restThreshold"); // Uniform for how long a particle can rest before respawning.
+    landscapeScaleLoc = glGetUniformLocation(updateShader, "landscapeScale"); // Uniform for the scale of the landscape.
+    landscapeSizeLoc = glGetUniformLocation(updateShader, "landscapeSize");   // Uniform for the size of the landscape grid.
+    terrainMinXLoc = glGetUniformLocation(updateShader, "terrainMinX");      // Uniform for minimum X coordinate of terrain.
+    terrainMaxXLoc = glGetUniformLocation(updateShader, "terrainMaxX");      // Uniform for maximum X coordinate of terrain.
+    terrainMinZLoc = glGetUniformLocation(updateShader, "terrainMinZ");      // Uniform for minimum Z coordinate of terrain.
+    terrainMaxZLoc = glGetUniformLocation(updateShader, "terrainMaxZ");      // Uniform for maximum Z coordinate of terrain.
+    windLoc = glGetUniformLocation(updateShader, "wind");                   // Uniform for wind vector (X, Z).
+    heightmapLoc = glGetUniformLocation(updateShader, "heightmap");         // Uniform for heightmap texture sampler.
+    colorLoc = glGetUniformLocation(renderShader, "color");                 // Uniform for the sprite color of the species.
+    spriteLoc = glGetUniformLocation(renderShader, "sprite");               // Uniform for the sprite shape of the species.
+}
 
-    // Allocate and initialize the particle data on the CPU.
-    // Each particle is given a random position within the landscape, a random velocity, and default state values.
-    // This randomness ensures that the weather effect (e.g., snow or rain) looks natural and not uniform.
-    Particle* particles = (Particle*)malloc(NUM_PARTICLES * sizeof(Particle)); // Allocate memory for all particles.
-    for (int i = 0; i < NUM_PARTICLES; ++i) {
-        float x = terrainMinX + ((float)rand() / RAND_MAX) * (terrainMaxX - terrainMinX); // X position: random across landscape.
-        float z = terrainMinZ + ((float)rand() / RAND_MAX) * (terrainMaxZ - terrainMinZ); // Z position: random across landscape.
-        float y = cloudHeight + ((float)rand() / RAND_MAX) * 20.0f; // Y position: random height above terrain (cloud layer).
-        float vx = ((float)rand() / RAND_MAX - 0.5f) * 4.0f;        // X velocity: random, simulates wind variation.
-        float vy = -8.0f - ((float)rand() / RAND_MAX) * 4.0f;       // Y velocity: negative, simulates gravity pulling down.
-        float vz = ((float)rand() / RAND_MAX - 0.5f) * 4.0f;        // Z velocity: random, simulates wind variation.
-        particles[i].x = x; particles[i].y = y; particles[i].z = z; // Set position.
-        particles[i].vx = vx; particles[i].vy = vy; particles[i].vz = vz; // Set velocity.
-        particles[i].restTime = 0.0f; particles[i].state = 0.0f;    // Start at rest, default state.
+/* --- Function: fitRange ---
+ * Slides the range [lo, hi] so it lies inside [limitLo, limitHi], and shrinks it to those limits if it is wider.
+ */
+static void fitRange(float* lo, float* hi, float limitLo, float limitHi) {
+    if (*lo < limitLo) { *hi += limitLo - *lo; *lo = limitLo; }     // Past the low edge: slide up.
+    else if (*hi > limitHi) { *lo -= *hi - limitHi; *hi = limitHi; } // Past the high edge: slide down.
+    if (*lo < limitLo) *lo = limitLo;                                 // Still too wide: cut it to the limits.
+}
+
+/* --- Function: emitterBox ---
+ * Works out the world-space box a system spawns in this frame. A fixed emitter is its box as given; a camera emitter
+ * is its offsets around the camera, slid horizontally to stay over the uploaded heightmap (the only ground it knows).
+ */
+static void emitterBox(const ParticleSystem* system, float min[3], float max[3]) {
+    const ParticleEmitter* e = &system->emitter;
+    int follow = e->mode == PARTICLE_EMITTER_CAMERA;
+    for (int a = 0; a < 3; ++a) {
+        min[a] = e->min[a] + (follow ? e->origin[a] : 0.0f);
+        max[a] = e->max[a] + (follow ? e->origin[a] : 0.0f);
+    }
+    if (follow) {
+        fitRange(&min[0], &max[0], terrainMinX, terrainMaxX);
+        fitRange(&min[2], &max[2], terrainMinZ, terrainMaxZ);
+    }
+}
+
+/* --- Function: spawnParticles ---
+ * Fills 'count' particles with random positions inside the emitter box, falling at a random speed of the species.
+ * All of it comes from the system's own random stream, so the same seed always starts the same weather.
+ */
+static void spawnParticles(ParticleSystem* system, Particle* particles, int count) {
+    const ParticleSpecies* sp = &system->species;
+    float min[3], max[3];
+    emitterBox(system, min, max);
+    for (int i = 0; i < count; ++i) {
+        particles[i].x = rngRange(&system->rng, min[0], max[0]); // X position: random across the emitter.
+        particles[i].y = rngRange(&system->rng, min[1], max[1]); // Y position: random through the emitter's height.
+        particles[i].z = rngRange(&system->rng, min[2], max[2]); // Z position: random across the emitter.
+        particles[i].vx = sp->wind[0];                                  // Horizontal velocity: carried by the wind.
+        particles[i].vy = -rngRange(&system->rng, sp->fallSpeed[0], sp->fallSpeed[1]); // Y velocity: downward at a random speed of the species.
+        particles[i].vz = sp->wind[1];
+        particles[i].restTime = 0.0f; particles[i].state = 0.0f;       // Start falling, with no rest time.
     }
-    // Upload the initial particle data to both VBOs (so both buffers are initialized identically).
+}
+
+/* --- Function: uploadParticles ---
+ * Uploads 'count' particles to both ping-pong buffers (so both start out identical), reallocating their storage.
+ * The VAOs keep pointing at the same buffer objects, so their attribute layout stays valid across resizes.
+ */
+static void uploadParticles(ParticleSystem* system, const Particle* particles, int count) {
+    for (int b = 0; b < 2; ++b) {
+        glBindBuffer(GL_ARRAY_BUFFER, system->vbos[b]); // Bind the VBO to upload data.
+        glBufferData(GL_ARRAY_BUFFER, (size_t)count * sizeof(Particle), particles, GL_DYNAMIC_DRAW); // Upload data to GPU.
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    system->capacity = count;
+}
+
+/* --- Function: particleSystemCreate ---
+ * Creates a particle system of 'capacity' particles spawning in 'emitter' and behaving like 'species'.
+ * Loads the shared shaders on first use, creates this system's ping-pong VAOs and VBOs, and fills both with
+ * freshly spawned particles. The system starts enabled. Returns NULL if memory runs out.
+ */
+ParticleSystem* particleSystemCreate(int capacity, const ParticleEmitter* emitter, const ParticleSpecies* species, unsigned int seed) {
+    if (capacity < 1) capacity = 1;
+    ParticleSystem* system = (ParticleSystem*)calloc(1, sizeof(ParticleSystem));
+    Particle* particles = (Particle*)malloc((size_t)capacity * sizeof(Particle)); // Allocate memory for all particles.
+    if (!system || !particles) {
+        free(system);
+        free(particles);
+        return NULL;
+    }
+    setupParticleShaders();
+    system->emitter = *emitter;
+    system->species = *species;
+    system->enabled = 1;
+    rngSeed(&system->rng, seed, 0); // Random stream for the particles spawned on the CPU.
+
+    // Generate two VAOs and two VBOs for ping-ponging particle data.
+    // One buffer is used as the source (read), the other as the destination (write).
+    VAO_GEN(2, system->vaos); // Generate two VAOs for the two buffer sets.
+    glGenBuffers(2, system->vbos); // Generate two VBOs for the two buffer sets.
     for (int b = 0; b < 2; ++b) {
-        VAO_BIND(particleVAOs[b]); // Bind the VAO so we can set up its attributes.
-        glBindBuffer(GL_ARRAY_BUFFER, particleVBOs[b]); // Bind the VBO to upload data.
-        glBufferData(GL_ARRAY_BUFFER, NUM_PARTICLES * sizeof(Particle), particles, GL_DYNAMIC_DRAW); // Upload data to GPU.
+        VAO_BIND(system->vaos[b]); // Bind the VAO so we can set up its attributes.
+        glBindBuffer(GL_ARRAY_BUFFER, system->vbos[b]); // The attribute pointers below refer to this buffer.
         // Set up attribute pointers so the GPU knows how to interpret the buffer data for each particle.
         glEnableVertexAttribArray(0); // Enable attribute 0 (position).
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)offsetof(Particle, x)); // Position pointer.
@@ -179,67 +287,120 @@ void particleSystemInit(float terrainScale, float terrainHeight) {
         glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Particle), (void*)offsetof(Particle, state)); // State pointer.
     }
     VAO_UNBIND(); // Unbind VAO to avoid accidental modification.
+
+    // Each particle is given a random position within the emitter and a fall speed of its species.
+    // This randomness ensures that the weather effect (e.g., snow or rain) looks natural and not uniform.
+    spawnParticles(system, particles, capacity);
+    uploadParticles(system, particles, capacity);
     free(particles); // Free the temporary CPU-side array, as data is now on the GPU.
+    return system;
+}
+
+/* --- Function: particleSystemResize ---
+ * Changes the number of particles without touching the shaders. The first min(old, new) particles keep their
+ * current state (read back from the current buffer); added particles are spawned fresh in the emitter.
+ * Returns 0 (leaving the system unchanged) if memory runs out.
+ */
+int particleSystemResize(ParticleSystem* system, int capacity) {
+    if (!system || capacity < 1) return 0;
+    if (capacity == system->capacity) return 1;
+    Particle* particles = (Particle*)malloc((size_t)capacity * sizeof(Particle));
+    if (!particles) return 0;
+    int keep = capacity < system->capacity ? capacity : system->capacity;
+    glBindBuffer(GL_ARRAY_BUFFER, system->vbos[system->current]); // The buffer the last update wrote
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, (size_t)keep * sizeof(Particle), particles);
+    spawnParticles(system, particles + keep, capacity - keep);
+    uploadParticles(system, particles, capacity);
+    free(particles);
+    return 1;
+}
+
+/* --- Function: particleSystemSetEmitter / particleSystemSetSpecies ---
+ * Replace the spawn box or the species. Particles already in flight finish their fall; respawns use the new settings.
+ */
+void particleSystemSetEmitter(ParticleSystem* system, const ParticleEmitter* emitter) {
+    system->emitter = *emitter;
+}
+
+void particleSystemSetSpecies(ParticleSystem* system, const ParticleSpecies* species) {
+    system->species = *species;
+}
+
+/* --- Function: particleSystemFollow ---
+ * Moves the origin of a camera emitter, normally to the camera position once per frame. Falling particles are
+ * carried along by wrapping around the box in the update shader; fixed emitters ignore the origin.
+ */
+void particleSystemFollow(ParticleSystem* system, const float origin[3]) {
+    if (!system) return;
+    for (int a = 0; a < 3; ++a) system->emitter.origin[a] = origin[a];
+}
+
+/* --- Function: particleSystemSetEnabled ---
+ * Turns a system on or off. A disabled system keeps its particles on the GPU but skips both its update and
+ * render passes, so it costs no GPU time; when enabled again it resumes where it stopped.
+ */
+void particleSystemSetEnabled(ParticleSystem* system, int enabled) {
+    if (system) system->enabled = enabled;
+}
+
+/* --- Function: particleSystemEnabled / particleSystemCapacity ---
+ * Report whether a system is enabled and how many particles it simulates.
+ */
+int particleSystemEnabled(const ParticleSystem* system) {
+    return system && system->enabled;
+}
+
+int particleSystemCapacity(const ParticleSystem* system) {
+    return system ? system->capacity : 0;
 }
 
 /* --- Function: particleSystemUpdate ---
- * Updates all particles for the current frame using transform feedback.
+ * Updates all particles of a system for the current frame using transform feedback.
  * Runs the update shader on the GPU, which simulates gravity, wind, and collision with the landscape.
- * Uses the ping-pong buffer technique to avoid read/write conflicts.
+ * Uses the ping-pong buffer technique to avoid read/write conflicts. Does nothing for a disabled system.
  */
-void particleSystemUpdate(float dt) {
-    int src = curSrc;         // Index of the current source buffer (where particle data is read from). This buffer contains the current state of all particles.
-    int dst = 1 - curSrc;     // Index of the destination buffer (where updated data will be written). This buffer will receive the new state after the update.
-
+void particleSystemUpdate(ParticleSystem* system, float dt) {
+    if (!system || !system->enabled) return; // Disabled systems cost no GPU time.
+    int src = system->current;     // Index of the current source buffer (where particle data is read from). This buffer contains the current state of all particles.
+    int dst = 1 - system->current; // Index of the destination buffer (where updated data will be written). This buffer will receive the new state after the update.
+    const ParticleSpecies* sp = &system->species;
+    float boxMin[3], boxMax[3];
+    emitterBox(system, boxMin, boxMax); // Where particles respawn this frame (around the camera for a camera emitter).
     glUseProgram(updateShader); // Activate the update shader program. This shader will process each particle and output its new state.
 
-    // Cache uniform locations on first use for efficiency. This avoids repeated lookups and speeds up subsequent frames.
-    if (timeLoc == -1) {
-        timeLoc = glGetUniformLocation(updateShader, "time");           // Uniform for elapsed time in seconds since program start.
-        dtLoc = glGetUniformLocation(updateShader, "dt");               // Uniform for delta time (time since last frame).
-        cloudHeightLoc = glGetUniformLocation(updateShader, "cloudHeight"); // Uniform for the height at which new particles spawn.
-        restThresholdLoc = glGetUniformLocation(updateShader, "restThreshold"); // Uniform for how long a particle can rest before respawning.
-        landscapeScaleLoc = glGetUniformLocation(updateShader, "landscapeScale"); // Uniform for the scale of the landscape.
-        landscapeSizeLoc = glGetUniformLocation(updateShader, "landscapeSize");   // Uniform for the size of the landscape grid.
-        terrainMinXLoc = glGetUniformLocation(updateShader, "terrainMinX");      // Uniform for minimum X coordinate of terrain.
-        terrainMaxXLoc = glGetUniformLocation(updateShader, "terrainMaxX");      // Uniform for maximum X coordinate of terrain.
-        terrainMinZLoc = glGetUniformLocation(updateShader, "terrainMinZ");      // Uniform for minimum Z coordinate of terrain.
-        terrainMaxZLoc = glGetUniformLocation(updateShader, "terrainMaxZ");      // Uniform for maximum Z coordinate of terrain.
-        windLoc = glGetUniformLocation(updateShader, "wind");                   // Uniform for wind vector (X, Z).
-        heightmapLoc = glGetUniformLocation(updateShader, "heightmap");         // Uniform for heightmap texture sampler.
-    }
-
     // Set all the uniforms needed by the update shader. These provide the shader with the current simulation parameters and environment state.
     float time = glutGet(GLUT_ELAPSED_TIME) / 1000.0f; // Get the elapsed time in seconds since the program started.
     glUniform1f(timeLoc, time);                        // Pass the current time to the shader.
     glUniform1f(dtLoc, dt);                            // Pass the time step for this frame.
-    glUniform1f(cloudHeightLoc, cloudHeight);          // Pass the height at which new particles should spawn.
-    glUniform1f(restThresholdLoc, 5.0f);               // Pass the threshold for how long a particle can rest.
-    glUniform1f(landscapeScaleLoc, LANDSCAPE_SCALE);   // Pass the scale of the landscape.
-    glUniform1f(landscapeSizeLoc, LANDSCAPE_SIZE);     // Pass the size of the landscape grid.
+    glUniform3fv(emitterMinLoc, 1, boxMin);            // Pass the box new particles respawn in.
+    glUniform3fv(emitterMaxLoc, 1, boxMax);
+    glUniform1f(emitterWrapLoc, system->emitter.mode == PARTICLE_EMITTER_CAMERA ? 1.0f : 0.0f); // Wrap falling particles around a camera box.
+    glUniform2fv(fallSpeedLoc, 1, sp->fallSpeed);      // Pass the range of speeds respawned particles fall at.
+    glUniform1f(restThresholdLoc, sp->restTime);       // Pass the threshold for how long a particle can rest.
+    glUniform1f(landscapeScaleLoc, terrainScale);      // Pass the scale of the landscape.
+    glUniform1f(landscapeSizeLoc, (float)terrainSize); // Pass the size of the landscape grid.
     glUniform1f(terrainMinXLoc, terrainMinX);          // Pass the minimum X coordinate of the terrain.
     glUniform1f(terrainMaxXLoc, terrainMaxX);          // Pass the maximum X coordinate of the terrain.
     glUniform1f(terrainMinZLoc, terrainMinZ);          // Pass the minimum Z coordinate of the terrain.
     glUniform1f(terrainMaxZLoc, terrainMaxZ);          // Pass the maximum Z coordinate of the terrain.
-    glUniform2f(windLoc, 1.0f, 0.5f);                  // Pass the wind vector (X, Z) to the shader.
+    glUniform2fv(windLoc, 1, sp->wind);                // Pass the wind vector (X, Z) of the species to the shader.
     glUniform1i(heightmapLoc, 0);                      // Tell the shader to use texture unit 0 for the heightmap.
-
     glActiveTexture(GL_TEXTURE0);                      // Activate texture unit 0 for the heightmap.
     glBindTexture(GL_TEXTURE_2D, heightmapTex);        // Bind the heightmap texture so the shader can sample terrain elevation for collision.
 
-    VAO_BIND(particleVAOs[src]);                       // Bind the VAO containing the current particle data (source buffer).
-    TF_BIND_BUFFER(particleVBOs[dst]);                 // Bind the destination buffer for transform feedback. This is where the updated particle data will be written.
+    VAO_BIND(system->vaos[src]);                       // Bind the VAO containing the current particle data (source buffer).
+    TF_BIND_BUFFER(system->vbos[dst]);                 // Bind the destination buffer for transform feedback. This is where the updated particle data will be written.
     RASTER_DISCARD_ON();                               // Enable rasterizer discard. This tells OpenGL not to generate any fragments (pixels) during this pass,
                                                       // since we are only interested in updating data, not rendering anything to the screen.
     TF_BEGIN();                                        // Begin transform feedback. This tells OpenGL to capture the outputs of the vertex shader and write them to the buffer.
-    glDrawArrays(GL_POINTS, 0, NUM_PARTICLES);         // Issue a draw call for all particles as points. Each point will be processed by the update shader.
+    glDrawArrays(GL_POINTS, 0, system->capacity);      // Issue a draw call for all particles as points. Each point will be processed by the update shader.
     TF_END();                                          // End transform feedback. All updated particle data is now in the destination buffer.
     RASTER_DISCARD_OFF();                              // Disable rasterizer discard so future draw calls will render as normal.
     TF_UNBIND_BUFFER();                                // Unbind the transform feedback buffer to avoid accidental modification.
     VAO_UNBIND();                                      // Unbind the VAO to avoid accidental modification.
     glUseProgram(0);                                   // Unbind the shader program.
 
-    curSrc = dst;                                      // Swap the source and destination buffers for the next frame.
+    system->current = dst;                             // Swap the source and destination buffers for the next frame.
                                                       // This is the core of the ping-pong technique: next frame, the updated data becomes the source.
 }
 
@@ -250,18 +411,22 @@ void particleSystemUpdate(float dt) {
  */
 
 /* --- Function: particleSystemRender ---
- * Renders all particles as point sprites using the render shader.
+ * Renders all particles of a system as point sprites using the render shader, in the species' shape, size, and color.
  * Sets up OpenGL state for blending and point size, then draws all particles in a single call.
+ * Does nothing for a disabled system.
  */
-void particleSystemRender() {
+void particleSystemRender(ParticleSystem* system) {
+    if (!system || !system->enabled) return; // Disabled systems cost no GPU time.
     glUseProgram(renderShader); // Activate the render shader program. This shader will handle the appearance of each particle when drawn.
     POINT_SPRITE_ON();          // Enable point sprite rendering (if supported on this platform). This allows each particle to be drawn as a camera-facing square.
     glEnable(GL_BLEND);         // Enable alpha blending so particles can be semi-transparent and blend smoothly with the background and each other.
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Set the blending function to standard alpha blending (source over destination).
 
-    VAO_BIND(particleVAOs[curSrc]); // Bind the VAO containing the current particle data. This tells OpenGL which buffer and attribute layout to use.
-    glPointSize(30.0f);         // Set the size of each particle in pixels. Larger values make particles appear bigger on screen.
-    glDrawArrays(GL_POINTS, 0, NUM_PARTICLES); // Draw all particles as points. Each point will be rendered as a sprite by the shader.
+    glUniform4fv(colorLoc, 1, system->species.color); // Pass the sprite color and opacity of the species.
+    glUniform1i(spriteLoc, system->species.sprite);    // Pass the sprite shape: snowflake or rain streak.
+    VAO_BIND(system->vaos[system->current]); // Bind the VAO containing the current particle data. This tells OpenGL which buffer and attribute layout to use.
+    glPointSize(system->species.pointSize); // Set the size of each particle in pixels. Larger values make particles appear bigger on screen.
+    glDrawArrays(GL_POINTS, 0, system->capacity); // Draw all particles as points. Each point will be rendered as a sprite by the shader.
     VAO_UNBIND();               // Unbind the VAO to avoid accidental modification or conflicts with other draw calls.
 
     POINT_SPRITE_OFF();         // Disable point sprite rendering (if it was enabled). This restores OpenGL state for the rest of the scene.
@@ -269,33 +434,36 @@ void particleSystemRender() {
     glUseProgram(0);            // Unbind the shader program to clean up OpenGL state.
 }
 
-/* --- Function: particleSystemCleanup ---
- * Deletes all OpenGL resources used by the particle system.
- * This is important to avoid memory leaks when the program exits or the system is reinitialized.
+/* --- Function: particleSystemDestroy ---
+ * Deletes the VAOs and VBOs of one particle system and frees it.
  */
-void particleSystemCleanup() {
-    // Delete the VAOs and VBOs to free GPU resources.
-    // This is important to avoid memory leaks when the program exits or the system is reinitialized.
-    VAO_DELETE(2, particleVAOs);      // Delete both Vertex Array Objects (VAOs) used for ping-pong buffering.
-    glDeleteBuffers(2, particleVBOs); // Delete both Vertex Buffer Objects (VBOs) used for ping-pong buffering.
+void particleSystemDestroy(ParticleSystem* system) {
+    if (!system) return;
+    VAO_DELETE(2, system->vaos);      // Delete both Vertex Array Objects (VAOs) used for ping-pong buffering.
+    glDeleteBuffers(2, system->vbos); // Delete both Vertex Buffer Objects (VBOs) used for ping-pong buffering.
+    free(system);
 }
 
-/* --- Function: particleSystemSetEnabled ---
- * Placeholder for enabling/disabling the particle system.
- * Could be used to toggle weather effects on/off in the future.
+/* --- Function: particleSystemCleanup ---
+ * Deletes the shader programs and the heightmap texture shared by all particle systems.
+ * Call after every system has been destroyed, e.g. when the program exits.
  */
-void particleSystemSetEnabled(int enabled) {
-    // This function is a placeholder for enabling/disabling the particle system.
-    // It could be used in the future to toggle weather effects on or off, pause the simulation, or implement other controls.
-    // Currently, it does nothing, but it is included for modularity and future extensibility.
+void particleSystemCleanup() {
+    if (updateShader) glDeleteProgram(updateShader);
+    if (renderShader) glDeleteProgram(renderShader);
+    if (heightmapTex) glDeleteTextures(1, &heightmapTex);
+    updateShader = renderShader = 0;
+    heightmapTex = 0;
 }
 
 /* --- Function: particleSystemUploadHeightmap ---
- * Uploads the landscape elevation data as a 128x128 single-channel (red) texture.
+ * Uploads the landscape elevation data as a size x size single-channel (red) texture.
  * This texture is used by the update shader to detect when particles hit the ground.
+ * Also records the heightmap's resolution and world-space extent, a 'scale' wide square from (minX, minZ), for spawning
+ * and collision. Uploading another window of the world later moves the weather's ground there.
  */
-void particleSystemUploadHeightmap(float* elevationData) {
-    // This function uploads the landscape elevation data as a 128x128 single-channel (red) texture to the GPU.
+void particleSystemUploadHeightmap(const float* elevationData, int size, float scale, float minX, float minZ) {
+    // This function uploads the landscape elevation data as a size x size single-channel (red) texture to the GPU.
     // The update shader uses this texture to detect when particles hit the ground, enabling realistic collision and respawn behavior.
     if (!heightmapTex) { // If the heightmap texture has not been created yet...
         glGenTextures(1, &heightmapTex); // Generate a new texture object and store its handle.
@@ -305,7 +473,27 @@ void particleSystemUploadHeightmap(float* elevationData) {
     } else {
         glBindTexture(GL_TEXTURE_2D, heightmapTex); // If the texture already exists, just bind it for updating.
     }
+    // Remember the grid resolution and terrain bounds so the update shader maps world positions onto the texture correctly.
+    terrainSize = size;
+    terrainScale = scale;
+    terrainMinX = minX;
+    terrainMinZ = minZ;
+    terrainMaxX = minX + scale;
+    terrainMaxZ = minZ + scale;
     // Upload the elevation data to the GPU as a single-channel (GL_RED) floating-point texture.
-    // The data is assumed to be a 128x128 array of floats representing terrain elevation.
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, 128, 128, 0, GL_RED, GL_FLOAT, elevationData); // Upload data to GPU.
-}
\ No newline at end of file
+    // The data is a size x size array of floats representing terrain elevation.
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, size, size, 0, GL_RED, GL_FLOAT, elevationData); // Upload data to GPU.
+}
+
+/* --- Function: particleSystemUpdateHeightmapRegion ---
+ * Re-uploads grid vertices [x0, x1) x [z0, z1) of the heightmap texture after the terrain was edited in place.
+ * Only the edited rows and columns are sent, so a small terrain edit costs a small texture update.
+ */
+void particleSystemUpdateHeightmapRegion(const float* elevationData, int x0, int z0, int x1, int z1) {
+    if (!heightmapTex || x0 >= x1 || z0 >= z1) return; // Nothing uploaded yet, or nothing to update.
+    glBindTexture(GL_TEXTURE_2D, heightmapTex); // Bind the heightmap texture for updating.
+    // Read the sub-rectangle straight out of the full heightmap: rows are terrainSize floats apart.
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, terrainSize);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, z0, x1 - x0, z1 - z0, GL_RED, GL_FLOAT, elevationData + (size_t)z0 * terrainSize + x0);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); // Restore the default so other uploads are unaffected.
+}
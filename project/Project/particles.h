@@ -11,13 +11,55 @@ typedef struct {
     float state;
 } Particle;
 
-void particleSystemInit(float terrainScale, float terrainHeight);
-void particleSystemUpdate(float dt);
-void particleSystemRender();
+typedef enum {
+    PARTICLE_EMITTER_FIXED,  // min/max are a box in world space
+    PARTICLE_EMITTER_CAMERA  // min/max are offsets from origin, which follows the camera; falling particles wrap around the box
+} ParticleEmitterMode;
+
+// ParticleEmitter: Axis-aligned box that particles spawn and respawn in.
+typedef struct {
+    float min[3];
+    float max[3];
+    ParticleEmitterMode mode;
+    float origin[3];         // Point the box is placed around, e.g. the ground below the camera's focus (PARTICLE_EMITTER_CAMERA only)
+} ParticleEmitter;
+
+// ParticleSprite: Shape each particle of a species is drawn as.
+typedef enum {
+    PARTICLE_SPRITE_FLAKE,  // Six-armed snowflake
+    PARTICLE_SPRITE_STREAK  // Thin vertical streak, a raindrop smeared by its fall
+} ParticleSprite;
+
+// ParticleSpecies: How one kind of particle falls, rests, and looks.
+typedef struct {
+    float fallSpeed[2]; // Range of downward speeds a particle respawns with
+    float wind[2];      // Horizontal drift (X, Z) while falling
+    float restTime;     // Seconds a landed particle lies on the ground before respawning
+    float pointSize;    // Sprite size in pixels
+    float color[4];     // Sprite color and opacity
+    ParticleSprite sprite; // Sprite shape
+} ParticleSpecies;
+
+typedef struct ParticleSystem ParticleSystem;
+
+extern const ParticleSpecies particleSpeciesSnow;
+extern const ParticleSpecies particleSpeciesRain;
+
+ParticleSystem* particleSystemCreate(int capacity, const ParticleEmitter* emitter, const ParticleSpecies* species, unsigned int seed);
+void particleSystemDestroy(ParticleSystem* system);
+int particleSystemResize(ParticleSystem* system, int capacity);
+void particleSystemSetEmitter(ParticleSystem* system, const ParticleEmitter* emitter);
+void particleSystemFollow(ParticleSystem* system, const float origin[3]);
+void particleSystemSetSpecies(ParticleSystem* system, const ParticleSpecies* species);
+void particleSystemSetEnabled(ParticleSystem* system, int enabled);
+int particleSystemEnabled(const ParticleSystem* system);
+int particleSystemCapacity(const ParticleSystem* system);
+void particleSystemUpdate(ParticleSystem* system, float dt);
+void particleSystemRender(ParticleSystem* system);
 void particleSystemCleanup();
-void particleSystemSetEnabled(int enabled);
-void particleSystemUploadHeightmap(float* elevationData);
+void particleSystemUploadHeightmap(const float* elevationData, int size, float scale, float minX, float minZ);
+void particleSystemUpdateHeightmapRegion(const float* elevationData, int x0, int z0, int x1, int z1);
 
 #ifdef __cplusplus
 }
-#endif 
\ No newline at end of file
+#endif
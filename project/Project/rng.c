@@ -0,0 +1,79 @@
+/*
+ * rng.c - Seeded, Reentrant Random Number Streams
+ *
+ * This file provides the random numbers for all procedural placement and variation in the scene (grass, trees,
+ * boulders, clouds, weather particles, leaves, and erosion droplets). Each system seeds its own streams instead of
+ * sharing the C library's rand(), so generators can run on any thread, in any order, and still build the same world.
+ *
+ * Key Concepts:
+ * - PCG32: A 64-bit linear congruential state with a permuted 32-bit output; small, fast, and statistically solid.
+ * - Streams: The increment of the LCG selects one of 2^63 independent sequences, so a loop can give every thread,
+ *   batch, or candidate index its own stream from one seed. Work split that way produces bit-identical results no
+ *   matter how many threads run it or in which order the pieces finish.
+ * - Counter-based hashing: rngHash maps (seed, index) straight to a random value with no state at all, for values
+ *   that are looked up by index (such as per-vertex shape noise) rather than drawn in sequence.
+ *
+ * Function Roles:
+ * - rngSeed: Places a stream at the start of the sequence selected by (seed, stream).
+ * - rngNext: Returns the next 32 random bits of a stream.
+ * - rngFloat / rngRange / rngInt: Uniform float in [0, 1), float in [a, b), and integer in [0, n).
+ * - rngHash / rngHashFloat: Stateless random bits or float in [0, 1) for (seed, index).
+ */
+
+#include "rng.h"
+
+#define RNG_MULTIPLIER 6364136223846793005ULL // PCG32 LCG multiplier
+
+// rngSeed: Starts the stream selected by (seed, stream).
+// The seed is spread over the whole 64-bit state so small neighbouring seeds do not begin on nearby states.
+void rngSeed(Rng* rng, unsigned int seed, unsigned int stream) {
+    rng->state = 0;
+    rng->inc = ((unsigned long long)stream << 1) | 1u; // The increment must be odd.
+    rngNext(rng);
+    rng->state += ((unsigned long long)rngHash(seed, stream) << 32) | seed;
+    rngNext(rng);
+}
+
+// rngNext: Advances the LCG and returns the xorshifted, randomly rotated high bits of the old state.
+unsigned int rngNext(Rng* rng) {
+    unsigned long long old = rng->state;
+    rng->state = old * RNG_MULTIPLIER + rng->inc;
+    unsigned int xorshifted = (unsigned int)(((old >> 18) ^ old) >> 27);
+    unsigned int rot = (unsigned int)(old >> 59);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+// rngFloat: Uniform float in [0, 1) from the top 24 bits, so every value is exactly representable.
+float rngFloat(Rng* rng) {
+    return (rngNext(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+// rngRange: Uniform float in [a, b).
+float rngRange(Rng* rng, float a, float b) {
+    return a + rngFloat(rng) * (b - a);
+}
+
+// rngInt: Uniform integer in [0, n) for n > 0, by scaling the 32 random bits (no modulo bias worth noticing).
+int rngInt(Rng* rng, int n) {
+    return (int)(((unsigned long long)rngNext(rng) * (unsigned int)n) >> 32);
+}
+
+// rngMix: lowbias32 integer mixer; every input bit affects every output bit.
+static unsigned int rngMix(unsigned int h) {
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+// rngHash: Stateless 32-bit hash of (seed, index). The index is folded in after the seed is mixed, then mixed again.
+unsigned int rngHash(unsigned int seed, unsigned int index) {
+    return rngMix(rngMix(seed * 0x9E3779B9u + 0x7F4A7C15u) ^ index);
+}
+
+// rngHashFloat: Stateless uniform float in [0, 1) for (seed, index).
+float rngHashFloat(unsigned int seed, unsigned int index) {
+    return (rngHash(seed, index) >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,18 @@
+#ifndef RNG_H
+#define RNG_H
+
+// Rng: One PCG32 random stream. Streams with the same seed but different stream numbers are independent.
+typedef struct {
+    unsigned long long state; // Current position in the sequence
+    unsigned long long inc;   // Odd increment selecting the stream
+} Rng;
+
+void rngSeed(Rng* rng, unsigned int seed, unsigned int stream);
+unsigned int rngNext(Rng* rng);
+float rngFloat(Rng* rng);
+float rngRange(Rng* rng, float a, float b);
+int rngInt(Rng* rng, int n);
+unsigned int rngHash(unsigned int seed, unsigned int index);
+float rngHashFloat(unsigned int seed, unsigned int index);
+
+#endif
@@ -50,25 +50,33 @@ static void printProgramLog(int obj)
    }
 }
 
+static void attachShader(int program,GLenum type,const char* file)
+{
+   int shader = glCreateShader(type);
+   char* text = readText(file);
+   glShaderSource(shader,1,(const char**)&text,NULL);
+   free(text);
+   glCompileShader(shader);
+   printShaderLog(shader,file);
+   glAttachShader(program,shader);
+}
+
 int loadShader(const char* vertexFile, const char* fragmentFile)
+{
+   return loadShaderStages(vertexFile,NULL,fragmentFile);
+}
+
+//  Geometry shaders need OpenGL 3.2; headers without them only load vertex and fragment stages
+int loadShaderStages(const char* vertexFile, const char* geometryFile, const char* fragmentFile)
 {
    int program = glCreateProgram();
-   int vert = glCreateShader(GL_VERTEX_SHADER);
-   char* vertexText = readText(vertexFile);
-   glShaderSource(vert,1,(const char**)&vertexText,NULL);
-   free(vertexText);
-   glCompileShader(vert);
-   printShaderLog(vert,vertexFile);
-   glAttachShader(program,vert);
-   if (fragmentFile) {
-       int frag = glCreateShader(GL_FRAGMENT_SHADER);
-       char* fragmentText = readText(fragmentFile);
-       glShaderSource(frag,1,(const char**)&fragmentText,NULL);
-       free(fragmentText);
-       glCompileShader(frag);
-       printShaderLog(frag,fragmentFile);
-       glAttachShader(program,frag);
-   }
+   attachShader(program,GL_VERTEX_SHADER,vertexFile);
+#ifdef GL_GEOMETRY_SHADER
+   if (geometryFile) attachShader(program,GL_GEOMETRY_SHADER,geometryFile);
+#else
+   if (geometryFile) fprintf(stderr,"Geometry shaders are not supported: %s\n",geometryFile);
+#endif
+   if (fragmentFile) attachShader(program,GL_FRAGMENT_SHADER,fragmentFile);
    glLinkProgram(program);
    printProgramLog(program);
    return program;
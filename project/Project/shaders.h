@@ -3,6 +3,8 @@
 
 int loadShader(const char* vertexFile, const char* fragmentFile);
 
+int loadShaderStages(const char* vertexFile, const char* geometryFile, const char* fragmentFile);
+
 void useShader(int shader);
 
 void deleteShader(int shader);
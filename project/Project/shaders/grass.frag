@@ -13,6 +13,7 @@
  * - Transparency: Alpha blending for realistic grass blade appearance
  * - Realistic Shading: Proper normal-based lighting calculations
  * - Natural Variation: Procedural color variation within each palette
+ * - Clump Cards: Far cards are cut into 'clump' spikes of varying height, one per blade the card stands in for
  *
  * Lighting Model:
  * - Ambient: Base illumination level for shadowed areas (30% intensity)
@@ -34,13 +35,24 @@ varying vec3 vNormal; // Interpolated normal vector for lighting calculations
 varying float vColorVar; // Color variation factor for blade diversity
 varying vec2 vTexCoord; // Interpolated texture coordinates for grass mapping
 varying float vColorIndex; // Color palette index for blade variation
+varying float vCard; // 1 on clump cards, 0 on blades
 
 // Uniform variables set by the application
 uniform vec3 sunDir; // Sun direction vector for lighting calculations
 uniform vec3 ambient; // Ambient lighting color and intensity
 uniform sampler2D grassTex; // Grass texture for surface detail mapping
+uniform float clump; // Blades per clump card
 
 void main() {
+    // Cut clump cards into spikes: each spike is a triangle across its share of the card, with a tip height between
+    // 60% and 100% of the card chosen from the spike index and the card's color variation.
+    if (vCard > 0.5) {
+        float spike = floor(vTexCoord.x * clump);
+        float across = abs(fract(vTexCoord.x * clump) * 2.0 - 1.0);
+        float top = 0.6 + 0.4 * fract(sin(spike * 12.9898 + vColorVar * 78.233) * 43758.5453);
+        if (across > 1.0 - vTexCoord.y / top) discard;
+    }
+
     // Define color palette for grass variation
     // Four different grass colors for natural landscape diversity
     vec3 palette[4];
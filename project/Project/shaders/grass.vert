@@ -13,41 +13,62 @@
  * - Twisting Effects: Rotation around the blade axis for natural variation
  * - Individual Variation: Each blade has unique sway seed, color, and dimensions
  * - Dynamic Alpha: Transparency based on sway intensity for realistic rendering
+ * - Distance Fade: Blades shrink away as their distance thins the grass, before the CPU stops drawing them
+ * - Levels of Detail: The same code bends the near multi-segment blade, the mid triangle, and the far clump card
  *
  * Animation System:
  * - Wind Sway: Sinusoidal motion based on time, position, and individual seed
  * - Tip Factor: Sway intensity increases toward blade tip
  * - Curvature: Natural bend along blade length using sine function
  * - Twisting: Rotation around Y-axis for natural blade variation
+ * - Geomorph: Curve and twist straighten from the sine shape to a straight line between the base and the tip as the
+ *   blade moves from lodRange.x to lodRange.y, where the curved strip matches the mid triangle exactly
  *
  * Input Attributes:
- * - position: Base position of grass blade in world space
- * - swaySeed: Unique seed for individual blade animation
- * - offsetX/Y: Local position within the blade (0 to bladeWidth/Height)
- * - bladeHeight/Width: Dimensions of the individual blade
- * - colorVar: Color variation factor for blade diversity
- * - rotation: Individual blade rotation around Y-axis
+ * - corner: Vertex of the shared blade mesh, across (x) and up (y) the blade in [0, 1] (per vertex)
+ * - position: Base position of the blade (xyz) and its color variation factor (w) (per instance)
+ * - blade: Sway seed (x), blade height (y), blade width (z), rotation around the Y-axis (w) (per instance)
+ * The per-instance attributes are 16-bit values normalized to [0, 1] and decoded with the range uniforms.
+ *
+ * The local offsets within the blade are the mesh corner scaled by the blade size: the base runs from (0, 0) to
+ * (bladeWidth, 0) and the tip sits at (bladeWidth / 2, bladeHeight). A clump card stands in for 'clump' blades: it is
+ * 'clump' blade widths wide, centered on its blade's base, and the fragment shader cuts it into one spike per blade.
  *
  * Uniform Variables:
  * - time: Current time for animation
  * - windStrength: Wind intensity multiplier
+ * - positionMin/positionRange: Decode box of the position attribute
+ * - bladeRange: Decoded span of blade height, width, and rotation
+ * - eyePos: World-space camera position
+ * - fade: Distance where thinning starts (x) and where no grass is left (y), and the seed range a blade shrinks over (z)
+ * - lod: Mesh being drawn: 0 near blade, 1 mid triangle, 2 clump card
+ * - lodRange: Near blades straighten from x to y; blades shrink away and cards grow in from z to w
+ * - clump: Blades per clump card
+ *
+ * Blades are stored by sway seed within each cell and the CPU draws the prefix of a cell its distance allows. The
+ * density runs from 1 + fade.z at the fade start down to 0 at the fade end; a blade is full size while its seed is
+ * fade.z below the density and shrinks to nothing as the density drops to its seed, so it vanishes before the CPU
+ * stops drawing it instead of popping.
  */
 
 #version 120
 
-// Input attributes for individual grass blade properties
-attribute vec3 position; // Base position of grass blade in world space
-attribute float swaySeed; // Unique seed for individual blade animation variation
-attribute float offsetX; // Local X position within blade (0 to bladeWidth)
-attribute float offsetY; // Local Y position within blade (0 to bladeHeight)
-attribute float bladeHeight; // Height of the individual grass blade
-attribute float bladeWidth; // Width of the individual grass blade
-attribute float colorVar; // Color variation factor for blade diversity
-attribute float rotation; // Individual blade rotation around Y-axis
+// Shared blade mesh vertex and packed per-blade instance attributes
+attribute vec2 corner; // Position on the blade mesh: across, up
+attribute vec4 position; // Base position of grass blade and color variation, quantized
+attribute vec4 blade; // Sway seed, height, width, rotation, quantized
 
 // Uniform variables for animation and effects
 uniform float time; // Current time for wind animation
 uniform float windStrength; // Wind intensity multiplier
+uniform vec4 positionMin; // Decoded value of a zero position component
+uniform vec4 positionRange; // Decoded span of the position components
+uniform vec3 bladeRange; // Decoded span of blade height, width, and rotation
+uniform vec3 eyePos; // Camera position for the distance fade
+uniform vec3 fade; // Fade start distance, fade end distance, shrink width in seed units
+uniform float lod; // Level of detail of the mesh being drawn
+uniform vec4 lodRange; // Geomorph start and end, card cross-fade start and end
+uniform float clump; // Blades per clump card
 
 // Output variables passed to fragment shader
 varying float vAlpha; // Alpha value for transparency effects
@@ -55,16 +76,38 @@ varying vec3 vNormal; // Transformed normal vector for lighting
 varying float vColorVar; // Color variation passed to fragment shader
 varying vec2 vTexCoord; // Texture coordinates for grass surface
 varying float vColorIndex; // Color palette index for blade variation
+varying float vCard; // 1 on clump cards, 0 on blades
 
 void main() {
+    // Decode the packed attributes
+    vec4 base = positionMin + position * positionRange;
+    float swaySeed = blade.x;
+    float dist = distance(base.xyz, eyePos);
+    float density = (1.0 + fade.z) * (1.0 - clamp((dist - fade.x) / (fade.y - fade.x), 0.0, 1.0));
+    float size = clamp((density - swaySeed) / fade.z, 0.0, 1.0); // Shrinks to nothing as the blade is thinned out
+    // Cross-fade between blades and clump cards over the far band: blades shrink as the cards grow.
+    float card = step(1.5, lod);
+    float cardBlend = clamp((dist - lodRange.z) / (lodRange.w - lodRange.z), 0.0, 1.0);
+    size *= mix(1.0 - cardBlend, cardBlend, card);
+    float bladeHeight = max(blade.y * bladeRange.x * size, 0.001); // Kept above zero: the curve divides by it
+    float bladeWidth = blade.z * bladeRange.y * size * mix(1.0, clump, card);
+    float rotation = blade.w * bladeRange.z;
+    float colorVar = base.w;
+    float offsetX = (corner.x - 0.5 * card) * bladeWidth; // Cards are centered on their blade
+    float offsetY = corner.y * bladeHeight;
+    
+    // Straighten the near blade into the mid triangle with distance; the triangle and the card are always straight
+    // (they only have vertices at the base and the tip).
+    float morph = max(clamp((dist - lodRange.x) / (lodRange.y - lodRange.x), 0.0, 1.0), step(0.5, lod));
+    
     // Calculate natural blade curvature using sine function
     // Creates realistic bend along the blade length (35% maximum curve)
-    float curve = 0.35 * sin(offsetY / bladeHeight * 1.57);
+    float curve = 0.35 * mix(sin(offsetY / bladeHeight * 1.57), offsetY / bladeHeight, morph);
     
     // Calculate wind-induced swaying motion
     // Combines time, position, and individual seed for unique animation
     // Wind strength controls the intensity of the sway effect
-    float sway = sin(time * 1.5 + position.x * 0.2 + position.z * 0.3 + swaySeed * 6.28) * 0.2 * windStrength;
+    float sway = sin(time * 1.5 + base.x * 0.2 + base.z * 0.3 + swaySeed * 6.28) * 0.2 * windStrength;
     
     // Calculate tip factor for progressive sway (more sway at blade tip)
     // This creates realistic motion where blade tips move more than bases
@@ -73,7 +116,8 @@ void main() {
     
     // Calculate blade twisting effect for natural variation
     // Creates rotation around the blade axis based on height and seed
-    float twist = 0.15 * sin(offsetY * 6.0 / bladeHeight + swaySeed * 3.0);
+    float twist = 0.15 * mix(sin(offsetY * 6.0 / bladeHeight + swaySeed * 3.0),
+                             mix(sin(swaySeed * 3.0), sin(6.0 + swaySeed * 3.0), offsetY / bladeHeight), morph);
     
     // Build local blade position with curvature, twisting, and offsets
     vec3 local = vec3(offsetX + twist, offsetY, curve);
@@ -91,7 +135,7 @@ void main() {
     local = rotY * local;
     
     // Calculate final world position by combining base position and local coordinates
-    vec3 pos = position + local;
+    vec3 pos = base.xyz + local;
     pos.x += swayX; // Apply wind sway to final position
     
     // Calculate alpha for transparency based on sway intensity
@@ -106,18 +150,13 @@ void main() {
     vColorVar = colorVar;
     
     // Generate texture coordinates based on position within blade
-    // Creates proper UV mapping for grass texture
-    if (abs(offsetX) < 0.001 && abs(offsetY) < 0.001) {
-        vTexCoord = vec2(0.0, 0.0); // Base left corner
-    } else if (abs(offsetX - bladeWidth) < 0.001 && abs(offsetY) < 0.001) {
-        vTexCoord = vec2(1.0, 0.0); // Base right corner
-    } else {
-        vTexCoord = vec2(0.5, 1.0); // Blade tip
-    }
+    // Creates proper UV mapping for grass texture (base corners at v = 0, tip at (0.5, 1))
+    vTexCoord = corner;
     
     // Calculate color palette index for blade variation
     // Maps color variation to discrete palette indices
     vColorIndex = floor(colorVar * 4.0 + 2.0) / 4.0;
+    vCard = card;
     
     // Transform final position to clip space for rendering
     gl_Position = gl_ModelViewProjectionMatrix * vec4(pos, 1.0);
@@ -0,0 +1,68 @@
+/*
+ * Grass Cull Vertex Shader - Per-Blade Visibility Test for GPU Grass Culling
+ *
+ * This vertex shader runs once per packed grass blade record (drawn as points with the rasterizer off) and decides
+ * whether the blade is drawn this frame at the level of detail being culled. The geometry shader passes the survivors
+ * on to transform feedback, which packs them tightly into that level of detail's draw buffer.
+ *
+ * Tests:
+ * - Distance Band: The blade's distance from the camera must lie in the band of the level of detail being culled
+ * - Density: The blade's sway seed must be below the distance density, the same test that shrinks it to nothing in
+ *   the grass shader, so thinned-out blades are dropped instead of drawn at zero size
+ * - Frustum: A sphere around the blade (half its height plus room for sway, curve, and clump card width) must be
+ *   inside all six view frustum planes
+ *
+ * Input Attributes:
+ * - position: Base position of the blade (xyz) and its color variation factor (w), 16-bit normalized
+ * - blade: Sway seed (x), blade height (y), blade width (z), rotation around the Y-axis (w), 16-bit normalized
+ *
+ * Uniform Variables:
+ * - positionMin/positionRange: Decode box of the position attribute of the patch being culled
+ * - bladeRange: Decoded span of blade height, width, and rotation
+ * - eyePos: World-space camera position
+ * - fade: Distance where thinning starts (x) and where no grass is left (y), and the seed range a blade shrinks over (z)
+ * - band: Distances from (x) and up to (y) the level of detail being culled covers
+ * - planes: View frustum planes with inward normals, normalized so the distance is in world units
+ *
+ * Outputs:
+ * - cullPosition: Decoded world-space base position and color variation
+ * - cullBlade: Blade attributes, still in [0, 1]
+ * - cullKeep: 1 if the blade survives, 0 otherwise
+ */
+
+#version 150
+
+in vec4 position; // Base position of grass blade and color variation, quantized
+in vec4 blade; // Sway seed, height, width, rotation, quantized
+
+uniform vec4 positionMin; // Decoded value of a zero position component
+uniform vec4 positionRange; // Decoded span of the position components
+uniform vec3 bladeRange; // Decoded span of blade height, width, and rotation
+uniform vec3 eyePos; // Camera position for the distance tests
+uniform vec3 fade; // Fade start distance, fade end distance, shrink width in seed units
+uniform vec2 band; // Distance band of the level of detail being culled
+uniform vec4 planes[6]; // View frustum planes
+
+out vec4 cullPosition; // Decoded blade position passed to the geometry shader
+out vec4 cullBlade; // Blade attributes passed to the geometry shader
+out float cullKeep; // Visibility of the blade
+
+void main() {
+    vec4 base = positionMin + position * positionRange;
+    float dist = distance(base.xyz, eyePos);
+    float density = (1.0 + fade.z) * (1.0 - clamp((dist - fade.x) / (fade.y - fade.x), 0.0, 1.0));
+    float height = blade.y * bladeRange.x;
+    
+    // Bounding sphere around the blade: centered halfway up, with a unit of room for sway, curve, and card width
+    vec3 center = base.xyz + vec3(0.0, 0.5 * height, 0.0);
+    float radius = 0.5 * height + 1.0;
+    bool visible = dist >= band.x && dist < band.y && blade.x < density;
+    for (int i = 0; i < 6; i++) {
+        visible = visible && dot(planes[i].xyz, center) + planes[i].w > -radius;
+    }
+    
+    cullPosition = base;
+    cullBlade = blade;
+    cullKeep = visible ? 1.0 : 0.0;
+    gl_Position = vec4(0.0);
+}
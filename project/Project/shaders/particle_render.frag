@@ -19,14 +19,20 @@
  * - Multiple Layers: Combines outer arms with inner core
  * - Procedural Variation: Each snowflake has unique characteristics
  *
+ * Rain Streaks:
+ * - Thin vertical streak tapered at both ends, a raindrop smeared by its fall
+ * - Chosen per species through the 'sprite' uniform (0 = snowflake, 1 = streak)
+ *
  * Color System:
- * - Snow: Light blue-white colors for realistic snow appearance
- * - Rain: Can be adapted for rain drop rendering
+ * - Species Color: Each particle species passes its own tint (light blue-white snow, grey-blue rain)
  * - Transparency: Alpha blending for realistic particle effects
  */
 
 #version 120
 
+uniform vec4 color; // Sprite color and base opacity of the particle species
+uniform int sprite; // Sprite shape of the particle species (0 = snowflake, 1 = rain streak)
+
 // Procedural snowflake generation function
 // Creates realistic 6-pointed snowflake patterns using mathematical functions
 float simpleSnowflake(vec2 uv) {
@@ -52,16 +58,22 @@ float simpleSnowflake(vec2 uv) {
     return clamp(flake, 0.0, 1.0);
 }
 
+// Rain streak generation function
+// Creates a thin vertical line that fades out towards its top and bottom
+float rainStreak(vec2 uv) {
+    // Transform UV coordinates from [0,1] to [-1,1] range
+    uv = uv * 2.0 - 1.0;
+    
+    // Narrow across, long along the fall direction, tapered at both ends
+    return smoothstep(0.12, 0.0, abs(uv.x)) * smoothstep(1.0, 0.6, abs(uv.y));
+}
+
 void main() {
-    // Generate snowflake pattern at current point coordinate
+    // Generate the species' pattern at current point coordinate
     // gl_PointCoord provides UV coordinates within the point sprite
-    float flake = simpleSnowflake(gl_PointCoord);
-    
-    // Calculate snowflake color with light blue-white tint
-    // Mix between light blue (0.85, 0.92, 1.0) and pure white (1.0, 1.0, 1.0)
-    vec3 snowColor = mix(vec3(0.85, 0.92, 1.0), vec3(1.0), 0.5);
+    float flake = sprite == 1 ? rainStreak(gl_PointCoord) : simpleSnowflake(gl_PointCoord);
     
     // Set final fragment color with transparency
-    // Alpha combines snowflake pattern with 85% base transparency
-    gl_FragColor = vec4(snowColor, flake * 0.85);
+    // Alpha combines the snowflake pattern with the species' base opacity
+    gl_FragColor = vec4(color.rgb, flake * color.a);
 } 
\ No newline at end of file
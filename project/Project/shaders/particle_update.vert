@@ -17,13 +17,15 @@
  * Particle States:
  * - State 0: Falling particles affected by wind and gravity
  * - State 1: Accumulated particles on terrain surface
- * - Regeneration: Particles respawn at cloud height after accumulation time
+ * - Regeneration: Particles respawn inside the emitter box after resting for restThreshold seconds
  *
  * Physics System:
  * - Gravity: Constant downward acceleration (-10.0 units/s²)
  * - Wind: Dynamic horizontal wind forces affecting particle movement
  * - Collision: Terrain height detection with margin for realistic accumulation
  * - Boundaries: Clamping to terrain boundaries to prevent particle escape
+ * - Toroidal Box: A camera emitter wraps falling particles that leave one side of the box back in on the
+ *   opposite side, so the box moves with the camera without respawning anything; landed particles stay put
  *
  * Input Attributes:
  * - pos: Current particle position in world space
@@ -34,11 +36,14 @@
  * Uniform Variables:
  * - dt: Delta time for physics integration
  * - time: Current simulation time
- * - cloudHeight: Height where particles spawn
+ * - emitterMin/emitterMax: Box that particles respawn in
+ * - emitterWrap: 1 to wrap falling particles around the box horizontally (camera emitter), 0 to leave them
+ * - fallSpeed: Range of downward speeds a respawned particle falls at
+ * - restThreshold: Seconds a landed particle rests before it respawns
  * - landscapeScale/Size: Terrain dimensions for coordinate conversion
  * - heightmap: Terrain height texture for collision detection
  * - wind: Current wind vector affecting particle movement
- * - terrainBounds: Terrain boundary constraints
+ * - terrainBounds: World-space area the heightmap covers (its minimum corner also places it)
  */
 
 #version 120
@@ -52,7 +57,10 @@ attribute float state; // Particle state (0 = falling, 1 = accumulated)
 // Uniform variables for physics simulation
 uniform float dt; // Delta time for physics integration
 uniform float time; // Current simulation time
-uniform float cloudHeight; // Height where particles spawn
+uniform vec3 emitterMin, emitterMax; // Box that particles respawn in
+uniform float emitterWrap; // 1 when falling particles wrap around the box (camera emitter)
+uniform vec2 fallSpeed; // Range of respawn fall speeds (slowest, fastest)
+uniform float restThreshold; // Seconds a landed particle rests before it respawns
 uniform float landscapeScale; // Terrain scale factor
 uniform float landscapeSize; // Terrain grid size
 uniform sampler2D heightmap; // Terrain height texture
@@ -69,9 +77,9 @@ varying float outState; // Updated particle state
 // Function to sample terrain height at given world coordinates
 // Converts world coordinates to texture coordinates for heightmap sampling
 float getTerrainHeight(float x, float z) {
-    // Convert world coordinates to normalized texture coordinates
-    vec2 uv = vec2((x / landscapeScale + 0.5) * (landscapeSize - 1.0), 
-                   (z / landscapeScale + 0.5) * (landscapeSize - 1.0)) / (landscapeSize - 1.0);
+    // Convert world coordinates to normalized texture coordinates (the heightmap starts at terrainMinX, terrainMinZ)
+    vec2 uv = vec2((x - terrainMinX) / landscapeScale * (landscapeSize - 1.0),
+                   (z - terrainMinZ) / landscapeScale * (landscapeSize - 1.0)) / (landscapeSize - 1.0);
     
     // Sample heightmap and return terrain height
     return texture2D(heightmap, uv).r;
@@ -96,6 +104,13 @@ void main() {
         // Integrate position using velocity and delta time
         newPos = pos + newVel * dt;
         
+        // Wrap around a camera box horizontally so falling particles travel with the camera
+        if (emitterWrap > 0.5) {
+            vec2 size = emitterMax.xz - emitterMin.xz;
+            newPos.xz = emitterMin.xz + mod(newPos.xz - emitterMin.xz, size);
+            terrainY = getTerrainHeight(newPos.x, newPos.z); // The ground under the wrapped position
+        }
+        
         // Clamp position to terrain boundaries with margin
         newPos.x = clamp(newPos.x, terrainMinX + margin, terrainMaxX - margin);
         newPos.z = clamp(newPos.z, terrainMinZ + margin, terrainMaxZ - margin);
@@ -115,16 +130,17 @@ void main() {
         newRestTime = restTime + dt;
         newVel = vec3(0.0); // Keep accumulated particles stationary
         
-        // Check if particle should regenerate (after 5 seconds)
-        if (newRestTime > 5.0) {
-            // Generate new random position within terrain bounds
+        // Check if particle should regenerate (after resting long enough for its species)
+        if (newRestTime > restThreshold) {
+            // Generate new random position within the emitter box
             // Uses hash function for pseudo-random but deterministic positioning
-            float rx = terrainMinX + margin + (terrainMaxX - terrainMinX - 2.0 * margin) * fract(sin(pos.x * 12.9898) * 43758.5453);
-            float rz = terrainMinZ + margin + (terrainMaxZ - terrainMinZ - 2.0 * margin) * fract(sin(pos.z * 78.233) * 43758.5453);
+            vec3 h = vec3(fract(sin(pos.x * 12.9898) * 43758.5453),
+                          fract(sin((pos.x + pos.z) * 39.3468) * 43758.5453),
+                          fract(sin(pos.z * 78.233) * 43758.5453));
             
-            // Respawn particle at cloud height with downward velocity
-            newPos = vec3(rx, cloudHeight, rz);
-            newVel = vec3(0.0, -10.0, 0.0); // Initial downward velocity
+            // Respawn particle inside the emitter with a downward velocity from the species' range
+            newPos = mix(emitterMin, emitterMax, h);
+            newVel = vec3(0.0, -mix(fallSpeed.x, fallSpeed.y, fract(h.x + h.z)), 0.0); // Initial downward velocity
             newRestTime = 0.0; // Reset rest time
             newState = 0.0; // Change back to falling state
         }
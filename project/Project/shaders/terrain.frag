@@ -0,0 +1,79 @@
+/*
+ * Terrain Fragment Shader - Texture-Splatted Terrain Materials
+ *
+ * This fragment shader picks the terrain material for every pixel from its height, slope, and the current weather,
+ * and mixes in the rock and sand textures. Switching weather only changes the weather uniform.
+ *
+ * Material Rules:
+ * - Fall: Grass on flat ground, light rock on slopes, dark rock on steep slopes, sand just above the water line
+ * - Winter: Snow everywhere except steep slopes, which show dark rock
+ *
+ * Texture Blending:
+ * - Rock and sand colors are mixed with their textures, tiled in world space
+ * - Grass and snow stay untextured (grass blades and snow cover hide the ground)
+ *
+ * Uniform Variables:
+ * - weather: 0 = Fall, 1 = Winter
+ * - waterLevel: Height of the water surface, used for the beach band
+ * - rockTex / sandTex: Rock and sand textures
+ * - fogEnabled: 1 when scene fog is on (fog parameters come from the built-in gl_Fog state)
+ */
+
+#version 120
+
+varying vec3 vWorldPos; // World-space position
+varying vec3 vNormal; // World-space normal
+varying vec3 vLight; // Light intensity from the vertex shader
+
+uniform int weather; // Current weather type
+uniform float waterLevel; // Water surface height
+uniform sampler2D rockTex; // Rock texture
+uniform sampler2D sandTex; // Sand texture
+uniform int fogEnabled; // Whether scene fog is enabled
+
+// Canonical material colors.
+const vec3 grassColor = vec3(0.14, 0.44, 0.15);
+const vec3 lightRockColor = vec3(0.52, 0.47, 0.41);
+const vec3 darkRockColor = vec3(0.23, 0.21, 0.19);
+const vec3 sandColor = vec3(0.74, 0.67, 0.49);
+const vec3 snowColor = vec3(0.96, 0.96, 0.96);
+
+const float texScale = 0.125; // Texture repeats per world unit
+
+void main() {
+    // Slope is higher when the normal is less vertical.
+    float slope = 1.0 - normalize(vNormal).y;
+    vec2 uv = vWorldPos.xz * texScale;
+    vec3 rockTexel = texture2D(rockTex, uv).rgb;
+    vec3 color;
+    
+    if (weather == 1) {
+        // Winter: snow, giving way to textured dark rock on steep slopes.
+        float rockFac = clamp((slope - 0.19) / 0.41, 0.0, 1.0);
+        vec3 rock = mix(darkRockColor, rockTexel, 0.4);
+        color = mix(snowColor, rock, rockFac);
+    } else {
+        // Fall: light to dark rock with steepness, grass on gentle ground.
+        float darkFac = clamp((slope - 0.28) / 0.32, 0.0, 1.0);
+        vec3 rock = mix(mix(lightRockColor, darkRockColor, darkFac), rockTexel, 0.4);
+        float grassFac = clamp((slope - 0.13) / 0.23, 0.0, 1.0);
+        color = mix(grassColor, rock, grassFac);
+        // Sand band just above the water line.
+        float hAboveWater = vWorldPos.y - waterLevel;
+        if (hAboveWater < 2.1 && hAboveWater > -1.0) {
+            float beachFac = clamp(hAboveWater / 2.1, 0.0, 1.0);
+            vec3 sand = mix(sandColor, texture2D(sandTex, uv).rgb, 0.5);
+            color = mix(sand, color, beachFac);
+        }
+    }
+    
+    color = clamp(color * vLight, 0.0, 1.0); // Fixed-function lighting clamps the same way
+    
+    // Exponential squared fog, matching GL_EXP2 in the fixed-function pipeline.
+    if (fogEnabled != 0) {
+        float f = exp(-pow(gl_Fog.density * gl_FogFragCoord, 2.0));
+        color = mix(gl_Fog.color.rgb, color, clamp(f, 0.0, 1.0));
+    }
+    
+    gl_FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,94 @@
+/*
+ * Terrain Vertex Shader - Lighting and Material Inputs for Texture-Splatted Terrain
+ *
+ * This vertex shader feeds the terrain fragment shader. It rebuilds each vertex from the packed terrain stream,
+ * passes the world-space height and normal through so material weights can be computed per pixel, and evaluates
+ * the sun/moon lighting per vertex the same way the fixed-function pipeline did for the terrain (color material
+ * tracking ambient and diffuse, no specular).
+ *
+ * Key Features:
+ * - Packed Vertices: Only the height and an octahedral normal are stored per vertex; x and z follow from the grid
+ * - Material Inputs: World-space position and normal for per-pixel grass/rock/sand/snow blending
+ * - Vertex Lighting: Light model ambient + light 0 ambient + light 0 diffuse, read from the built-in GL state
+ * - Terrain Shadows: Light 0 is looked up in the vertex's horizon angles, and ambient light is scaled by the open sky
+ * - Fog Support: Passes the eye distance to the fragment shader
+ *
+ * Input Attributes:
+ * - gridPos: Grid column and chunk-relative grid row of the vertex (shared by every chunk)
+ * - height: World-space height of the vertex
+ * - octNormal: Unit normal in octahedral encoding, as normalized 16-bit components in [-1, 1]
+ * - horizonsA, horizonsB: Horizon angles in directions 0-3 and 4-7, normalized so 1 is straight up
+ *
+ * Uniform Variables:
+ * - gridRow: First grid row of the chunk being drawn
+ * - gridSpacing: World-space distance between neighbouring grid vertices
+ * - gridOrigin: World-space x and z of grid vertex (0, 0)
+ * - lightingEnabled: 1 when scene lighting is on; otherwise materials are shown unlit
+ * - shadowsEnabled: 1 to apply horizon shadows and occlusion; 0 lights every vertex as if fully exposed
+ * - horizonWeightsA, horizonWeightsB: Blend weights of the horizon directions bracketing light 0's azimuth
+ * - lightElevation: Elevation of light 0 above the horizontal plane, in radians
+ * - shadowPenumbra: Elevation range (radians) over which a vertex fades into shadow
+ */
+
+#version 120
+
+attribute vec2 gridPos; // Grid column, chunk-relative row
+attribute float height; // Vertex height
+attribute vec2 octNormal; // Octahedral-encoded normal
+attribute vec4 horizonsA; // Horizon angles, directions 0-3
+attribute vec4 horizonsB; // Horizon angles, directions 4-7
+
+uniform float gridRow; // First grid row of the current chunk
+uniform float gridSpacing; // World units between grid vertices
+uniform vec2 gridOrigin; // World x/z of the grid's first vertex
+uniform int lightingEnabled; // Whether GL_LIGHTING is enabled for the scene
+uniform int shadowsEnabled; // Whether horizon shadows and ambient occlusion are applied
+uniform vec4 horizonWeightsA; // Weights of directions 0-3 towards the light
+uniform vec4 horizonWeightsB; // Weights of directions 4-7 towards the light
+uniform float lightElevation; // Light elevation in radians
+uniform float shadowPenumbra; // Width of the fade into shadow in radians
+
+varying vec3 vWorldPos; // World-space position for height-based blending and texture coordinates
+varying vec3 vNormal; // World-space normal for slope-based blending
+varying vec3 vLight; // Light intensity reaching this vertex
+
+// Unfolds an octahedral-encoded unit vector (y is the octahedron's up axis).
+vec3 decodeNormal(vec2 e) {
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0) {
+        vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.z >= 0.0 ? 1.0 : -1.0);
+        n.xz = (1.0 - abs(n.zx)) * s;
+    }
+    return normalize(n);
+}
+
+void main() {
+    vec4 vertex = vec4(gridOrigin.x + gridPos.x * gridSpacing, height, gridOrigin.y + (gridPos.y + gridRow) * gridSpacing, 1.0);
+    vec3 normal = decodeNormal(octNormal);
+    vWorldPos = vertex.xyz;
+    vNormal = normal;
+
+    vec4 eyePos = gl_ModelViewMatrix * vertex;
+    if (lightingEnabled != 0) {
+        // Light 0 is the sun or moon; a zero w component means a directional light.
+        vec3 n = normalize(gl_NormalMatrix * normal);
+        vec4 lp = gl_LightSource[0].position;
+        vec3 l = normalize(lp.w == 0.0 ? lp.xyz : lp.xyz - eyePos.xyz);
+        float diff = max(dot(n, l), 0.0);
+        vec2 s = vec2(1.0); // Light visibility, ambient occlusion
+        if (shadowsEnabled != 0) {
+            const float halfPi = 1.5707963;
+            float horizon = (dot(horizonsA, horizonWeightsA) + dot(horizonsB, horizonWeightsB)) * halfPi;
+            s.x = clamp((lightElevation - horizon) / shadowPenumbra + 0.5, 0.0, 1.0);
+            // Cosine-weighted open sky above the horizons: the mean of cos^2 of the horizon angles.
+            vec4 ca = cos(horizonsA * halfPi), cb = cos(horizonsB * halfPi);
+            s.y = (dot(ca, ca) + dot(cb, cb)) * 0.125;
+        }
+        vLight = (gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb) * s.y + gl_LightSource[0].diffuse.rgb * (diff * s.x);
+    } else {
+        vLight = vec3(1.0);
+    }
+
+    gl_FogFragCoord = length(eyePos.xyz);
+    gl_Position = gl_ModelViewProjectionMatrix * vertex;
+}
@@ -0,0 +1,28 @@
+/*
+ * Water Fragment Shader - Translucent Water Surface with Fog
+ *
+ * This fragment shader outputs the interpolated water color from the vertex shader and applies the same
+ * exponential squared fog the fixed-function pipeline uses for the rest of the scene, so the water fades into
+ * the distance consistently with the terrain.
+ *
+ * Uniform Variables:
+ * - fogEnabled: 1 when scene fog is on (fog parameters come from the built-in gl_Fog state)
+ */
+
+#version 120
+
+varying vec4 vColor; // Interpolated water color and alpha
+
+uniform int fogEnabled; // Whether scene fog is enabled
+
+void main() {
+    vec4 color = vColor;
+    
+    // Exponential squared fog, matching GL_EXP2 in the fixed-function pipeline.
+    if (fogEnabled != 0) {
+        float f = exp(-pow(gl_Fog.density * gl_FogFragCoord, 2.0));
+        color.rgb = mix(gl_Fog.color.rgb, color.rgb, clamp(f, 0.0, 1.0));
+    }
+    
+    gl_FragColor = color;
+}
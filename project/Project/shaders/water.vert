@@ -0,0 +1,71 @@
+/*
+ * Water Vertex Shader - Wave Displacement and Time-of-Day Water Color
+ *
+ * This vertex shader animates the water plane on the GPU. The application uploads a static unit grid once, and
+ * every frame this shader scales it to the terrain size, displaces it with a travelling sine wave, and computes
+ * the water color for the current time of day. The CPU only sets a handful of uniforms per frame.
+ *
+ * Key Features:
+ * - Wave Displacement: Diagonal sine wave travelling across the plane over time
+ * - Day Color Blend: Six color stops across the day, blended with a smooth step between neighbors
+ * - Height Shading: Wave crests are tinted slightly lighter than troughs
+ * - Fog Support: Passes the eye distance to the fragment shader for fixed-function style fog
+ *
+ * Input Attributes:
+ * - gridPos: Vertex position on the unit grid, in [-0.5, 0.5] along x and z
+ *
+ * Uniform Variables:
+ * - time: Water animation time in seconds
+ * - dayTime: Time of day in hours (0 to 24)
+ * - waterSize: World-space width of the water plane
+ * - waterCenter: World-space x and z of the plane's center
+ */
+
+#version 120
+
+attribute vec2 gridPos; // Position on the unit water grid (x, z)
+
+uniform float time; // Water animation time in seconds
+uniform float dayTime; // Time of day in hours
+uniform float waterSize; // World-space width of the water plane
+uniform vec2 waterCenter; // World-space center of the water plane (x, z)
+
+varying vec4 vColor; // Water color and alpha for this vertex
+
+// Wave shape, matching the original CPU water.
+const float waveF = 0.021; // Spatial frequency of the waves
+const float waveA = 0.052; // Wave amplitude
+
+// dayColor: Returns the water color for a normalized time of day (0 = midnight, 0.5 = noon).
+vec4 dayColor(float t) {
+    vec4 night = vec4(0.02, 0.02, 0.1, 0.9); // Deep blue at night
+    vec4 dusk = vec4(0.3, 0.2, 0.3, 0.9); // Purple at sunrise and sunset
+    vec4 day = vec4(0.2, 0.3, 0.5, 0.9); // Blue during the day
+    // Color stops at t = 0, 0.25, 0.4, 0.6, 0.75, 1.
+    if (t < 0.25) return mix(night, dusk, smoothstep(0.0, 1.0, t / 0.25));
+    if (t < 0.4) return mix(dusk, day, smoothstep(0.0, 1.0, (t - 0.25) / 0.15));
+    if (t < 0.6) return day;
+    if (t < 0.75) return mix(day, dusk, smoothstep(0.0, 1.0, (t - 0.6) / 0.15));
+    return mix(dusk, night, smoothstep(0.0, 1.0, (t - 0.75) / 0.25));
+}
+
+void main() {
+    // Scale the unit grid up to the terrain size and move it over the terrain; the waves use world coordinates,
+    // so neighbouring planes line up.
+    vec2 xz = gridPos * waterSize + waterCenter;
+    
+    // Displace the surface with a diagonal travelling wave.
+    float y = sin((xz.x + xz.y) * waveF + time) * waveA;
+    
+    // Blend the base color for the time of day and lighten it slightly on wave crests.
+    vec4 color = dayColor(clamp(dayTime / 24.0, 0.0, 1.0));
+    color.rgb += (y + 0.05) * 0.05;
+    vColor = color;
+    
+    // Eye-space distance drives the fog in the fragment shader.
+    vec4 eyePos = gl_ModelViewMatrix * vec4(xz.x, y, xz.y, 1.0);
+    gl_FogFragCoord = length(eyePos.xyz);
+    
+    // Transform to clip space (the modelview already includes the water level offset).
+    gl_Position = gl_ModelViewProjectionMatrix * vec4(xz.x, y, xz.y, 1.0);
+}
@@ -23,36 +23,39 @@
 #include "CSCIx229.h"      // Custom OpenGL and utility header
 #include "sky_clouds.h"    // Header for cloud system types and prototypes
 #include "landscape.h"     // Needed for LANDSCAPE_SCALE
+#include "rng.h"           // Seeded random streams
 
 // =========================
 // Sets the properties of a single atmospheric cloud instance.
 // Randomizes position, altitude, radius, and opacity for natural variety.
 // =========================
-static void setAtmosphericCloudProperties(AtmosphericCloud* cloud, float baseAltitude) {
+static void setAtmosphericCloudProperties(AtmosphericCloud* cloud, float baseAltitude, Rng* rng) {
     // Each cloud is placed randomly in the XZ plane above the landscape, so the sky looks full and natural.
-    cloud->posX = ((float)rand() / RAND_MAX - 0.5f) * LANDSCAPE_SCALE * 1.7f;
-    cloud->posZ = ((float)rand() / RAND_MAX - 0.5f) * LANDSCAPE_SCALE * 1.7f;
+    cloud->posX = rngRange(rng, -0.5f, 0.5f) * LANDSCAPE_SCALE * 1.7f;
+    cloud->posZ = rngRange(rng, -0.5f, 0.5f) * LANDSCAPE_SCALE * 1.7f;
     // The Y (altitude) is randomized above a base altitude, so clouds form layers at different heights.
-    cloud->posY = baseAltitude + 48.0f + ((float)rand() / RAND_MAX) * 22.0f;
+    cloud->posY = baseAltitude + 48.0f + rngFloat(rng) * 22.0f;
     // Each cloud has a random radius, so some are small and wispy, others are large and puffy.
-    cloud->radius = 24.0f + ((float)rand() / RAND_MAX) * 13.0f;
+    cloud->radius = 24.0f + rngFloat(rng) * 13.0f;
     // Opacity is randomized for depth and to avoid uniform, "cut-out" looking clouds.
-    cloud->opacity = 0.28f + ((float)rand() / RAND_MAX) * 0.23f;
+    cloud->opacity = 0.28f + rngFloat(rng) * 0.23f;
 }
 
 // =========================
 // Creates and initializes an atmospheric cloud system with many clouds.
-// Each cloud is given randomized properties for a natural sky.
+// Each cloud is given randomized properties for a natural sky, drawn from the seed so the same seed gives the same sky.
 // =========================
-AtmosphericCloudSystem* atmosphericCloudSystemCreate(float referenceAltitude) {
+AtmosphericCloudSystem* atmosphericCloudSystemCreate(float referenceAltitude, unsigned int seed) {
     // Allocate memory for the cloud system struct, which holds all clouds.
     AtmosphericCloudSystem* system = (AtmosphericCloudSystem*)malloc(sizeof(AtmosphericCloudSystem));
     if (!system) return NULL; // If allocation fails, return NULL so caller can handle error.
     system->numClouds = 88; // 88 clouds gives a dense, layered sky without overdraw.
     system->baseAltitude = referenceAltitude + 42.0f; // Place clouds well above the terrain.
     // Initialize each cloud with random properties for position, size, and opacity.
+    Rng rng;
+    rngSeed(&rng, seed, 0); // The cloud bank's own random stream.
     for (int idx = 0; idx < system->numClouds; idx++) {
-        setAtmosphericCloudProperties(&system->cloudBank[idx], system->baseAltitude);
+        setAtmosphericCloudProperties(&system->cloudBank[idx], system->baseAltitude, &rng);
     }
     return system;
 }
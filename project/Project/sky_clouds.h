@@ -13,7 +13,7 @@ typedef struct {
     float baseAltitude;
 } AtmosphericCloudSystem;
 
-AtmosphericCloudSystem* atmosphericCloudSystemCreate(float referenceAltitude);
+AtmosphericCloudSystem* atmosphericCloudSystemCreate(float referenceAltitude, unsigned int seed);
 void atmosphericCloudSystemRender(AtmosphericCloudSystem* system);
 void atmosphericCloudSystemDestroy(AtmosphericCloudSystem* system);
 
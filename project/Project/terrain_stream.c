@@ -0,0 +1,397 @@
+/*
+ * terrain_stream.c - Streaming Terrain Tiles Around the Camera
+ *
+ * This file extends the home terrain into an endless landscape. The world is divided into square tiles the size of
+ * the home terrain; tile (0, 0) is the home terrain itself, and every other tile within TERRAIN_STREAM_RADIUS of the
+ * camera's tile is generated on background threads, uploaded to the GPU a little at a time, and evicted again once
+ * it has been out of range for longest. Streamed tiles use a fixed resolution, TERRAIN_STREAM_TILE_SIZE, so their
+ * cost does not grow with the home terrain's.
+ *
+ * Key Concepts:
+ * - Seamless tiles: Tiles continue the home noise from their global grid offset and share border vertices and
+ *   normals with their neighbours (landscapeCreateTile), so no cracks or lighting seams appear between them. Next to
+ *   a finer home terrain the borders only meet at the tile's vertices, like chunks of different LOD levels.
+ * - Near shadows: Only tiles within TERRAIN_STREAM_SHADOW_RADIUS trace horizons; a distant tile is lit without
+ *   them, and has them traced by a worker once the camera comes close.
+ * - Seeded placement: Grass, trees, and boulders of a tile are drawn from a seed hashed from the world seed and the
+ *   tile coordinates, so a tile looks the same every time it is regenerated.
+ * - Worker threads: TERRAIN_STREAM_WORKERS threads take queued tiles nearest-first and build all of their CPU data;
+ *   the render thread never waits for them. Their loops run inline rather than on the shared thread pool, so a tile
+ *   build never holds the pool while the render thread needs it.
+ * - Paced uploads: At most one GPU upload step (a tile's terrain buffers, or its grass) runs per frame, so tiles
+ *   arriving together do not cause a frame-time spike.
+ * - LRU eviction: Built tiles beyond TERRAIN_STREAM_BUDGET are freed least recently wanted first; tiles the camera
+ *   still needs are never evicted. Queued tiles that fall out of range are dropped before they are built.
+ *
+ * Function Roles:
+ * - terrainTileSeed: Hashes the world seed, tile coordinates, and a placement salt into a tile seed.
+ * - buildTile: Generates a tile's terrain, grass, trees, and boulders (worker thread).
+ * - streamWorker: Worker thread loop that builds queued tiles and traces the horizons of tiles that came near, nearest first.
+ * - destroyTile: Frees a tile's CPU data and GPU resources (render thread).
+ * - terrainStreamCreate: Starts the workers for a home terrain.
+ * - terrainStreamUpdate: Queues, uploads, and evicts tiles for the current camera position once per frame.
+ * - terrainStreamRender: Draws the terrain of every uploaded tile.
+ * - terrainStreamRenderObjects: Draws the nearby, visible trees and boulders of the uploaded tiles.
+ * - terrainStreamRenderWater: Draws the water plane over each uploaded tile.
+ * - terrainStreamGetHeight: Terrain height at any world position, from the home terrain or a loaded tile.
+ * - terrainStreamGetStats: Counts of uploaded and pending tiles for the HUD.
+ * - terrainStreamDestroy: Stops the workers and frees every tile.
+ */
+
+#include "CSCIx229.h"
+#include "terrain_stream.h"
+#include "grass.h"
+#include "objects_render.h"
+#include "boulder.h"
+#include "frustum.h"
+#include "threadpool.h"
+#include <pthread.h>
+
+// Most tiles tracked at once: the wanted square plus the budget of out-of-range tiles kept for reuse.
+#define TERRAIN_STREAM_MAX_TILES (TERRAIN_STREAM_BUDGET + (2 * TERRAIN_STREAM_RADIUS + 1) * (2 * TERRAIN_STREAM_RADIUS + 1))
+
+// TerrainTileState: Life cycle of a tile. Workers move tiles from QUEUED to BUILT and from SHADE_QUEUED back to BUILT;
+// the render thread does the rest.
+typedef enum {
+    TILE_QUEUED,       // Waiting for a worker
+    TILE_BUILDING,     // Being generated by a worker
+    TILE_BUILT,        // CPU data ready; uploaded step by step on the render thread
+    TILE_SHADE_QUEUED, // Built without horizons and now near the camera; waiting for a worker to trace them
+    TILE_SHADING       // Horizons being traced by a worker; the tile is still drawn meanwhile
+} TerrainTileState;
+
+// TerrainTile: One streamed tile and everything placed on it.
+typedef struct {
+    int tileX, tileZ;             // Tile coordinates; tile (0, 0) is the home terrain
+    TerrainTileState state;       // Guarded by the stream lock
+    int distance;                 // Squared tile distance from the camera's tile (build priority)
+    int ring;                     // Tiles between this tile and the camera's tile along the farther axis
+    unsigned int lastWanted;      // Last frame the tile was within range
+    int uploaded;                 // Upload steps done: 0 none, 1 terrain, 2 terrain and grass (render thread only)
+    Landscape* land;              // Tile terrain (NULL if generation failed)
+    unsigned char* horizons;      // Horizons traced after the tile was built, until they are attached
+    float minY, maxY;             // Height range of the terrain, for culling
+    void* grass;                  // Packed grass blades until they are uploaded
+    size_t grassBytes;
+    GrassPatch* grassPatch;       // Uploaded grass
+    TreeInstance* trees;          // Trees placed on the tile
+    int treeCount;
+    BoulderInstance* boulders;    // Boulders placed on the tile
+    int boulderCount;
+} TerrainTile;
+
+struct TerrainStream {
+    Landscape* home;              // Home terrain (tile 0, 0), owned by the caller
+    int tileSize;                 // Grid vertices per side of the streamed tiles
+    unsigned int seed;            // World seed
+    TerrainTile* tiles[TERRAIN_STREAM_MAX_TILES]; // Tracked tiles, unordered; only the render thread adds or removes
+    int tileCount;
+    unsigned int frame;           // Incremented by every terrainStreamUpdate
+    pthread_t workers[TERRAIN_STREAM_WORKERS];
+    int workerCount;
+    int stopping;                 // Set when the workers should exit
+    pthread_mutex_t lock;         // Guards tile states and the stopping flag
+    pthread_cond_t wake;          // Signalled when tiles are queued or the stream stops
+};
+
+// terrainTileSeed: Hashes the world seed, the tile coordinates, and a placement salt into a well-mixed seed.
+// Uses the murmur3 finalizer so neighbouring tiles get unrelated random sequences.
+unsigned int terrainTileSeed(unsigned int worldSeed, int tileX, int tileZ, unsigned int salt) {
+    unsigned int h = worldSeed ^ ((unsigned int)tileX * 0x8DA6B343u) ^ ((unsigned int)tileZ * 0xD8163841u) ^ (salt * 0xCB1AB31Fu);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// buildTile: Generates a tile's terrain and places its grass, trees, and boulders.
+// Horizons are traced only if the tile is near the camera. Runs on a worker thread; touches only the tile, which no
+// other thread reads while it is being built.
+static void buildTile(const TerrainStream* stream, TerrainTile* tile, int horizons) {
+    const Landscape* home = stream->home;
+    Landscape* land = landscapeCreateTile(stream->tileSize, home->scale, home->height, tile->tileX, tile->tileZ, horizons);
+    tile->land = land;
+    if (!land) return;
+    tile->minY = tile->maxY = land->elevationData[0];
+    for (int i = 1; i < land->vertexCount; i++) { // Height range for culling.
+        float h = land->elevationData[i];
+        if (h < tile->minY) tile->minY = h;
+        if (h > tile->maxY) tile->maxY = h;
+    }
+    tile->grass = grassSystemGenerate(land, land->scale, TERRAIN_STREAM_GRASS_BLADES,
+                                      terrainTileSeed(stream->seed, tile->tileX, tile->tileZ, TERRAIN_SEED_GRASS), &tile->grassBytes);
+    tile->trees = generateTreeInstances(land, terrainTileSeed(stream->seed, tile->tileX, tile->tileZ, TERRAIN_SEED_TREES), &tile->treeCount);
+    tile->boulders = generateBoulders(land, tile->trees, tile->treeCount,
+                                      terrainTileSeed(stream->seed, tile->tileX, tile->tileZ, TERRAIN_SEED_BOULDERS), &tile->boulderCount);
+}
+
+// streamWorker: Worker thread loop. Sleeps until a tile is queued, then builds (or traces the horizons of) the one
+// nearest the camera.
+static void* streamWorker(void* arg) {
+    TerrainStream* stream = (TerrainStream*)arg;
+    threadPoolSetInline(1); // Keep the shared pool free for the render thread.
+    pthread_mutex_lock(&stream->lock);
+    for (;;) {
+        TerrainTile* next = NULL;
+        for (int i = 0; i < stream->tileCount; i++) { // Nearest queued tile first.
+            TerrainTile* t = stream->tiles[i];
+            if ((t->state == TILE_QUEUED || t->state == TILE_SHADE_QUEUED) && (!next || t->distance < next->distance)) next = t;
+        }
+        if (stream->stopping) break;
+        if (!next) {
+            pthread_cond_wait(&stream->wake, &stream->lock);
+            continue;
+        }
+        if (next->state == TILE_QUEUED) {
+            int horizons = next->ring <= TERRAIN_STREAM_SHADOW_RADIUS;
+            next->state = TILE_BUILDING; // The render thread neither drops nor evicts a tile in this state.
+            pthread_mutex_unlock(&stream->lock);
+            buildTile(stream, next, horizons);
+        } else {
+            next->state = TILE_SHADING; // Nor in this one; it only reads the terrain, as this worker does.
+            pthread_mutex_unlock(&stream->lock);
+            next->horizons = landscapeTraceHorizons(next->land);
+        }
+        pthread_mutex_lock(&stream->lock);
+        next->state = TILE_BUILT;
+    }
+    pthread_mutex_unlock(&stream->lock);
+    return NULL;
+}
+
+// destroyTile: Frees a tile's placement data, grass patch, and terrain. Must run on the render thread.
+static void destroyTile(TerrainTile* tile) {
+    grassPatchDestroy(tile->grassPatch);
+    free(tile->grass);
+    free(tile->trees);
+    free(tile->boulders);
+    free(tile->horizons);
+    if (tile->land) landscapeDestroy(tile->land);
+    free(tile);
+}
+
+// terrainStreamCreate: Creates a tile stream around the home terrain and starts its worker threads.
+// Tiles match the home terrain's size and height scale, at TERRAIN_STREAM_TILE_SIZE (or the home resolution if that
+// is coarser). Returns NULL on failure.
+TerrainStream* terrainStreamCreate(Landscape* home, unsigned int worldSeed) {
+    if (!home) return NULL;
+    TerrainStream* stream = (TerrainStream*)calloc(1, sizeof(TerrainStream));
+    if (!stream) return NULL;
+    stream->home = home;
+    stream->tileSize = home->size < TERRAIN_STREAM_TILE_SIZE ? home->size : TERRAIN_STREAM_TILE_SIZE;
+    stream->seed = worldSeed;
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->wake, NULL);
+    for (int i = 0; i < TERRAIN_STREAM_WORKERS; i++) {
+        if (pthread_create(&stream->workers[stream->workerCount], NULL, streamWorker, stream) == 0) stream->workerCount++;
+    }
+    if (!stream->workerCount) { // Without workers no tile would ever be built.
+        terrainStreamDestroy(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+// findTile: Returns the tracked tile at (tileX, tileZ), or NULL.
+static TerrainTile* findTile(const TerrainStream* stream, int tileX, int tileZ) {
+    for (int i = 0; i < stream->tileCount; i++) {
+        if (stream->tiles[i]->tileX == tileX && stream->tiles[i]->tileZ == tileZ) return stream->tiles[i];
+    }
+    return NULL;
+}
+
+// removeTile: Drops entry i from the tile list (order does not matter).
+static void removeTile(TerrainStream* stream, int i) {
+    stream->tiles[i] = stream->tiles[--stream->tileCount];
+}
+
+// terrainStreamUpdate: Brings the tile set up to date for the camera at (cameraX, cameraZ). Call once per frame.
+// Missing tiles in range are queued nearest-first, tiles without horizons that come within TERRAIN_STREAM_SHADOW_RADIUS are
+// queued for tracing, queued tiles that left the range are dropped, one upload step is done for the nearest built
+// tile, and built tiles beyond the budget are evicted least recently wanted first.
+void terrainStreamUpdate(TerrainStream* stream, float cameraX, float cameraZ) {
+    if (!stream) return;
+    Landscape* home = stream->home;
+    unsigned int frame = ++stream->frame;
+    int camX = (int)floorf((cameraX - home->origin[0]) / home->scale);
+    int camZ = (int)floorf((cameraZ - home->origin[1]) / home->scale);
+    TerrainTile* upload = NULL;
+    int queued = 0;
+    pthread_mutex_lock(&stream->lock);
+    // Mark the wanted tiles, queueing the ones not tracked yet.
+    for (int dz = -TERRAIN_STREAM_RADIUS; dz <= TERRAIN_STREAM_RADIUS; dz++) {
+        for (int dx = -TERRAIN_STREAM_RADIUS; dx <= TERRAIN_STREAM_RADIUS; dx++) {
+            int tx = camX + dx, tz = camZ + dz;
+            if (tx == 0 && tz == 0) continue; // The home terrain is always present.
+            TerrainTile* tile = findTile(stream, tx, tz);
+            if (!tile) {
+                if (stream->tileCount >= TERRAIN_STREAM_MAX_TILES) continue; // Picked up once eviction frees a slot.
+                tile = (TerrainTile*)calloc(1, sizeof(TerrainTile));
+                if (!tile) continue;
+                tile->tileX = tx;
+                tile->tileZ = tz;
+                tile->state = TILE_QUEUED;
+                stream->tiles[stream->tileCount++] = tile;
+                queued = 1;
+            }
+            tile->distance = dx * dx + dz * dz;
+            tile->ring = abs(dx) > abs(dz) ? abs(dx) : abs(dz);
+            tile->lastWanted = frame;
+            if (tile->state == TILE_BUILT && tile->ring <= TERRAIN_STREAM_SHADOW_RADIUS && tile->uploaded >= 2 &&
+                tile->land && !tile->land->horizons && !tile->horizons) {
+                tile->state = TILE_SHADE_QUEUED; // Came close without shadows: trace its horizons.
+                queued = 1;
+            }
+        }
+    }
+    // Drop queued tiles the camera has moved away from, and pick the nearest built tile with an upload step left.
+    int built = 0;
+    for (int i = 0; i < stream->tileCount; i++) {
+        TerrainTile* tile = stream->tiles[i];
+        if (tile->state == TILE_QUEUED && tile->lastWanted != frame) {
+            free(tile);
+            removeTile(stream, i--);
+            continue;
+        }
+        if (tile->state == TILE_SHADE_QUEUED && tile->lastWanted != frame) tile->state = TILE_BUILT; // Left before tracing.
+        if (tile->state == TILE_QUEUED || tile->state == TILE_BUILDING) continue;
+        built++;
+        if (tile->state != TILE_BUILT) continue;
+        if ((tile->uploaded < 2 || tile->horizons) && tile->lastWanted == frame && (!upload || tile->distance < upload->distance)) upload = tile;
+    }
+    // Evict the least recently wanted built tiles beyond the budget; tiles still in range are kept.
+    while (built > TERRAIN_STREAM_BUDGET) {
+        int victim = -1;
+        for (int i = 0; i < stream->tileCount; i++) {
+            TerrainTile* tile = stream->tiles[i];
+            if (tile->state != TILE_BUILT || tile->lastWanted == frame) continue;
+            if (victim < 0 || tile->lastWanted < stream->tiles[victim]->lastWanted) victim = i;
+        }
+        if (victim < 0) break;
+        destroyTile(stream->tiles[victim]);
+        removeTile(stream, victim);
+        built--;
+    }
+    if (queued) pthread_cond_broadcast(&stream->wake);
+    pthread_mutex_unlock(&stream->lock);
+    // Upload outside the lock: workers only touch a built tile again once it is queued for tracing.
+    if (upload) {
+        if (upload->uploaded == 0) {
+            landscapeUpload(upload->land); // Terrain buffers this frame...
+            upload->uploaded++;
+        } else if (upload->uploaded == 1) {
+            upload->grassPatch = grassPatchCreate(upload->grass, upload->grassBytes); // ...grass on the next...
+            free(upload->grass);
+            upload->grass = NULL;
+            upload->uploaded++;
+        } else {
+            landscapeSetHorizons(upload->land, upload->horizons); // ...and horizons traced later, once they arrive.
+            upload->horizons = NULL;
+        }
+    }
+}
+
+// tileVisible: Whether an uploaded tile's terrain box intersects the view frustum.
+static int tileVisible(const TerrainTile* tile, const ViewFrustum* frustum) {
+    const Landscape* land = tile->land;
+    float boxMin[3] = {land->origin[0], tile->minY, land->origin[1]};
+    float boxMax[3] = {land->origin[0] + land->scale, tile->maxY, land->origin[1] + land->scale};
+    return viewFrustumTestBox(frustum, boxMin, boxMax);
+}
+
+// terrainStreamRender: Draws the terrain of every uploaded tile with the home terrain's LOD, strip, and shadow settings.
+void terrainStreamRender(TerrainStream* stream, int weatherType) {
+    if (!stream) return;
+    for (int i = 0; i < stream->tileCount; i++) {
+        TerrainTile* tile = stream->tiles[i];
+        if (tile->uploaded < 1 || !tile->land) continue;
+        tile->land->lodEnabled = stream->home->lodEnabled;
+        tile->land->stripsEnabled = stream->home->stripsEnabled;
+        tile->land->shadowsEnabled = stream->home->shadowsEnabled;
+        landscapeRender(tile->land, weatherType);
+    }
+}
+
+// terrainStreamRenderObjects: Draws the trees and boulders of the uploaded tiles that are near the camera and in view.
+// Objects are drawn one by one in immediate mode, so only those within TERRAIN_STREAM_OBJECT_DISTANCE are considered.
+void terrainStreamRenderObjects(TerrainStream* stream) {
+    if (!stream) return;
+    ViewFrustum frustum;
+    viewFrustumExtract(&frustum);
+    float maxDist2 = TERRAIN_STREAM_OBJECT_DISTANCE * TERRAIN_STREAM_OBJECT_DISTANCE;
+    for (int i = 0; i < stream->tileCount; i++) {
+        const TerrainTile* tile = stream->tiles[i];
+        if (tile->uploaded < 1 || !tile->land) continue;
+        const Landscape* land = tile->land;
+        // Skip whole tiles that are too far away or out of view.
+        float dx = frustum.eye[0] - fmaxf(land->origin[0], fminf(frustum.eye[0], land->origin[0] + land->scale));
+        float dz = frustum.eye[2] - fmaxf(land->origin[1], fminf(frustum.eye[2], land->origin[1] + land->scale));
+        if (dx * dx + dz * dz > maxDist2 || !tileVisible(tile, &frustum)) continue;
+        for (int t = 0; t < tile->treeCount; t++) {
+            const TreeInstance* tree = &tile->trees[t];
+            float ex = tree->x - frustum.eye[0], ez = tree->z - frustum.eye[2], r = tree->scale * 3.0f;
+            float boxMin[3] = {tree->x - r, tree->y, tree->z - r}, boxMax[3] = {tree->x + r, tree->y + 2.0f * r, tree->z + r};
+            if (ex * ex + ez * ez < maxDist2 && viewFrustumTestBox(&frustum, boxMin, boxMax)) renderTreeInstances(tree, 1);
+        }
+        for (int b = 0; b < tile->boulderCount; b++) {
+            const BoulderInstance* rock = &tile->boulders[b];
+            float ex = rock->x - frustum.eye[0], ez = rock->z - frustum.eye[2], r = rock->scale * 1.5f;
+            float boxMin[3] = {rock->x - r, rock->y - r, rock->z - r}, boxMax[3] = {rock->x + r, rock->y + r, rock->z + r};
+            if (ex * ex + ez * ez < maxDist2 && viewFrustumTestBox(&frustum, boxMin, boxMax)) renderBoulderInstances(rock, 1);
+        }
+    }
+}
+
+// terrainStreamRenderWater: Draws the water plane over each uploaded tile in view.
+void terrainStreamRenderWater(TerrainStream* stream, float waterLevel, float dayTime, float time) {
+    if (!stream) return;
+    ViewFrustum frustum;
+    viewFrustumExtract(&frustum);
+    for (int i = 0; i < stream->tileCount; i++) {
+        const TerrainTile* tile = stream->tiles[i];
+        if (tile->uploaded < 1 || !tile->land) continue;
+        const Landscape* land = tile->land;
+        float boxMin[3] = {land->origin[0], waterLevel - 1.0f, land->origin[1]};
+        float boxMax[3] = {land->origin[0] + land->scale, waterLevel + 1.0f, land->origin[1] + land->scale};
+        if (viewFrustumTestBox(&frustum, boxMin, boxMax)) landscapeRenderWater(waterLevel, tile->land, dayTime, time);
+    }
+}
+
+// terrainStreamGetHeight: Returns the terrain height at world (x, z), from the home terrain or the loaded tile there.
+// Where no tile is loaded yet, the nearest point of the home terrain stands in until it arrives.
+float terrainStreamGetHeight(TerrainStream* stream, float x, float z) {
+    Landscape* home = stream->home;
+    int tx = (int)floorf((x - home->origin[0]) / home->scale);
+    int tz = (int)floorf((z - home->origin[1]) / home->scale);
+    if (tx != 0 || tz != 0) {
+        TerrainTile* tile = findTile(stream, tx, tz);
+        if (tile && tile->uploaded >= 1 && tile->land) return landscapeGetHeight(tile->land, x, z);
+    }
+    return landscapeGetHeight(home, x, z);
+}
+
+// terrainStreamGetStats: Reports how many tiles are drawn and how many are still being generated or uploaded.
+void terrainStreamGetStats(TerrainStream* stream, int* resident, int* pending) {
+    *resident = *pending = 0;
+    if (!stream) return;
+    for (int i = 0; i < stream->tileCount; i++) {
+        if (stream->tiles[i]->uploaded >= 1) (*resident)++;
+        else (*pending)++;
+    }
+}
+
+// terrainStreamDestroy: Stops the workers (letting any tile in progress finish) and frees every tile.
+void terrainStreamDestroy(TerrainStream* stream) {
+    if (!stream) return;
+    pthread_mutex_lock(&stream->lock);
+    stream->stopping = 1;
+    pthread_cond_broadcast(&stream->wake);
+    pthread_mutex_unlock(&stream->lock);
+    for (int i = 0; i < stream->workerCount; i++) pthread_join(stream->workers[i], NULL);
+    for (int i = 0; i < stream->tileCount; i++) destroyTile(stream->tiles[i]);
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->wake);
+    free(stream);
+}
@@ -0,0 +1,34 @@
+#ifndef TERRAIN_STREAM_H
+#define TERRAIN_STREAM_H
+
+#include "landscape.h"
+
+#define TERRAIN_STREAM_RADIUS 2             // Tiles kept loaded around the camera's tile in each direction
+#define TERRAIN_STREAM_BUDGET 32            // Most built tiles kept in memory; least recently used ones are evicted beyond it
+#define TERRAIN_STREAM_WORKERS 2            // Background threads generating tiles
+#define TERRAIN_STREAM_TILE_SIZE LANDSCAPE_SIZE // Grid vertices per tile side (less if the home terrain is coarser)
+#define TERRAIN_STREAM_SHADOW_RADIUS 1      // Tiles within this many tiles of the camera's tile get horizon shadows
+#define TERRAIN_STREAM_GRASS_BLADES 40000   // Grass blades placed per tile
+#define TERRAIN_STREAM_OBJECT_DISTANCE 150.0f // Trees and boulders of tiles are drawn up to this distance from the camera
+
+// Salts mixed into the world seed so each kind of placement on a tile gets its own random sequence.
+// Clouds and weather are seeded once, from tile (0, 0).
+#define TERRAIN_SEED_GRASS 1
+#define TERRAIN_SEED_TREES 2
+#define TERRAIN_SEED_BOULDERS 3
+#define TERRAIN_SEED_CLOUDS 4
+#define TERRAIN_SEED_WEATHER 5
+
+typedef struct TerrainStream TerrainStream;
+
+unsigned int terrainTileSeed(unsigned int worldSeed, int tileX, int tileZ, unsigned int salt);
+TerrainStream* terrainStreamCreate(Landscape* home, unsigned int worldSeed);
+void terrainStreamUpdate(TerrainStream* stream, float cameraX, float cameraZ);
+void terrainStreamRender(TerrainStream* stream, int weatherType);
+void terrainStreamRenderObjects(TerrainStream* stream);
+void terrainStreamRenderWater(TerrainStream* stream, float waterLevel, float dayTime, float time);
+float terrainStreamGetHeight(TerrainStream* stream, float x, float z);
+void terrainStreamGetStats(TerrainStream* stream, int* resident, int* pending);
+void terrainStreamDestroy(TerrainStream* stream);
+
+#endif
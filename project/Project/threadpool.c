@@ -0,0 +1,197 @@
+/*
+ * threadpool.c - Shared Worker Thread Pool for Data-Parallel Scene Generation
+ *
+ * This file implements a small, persistent pool of worker threads used to split large, independent loops
+ * (such as heightfield rows) across all CPU cores. The calling thread always participates in the work,
+ * so a pool of N threads keeps N cores busy with N-1 background workers.
+ *
+ * Key Concepts:
+ * - Persistent workers: Threads are created once and sleep on a condition variable between jobs, so dispatch is cheap.
+ * - Range splitting: A job is a range [0, count) cut into fixed-size chunks ("grain") that threads claim one at a time.
+ * - Determinism: Each index is processed exactly once, so any loop whose iterations are independent produces identical output
+ *   no matter how many threads run it.
+ * - Graceful fallback: With a single core, or when called from inside a running job, the loop simply runs inline.
+ * - Background threads: Threads with their own long-running work (such as terrain streaming) can opt out of the pool,
+ *   so their loops run inline instead of occupying the workers and serializing the render thread's loops.
+ *
+ * Function Roles:
+ * - threadPoolInit: Starts the worker threads (0 = one per CPU core).
+ * - threadPoolSize: Reports how many threads (including the caller) take part in a parallel loop.
+ * - threadPoolSetInline: Makes the calling thread run its parallel loops inline.
+ * - threadPoolParallelFor: Runs a range function over [0, count) across the pool and waits for completion.
+ * - threadPoolShutdown: Stops and joins all worker threads.
+ */
+
+#include "CSCIx229.h"
+#include "threadpool.h"
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define THREADPOOL_MAX_THREADS 64
+
+// Worker threads and synchronization primitives
+static pthread_t workers[THREADPOOL_MAX_THREADS]; // Background worker threads
+static int workerCount = 0;                       // Number of background workers (pool size minus the caller)
+static int poolStarted = 0;                       // Whether threadPoolInit has run
+static int shuttingDown = 0;                      // Set when workers should exit
+static pthread_mutex_t poolLock = PTHREAD_MUTEX_INITIALIZER; // Guards all job state below
+static pthread_cond_t workReady = PTHREAD_COND_INITIALIZER;  // Signalled when a new job is posted
+static pthread_cond_t workDone = PTHREAD_COND_INITIALIZER;   // Signalled when the last chunk of a job finishes
+
+// State of the job currently being executed
+static ThreadPoolRangeFn jobFn = NULL; // Range function to run
+static void* jobData = NULL;           // User pointer passed to the range function
+static int jobCount = 0;               // Total number of indices in the job
+static int jobGrain = 1;               // Number of indices claimed at a time
+static int jobNext = 0;                // Next unclaimed index
+static int jobRemaining = 0;           // Indices not yet finished
+static unsigned int jobGeneration = 0; // Incremented for every posted job so sleeping workers notice it
+static int jobActive = 0;              // Whether a job is currently running (used to run nested loops inline)
+
+// Threads that opted out of the pool with threadPoolSetInline
+static pthread_key_t inlineKey;                        // Non-NULL value on threads that run their loops inline
+static pthread_once_t inlineKeyOnce = PTHREAD_ONCE_INIT;
+
+// detectCoreCount: Returns the number of online CPU cores.
+// Used when the pool is initialized with 0 threads so it sizes itself to the machine.
+static int detectCoreCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info); // Query the processor count from Windows.
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN); // Query the online processor count from POSIX.
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+// runJobChunks: Claims and executes chunks of the current job until none are left.
+// Called by both the workers and the thread that posted the job.
+static void runJobChunks(void) {
+    for (;;) {
+        pthread_mutex_lock(&poolLock);
+        if (jobNext >= jobCount) { // Nothing left to claim.
+            pthread_mutex_unlock(&poolLock);
+            return;
+        }
+        int begin = jobNext; // Claim the next chunk.
+        int end = begin + jobGrain;
+        if (end > jobCount) end = jobCount;
+        jobNext = end;
+        ThreadPoolRangeFn fn = jobFn;
+        void* data = jobData;
+        pthread_mutex_unlock(&poolLock);
+        fn(begin, end, data); // Run the chunk outside the lock.
+        pthread_mutex_lock(&poolLock);
+        jobRemaining -= end - begin; // Mark the chunk as finished.
+        if (jobRemaining == 0) pthread_cond_broadcast(&workDone); // Wake the poster once everything is done.
+        pthread_mutex_unlock(&poolLock);
+    }
+}
+
+// workerMain: Entry point of every background worker thread.
+// Sleeps until a new job generation is posted, helps run it, and goes back to sleep.
+static void* workerMain(void* arg) {
+    unsigned int seenGeneration = 0; // Last job generation this worker has joined.
+    (void)arg;
+    pthread_mutex_lock(&poolLock);
+    for (;;) {
+        while (!shuttingDown && seenGeneration == jobGeneration) {
+            pthread_cond_wait(&workReady, &poolLock); // Sleep until there is new work.
+        }
+        if (shuttingDown) break;
+        seenGeneration = jobGeneration;
+        pthread_mutex_unlock(&poolLock);
+        runJobChunks(); // Help with the posted job.
+        pthread_mutex_lock(&poolLock);
+    }
+    pthread_mutex_unlock(&poolLock);
+    return NULL;
+}
+
+// threadPoolInit: Starts the worker threads.
+// numThreads is the total thread count including the caller; 0 picks one thread per CPU core.
+void threadPoolInit(int numThreads) {
+    if (poolStarted) return; // Already running.
+    if (numThreads <= 0) numThreads = detectCoreCount();
+    if (numThreads > THREADPOOL_MAX_THREADS) numThreads = THREADPOOL_MAX_THREADS;
+    shuttingDown = 0;
+    workerCount = 0;
+    for (int i = 0; i < numThreads - 1; i++) { // The caller is the last member of the pool.
+        if (pthread_create(&workers[workerCount], NULL, workerMain, NULL) != 0) break;
+        workerCount++;
+    }
+    poolStarted = 1;
+}
+
+// threadPoolSize: Returns the number of threads that take part in a parallel loop, including the caller.
+int threadPoolSize(void) {
+    if (!poolStarted) threadPoolInit(0);
+    return workerCount + 1;
+}
+
+// createInlineKey: Creates the thread-specific key behind threadPoolSetInline (run once).
+static void createInlineKey(void) {
+    pthread_key_create(&inlineKey, NULL);
+}
+
+// threadPoolSetInline: Makes parallel loops started by the calling thread run inline on it (enabled != 0) or use the
+// pool again (enabled == 0). Meant for background threads, so their loops never keep the pool busy while the render
+// thread needs it.
+void threadPoolSetInline(int enabled) {
+    pthread_once(&inlineKeyOnce, createInlineKey);
+    pthread_setspecific(inlineKey, enabled ? (void*)&inlineKey : NULL);
+}
+
+// threadPoolParallelFor: Runs fn over [0, count) in chunks of 'grain' indices across the pool.
+// Blocks until every chunk has finished. Iterations must be independent of each other.
+void threadPoolParallelFor(int count, int grain, ThreadPoolRangeFn fn, void* userData) {
+    if (count <= 0 || !fn) return;
+    if (grain < 1) grain = 1;
+    pthread_once(&inlineKeyOnce, createInlineKey);
+    if (pthread_getspecific(inlineKey)) { // The calling thread opted out of the pool.
+        fn(0, count, userData);
+        return;
+    }
+    if (!poolStarted) threadPoolInit(0); // Lazily size the pool to the machine.
+    pthread_mutex_lock(&poolLock);
+    if (workerCount == 0 || jobActive || count <= grain) { // Single core, nested call, or a single chunk: run inline.
+        pthread_mutex_unlock(&poolLock);
+        fn(0, count, userData);
+        return;
+    }
+    // Post the job and wake the workers.
+    jobFn = fn;
+    jobData = userData;
+    jobCount = count;
+    jobGrain = grain;
+    jobNext = 0;
+    jobRemaining = count;
+    jobActive = 1;
+    jobGeneration++;
+    pthread_cond_broadcast(&workReady);
+    pthread_mutex_unlock(&poolLock);
+    runJobChunks(); // The caller works too.
+    pthread_mutex_lock(&poolLock);
+    while (jobRemaining > 0) pthread_cond_wait(&workDone, &poolLock); // Wait for chunks still running on workers.
+    jobActive = 0;
+    jobFn = NULL;
+    jobData = NULL;
+    pthread_mutex_unlock(&poolLock);
+}
+
+// threadPoolShutdown: Stops and joins all worker threads.
+void threadPoolShutdown(void) {
+    if (!poolStarted) return;
+    pthread_mutex_lock(&poolLock);
+    shuttingDown = 1;
+    pthread_cond_broadcast(&workReady); // Wake everyone so they see the shutdown flag.
+    pthread_mutex_unlock(&poolLock);
+    for (int i = 0; i < workerCount; i++) pthread_join(workers[i], NULL);
+    workerCount = 0;
+    poolStarted = 0;
+}
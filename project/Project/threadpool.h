@@ -0,0 +1,12 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+typedef void (*ThreadPoolRangeFn)(int begin, int end, void* userData);
+
+void threadPoolInit(int numThreads);
+int threadPoolSize(void);
+void threadPoolSetInline(int enabled);
+void threadPoolParallelFor(int count, int grain, ThreadPoolRangeFn fn, void* userData);
+void threadPoolShutdown(void);
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * world_cache.c - Binary Cache of the Generated World
+ *
+ * This file stores everything the scene generates at startup (heightmap, normals, grass blades,
+ * trees, and boulders) in one binary file, so later launches with the same seed and parameters can skip generation.
+ * The file is memory-mapped on load; callers upload GPU data straight from the mapping and copy only what they
+ * need to modify.
+ *
+ * File Layout:
+ * - Header: magic, byte-order marker, format version, section count, and the WorldCacheKey it was generated with.
+ * - Section table: (offset, size) pairs, one per WorldCacheSection.
+ * - Section data: each section starts on a 64-byte boundary so mapped arrays are well aligned.
+ *
+ * Function Roles:
+ * - worldCacheOpen: Maps a cache file and validates it against the current key and format version.
+ * - worldCacheSection: Returns a pointer to one section inside the mapping.
+ * - worldCacheClose: Unmaps (or frees) the cache file.
+ * - worldCacheWrite: Writes a new cache file atomically (temporary file + rename).
+ */
+
+#include "CSCIx229.h"
+#include "world_cache.h"
+#include <stdint.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define WORLD_CACHE_MAGIC "BWCACHE"
+#define WORLD_CACHE_BYTE_ORDER 0x01020304u
+#define WORLD_CACHE_ALIGN 64
+
+// WorldCacheHeader: Fixed-size header at the start of every cache file.
+typedef struct {
+    char magic[8];           // WORLD_CACHE_MAGIC, NUL-terminated
+    uint32_t byteOrder;      // WORLD_CACHE_BYTE_ORDER as written by the producing machine
+    uint32_t version;        // WORLD_CACHE_VERSION
+    uint32_t sectionCount;   // WORLD_CACHE_SECTION_COUNT
+    uint32_t reserved;       // Keeps the key and table 8-byte aligned
+    WorldCacheKey key;       // Parameters the world was generated with
+    uint32_t padding[2];     // Pads the key to a multiple of 8 bytes
+    uint64_t table[WORLD_CACHE_SECTION_COUNT][2]; // (offset, size) of each section
+} WorldCacheHeader;
+
+// alignUp: Rounds an offset up to the section alignment.
+static size_t alignUp(size_t offset) {
+    return (offset + WORLD_CACHE_ALIGN - 1) & ~(size_t)(WORLD_CACHE_ALIGN - 1);
+}
+
+// loadFile: Maps (or, without mmap, reads) the whole file into cache->data.
+static int loadFile(WorldCache* cache, const char* path) {
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return 0;
+    }
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after the descriptor is closed.
+    if (data == MAP_FAILED) return 0;
+    cache->data = data;
+    cache->dataSize = (size_t)st.st_size;
+    cache->mapped = 1;
+    return 1;
+#else
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void* data = size > 0 ? malloc((size_t)size) : NULL;
+    if (!data || fread(data, 1, (size_t)size, f) != (size_t)size) {
+        free(data);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    cache->data = data;
+    cache->dataSize = (size_t)size;
+    cache->mapped = 0;
+    return 1;
+#endif
+}
+
+// worldCacheOpen: Opens a cache file and checks that it was produced by this format version with the same key.
+// Returns 1 when every section is present and in bounds; otherwise returns 0 and leaves nothing open.
+int worldCacheOpen(WorldCache* cache, const char* path, const WorldCacheKey* key) {
+    memset(cache, 0, sizeof(*cache));
+    if (!loadFile(cache, path)) return 0;
+    const WorldCacheHeader* h = (const WorldCacheHeader*)cache->data;
+    int valid = cache->dataSize >= sizeof(WorldCacheHeader)
+        && memcmp(h->magic, WORLD_CACHE_MAGIC, sizeof(WORLD_CACHE_MAGIC)) == 0
+        && h->byteOrder == WORLD_CACHE_BYTE_ORDER
+        && h->version == WORLD_CACHE_VERSION
+        && h->sectionCount == WORLD_CACHE_SECTION_COUNT
+        && memcmp(&h->key, key, sizeof(WorldCacheKey)) == 0;
+    for (int i = 0; valid && i < WORLD_CACHE_SECTION_COUNT; i++) {
+        uint64_t offset = h->table[i][0], size = h->table[i][1];
+        if (offset > cache->dataSize || size > cache->dataSize - offset) valid = 0; // Truncated or corrupt file.
+        cache->offsets[i] = (size_t)offset;
+        cache->sizes[i] = (size_t)size;
+    }
+    if (!valid) worldCacheClose(cache);
+    return valid;
+}
+
+// worldCacheSection: Returns a read-only pointer to a section and stores its size in *bytes.
+const void* worldCacheSection(const WorldCache* cache, WorldCacheSection section, size_t* bytes) {
+    if (bytes) *bytes = cache->sizes[section];
+    return (const char*)cache->data + cache->offsets[section];
+}
+
+// worldCacheClose: Releases the mapping or buffer behind an open cache.
+void worldCacheClose(WorldCache* cache) {
+    if (!cache->data) return;
+#ifndef _WIN32
+    if (cache->mapped) munmap(cache->data, cache->dataSize);
+    else free(cache->data);
+#else
+    free(cache->data);
+#endif
+    cache->data = NULL;
+    cache->dataSize = 0;
+}
+
+// worldCacheWrite: Writes all sections to a new cache file for the given key.
+// The file is written under a temporary name and renamed into place, so a crash never leaves a half-written cache.
+int worldCacheWrite(const char* path, const WorldCacheKey* key, const void* const sections[WORLD_CACHE_SECTION_COUNT], const size_t sizes[WORLD_CACHE_SECTION_COUNT]) {
+    WorldCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, WORLD_CACHE_MAGIC, sizeof(WORLD_CACHE_MAGIC));
+    h.byteOrder = WORLD_CACHE_BYTE_ORDER;
+    h.version = WORLD_CACHE_VERSION;
+    h.sectionCount = WORLD_CACHE_SECTION_COUNT;
+    h.key = *key;
+    size_t offset = alignUp(sizeof(h));
+    for (int i = 0; i < WORLD_CACHE_SECTION_COUNT; i++) { // Lay the sections out back to back, each aligned.
+        h.table[i][0] = offset;
+        h.table[i][1] = sizes[i];
+        offset = alignUp(offset + sizes[i]);
+    }
+    char tmpPath[1024];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    FILE* f = fopen(tmpPath, "wb");
+    if (!f) return 0;
+    static const char zeros[WORLD_CACHE_ALIGN] = {0};
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    size_t pos = sizeof(h);
+    for (int i = 0; ok && i < WORLD_CACHE_SECTION_COUNT; i++) {
+        size_t pad = (size_t)h.table[i][0] - pos; // Zero padding up to the section's aligned offset.
+        if (pad && fwrite(zeros, 1, pad, f) != pad) ok = 0;
+        if (ok && sizes[i] && fwrite(sections[i], 1, sizes[i], f) != sizes[i]) ok = 0;
+        pos = (size_t)h.table[i][0] + sizes[i];
+    }
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) {
+        remove(tmpPath);
+        return 0;
+    }
+    remove(path); // rename() does not replace an existing file on Windows.
+    return rename(tmpPath, path) == 0;
+}
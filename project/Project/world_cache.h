@@ -0,0 +1,37 @@
+#pragma once
+#include <stddef.h>
+
+// Bump whenever terrain generation, placement, or any cached struct layout changes.
+#define WORLD_CACHE_VERSION 13
+#define WORLD_CACHE_FILE "world.cache"
+
+typedef enum {
+    WORLD_CACHE_ELEVATION,  // float[size * size] heightmap
+    WORLD_CACHE_NORMALS,    // float[size * size * 3] vertex normals
+    WORLD_CACHE_GRASS,      // Grass instance buffer, exactly as uploaded to the GPU
+    WORLD_CACHE_TREES,      // TreeInstance[]
+    WORLD_CACHE_BOULDERS,   // BoulderInstance[]
+    WORLD_CACHE_SECTION_COUNT
+} WorldCacheSection;
+
+typedef struct {
+    unsigned int seed;      // Seed used for all random placement
+    int size;               // Terrain grid resolution
+    float scale;            // Terrain world-space width
+    float height;           // Terrain vertical scale
+    int grassBlades;        // Number of grass blades requested
+    int erosionIterations;  // Terrain erosion iterations (0 = none)
+} WorldCacheKey;
+
+typedef struct {
+    void* data;             // Whole file contents (memory-mapped, or read into memory as a fallback)
+    size_t dataSize;        // Size of the file in bytes
+    int mapped;             // Whether data is a memory mapping (otherwise malloc'd)
+    size_t offsets[WORLD_CACHE_SECTION_COUNT]; // Byte offset of each section inside data
+    size_t sizes[WORLD_CACHE_SECTION_COUNT];   // Byte size of each section
+} WorldCache;
+
+int worldCacheOpen(WorldCache* cache, const char* path, const WorldCacheKey* key);
+const void* worldCacheSection(const WorldCache* cache, WorldCacheSection section, size_t* bytes);
+void worldCacheClose(WorldCache* cache);
+int worldCacheWrite(const char* path, const WorldCacheKey* key, const void* const sections[WORLD_CACHE_SECTION_COUNT], const size_t sizes[WORLD_CACHE_SECTION_COUNT]);